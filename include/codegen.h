@@ -2,21 +2,26 @@
 #include "astnode.h"
 #include "interpreter.h"
 #include <cstddef>
+#include <memory>
 
 struct CompNodeResult {
   std::optional<string> result_loc;
   std::optional<string> accessee_loc; // used by field access
   size_t argc = 0;                    // used by expr_list
   bool final_return = false;          // used by gen_block
-  bool ptr_result = false;
+  bool constant = false; // result is a pooled static object
 };
 
-enum class CompTableEntryType { VAR, CONST, FUNC, BUILTIN };
+enum class CompTableEntryType { VAR, CONST, FUNC, BUILTIN, MODULE };
+
+struct CompSymbolTable;
 
 struct CompTableEntry {
   std::string location;
   CompTableEntryType type;
   std::optional<std::string> metadata;
+  std::optional<size_t> arity;                   // used by FUNC
+  std::shared_ptr<CompSymbolTable> module_table; // used by MODULE
 };
 
 struct CompSymbolTable {
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <variant>
 #include <vector>
@@ -35,7 +38,8 @@ enum class DataType {
   VECTOR,
   DICT,
   MODULE,
-  FUNCTION
+  FUNCTION,
+  BYTES
 };
 
 struct Function {
@@ -79,15 +83,23 @@ struct SymbolTable {
   EvalResult lookup_lvalue(string var);
 };
 
-// Dictionary
-typedef unordered_map<string, std::pair<BoxedValue, shared_ptr<BoxedValue>>>
-    Dict;
+// Dictionary, see below
+class Dict;
+class HeVec;
 
-// HeVec = (He)terogenous (Vec)tor
-typedef vector<shared_ptr<BoxedValue>> HeVec;
+// Mutable binary data, one byte per element. A slice shares the storage of
+// the bytes it was taken from, so a write through either shows in both.
+struct Bytes {
+  shared_ptr<vector<uint8_t>> storage;
+  size_t start = 0;
+  size_t length = 0;
+
+  uint8_t *data() const { return storage->data() + start; }
+};
 
 typedef std::variant<std::monostate, bool, int, double, string,
-                     shared_ptr<HeVec>, shared_ptr<Dict>, Module, Function>
+                     shared_ptr<HeVec>, shared_ptr<Dict>, Module, Function,
+                     shared_ptr<Bytes>>
     RawValue;
 
 class BoxedValue {
@@ -101,6 +113,233 @@ public:
   BoxedValue(DataType _type, RawValue _value) : type{_type}, value{_value} {}
 };
 
+// HeVec = (He)terogenous (Vec)tor. While every element is an int (or every
+// element a float) the elements are stored unboxed in a packed vector; the
+// first element of any other type converts it to boxed storage for good. An
+// empty vector adopts the representation of whatever is put into it first.
+// Elements are values: reading one gives a copy, and writing replaces it.
+class HeVec {
+public:
+  size_t size() const {
+    return std::visit([](auto &elems) { return elems.size(); }, storage);
+  }
+  bool empty() const { return size() == 0; }
+
+  // bounds-checked, like vector::at
+  BoxedValue at(size_t i) const {
+    if (auto ints = std::get_if<vector<int>>(&storage)) {
+      return BoxedValue{DataType::INT, ints->at(i)};
+    }
+    if (auto floats = std::get_if<vector<double>>(&storage)) {
+      return BoxedValue{DataType::FLOAT, floats->at(i)};
+    }
+    return std::get<vector<BoxedValue>>(storage).at(i);
+  }
+  BoxedValue back() const { return at(size() - 1); }
+
+  void set(size_t i, const BoxedValue &value) {
+    if (i >= size()) {
+      throw std::out_of_range("Vector index out of bounds.");
+    }
+    fit(value);
+    std::visit([&](auto &elems) { elems[i] = unbox<decltype(elems)>(value); },
+               storage);
+  }
+  void push_back(const BoxedValue &value) {
+    fit(value);
+    std::visit(
+        [&](auto &elems) { elems.push_back(unbox<decltype(elems)>(value)); },
+        storage);
+  }
+  void insert(size_t i, const BoxedValue &value) {
+    fit(value);
+    std::visit(
+        [&](auto &elems) {
+          elems.insert(elems.begin() + i, unbox<decltype(elems)>(value));
+        },
+        storage);
+  }
+  void erase(size_t i) {
+    std::visit([&](auto &elems) { elems.erase(elems.begin() + i); }, storage);
+  }
+  void pop_back() {
+    std::visit([](auto &elems) { elems.pop_back(); }, storage);
+  }
+  void clear() {
+    std::visit([](auto &elems) { elems.clear(); }, storage);
+  }
+  void reserve(size_t capacity) {
+    std::visit([&](auto &elems) { elems.reserve(capacity); }, storage);
+  }
+  void shrink_to_fit() {
+    std::visit([](auto &elems) { elems.shrink_to_fit(); }, storage);
+  }
+
+  // Replaces the contents with count copies of value, packed if it's a number.
+  void assign(size_t count, const BoxedValue &value) {
+    if (value.type == DataType::INT) {
+      storage = vector<int>(count, std::get<int>(value.value));
+    } else if (value.type == DataType::FLOAT) {
+      storage = vector<double>(count, std::get<double>(value.value));
+    } else {
+      storage = vector<BoxedValue>(count, value);
+    }
+  }
+
+  // Stable-sorts the elements in place. less is called with two elements of
+  // whatever type the vector stores them as: int, double or BoxedValue.
+  template <typename Less> void sort(Less less) {
+    std::visit(
+        [&](auto &elems) {
+          std::stable_sort(elems.begin(), elems.end(), less);
+        },
+        storage);
+  }
+
+  // Like sort, but for a less that may change this vector (a program's own
+  // function): a copy of the elements is sorted, then put in place. The caller
+  // checks layout() after each call of less to reject such changes.
+  template <typename Less> void sort_copy(Less less) {
+    auto sorted = storage;
+    std::visit(
+        [&](auto &elems) {
+          std::stable_sort(elems.begin(), elems.end(), less);
+        },
+        sorted);
+    storage = std::move(sorted);
+  }
+
+  // What adding, removing or converting elements changes: the representation,
+  // the size and the buffer.
+  std::tuple<size_t, size_t, size_t, const void *> layout() const {
+    return std::visit(
+        [&](auto &elems) {
+          return std::tuple<size_t, size_t, size_t, const void *>{
+              storage.index(), elems.size(), elems.capacity(), elems.data()};
+        },
+        storage);
+  }
+
+  // An element as stored, as a value.
+  static BoxedValue box(int elem) { return BoxedValue{DataType::INT, elem}; }
+  static BoxedValue box(double elem) {
+    return BoxedValue{DataType::FLOAT, elem};
+  }
+  static const BoxedValue &box(const BoxedValue &elem) { return elem; }
+
+  // The packed elements, or nullptr if the vector isn't packed that way.
+  const vector<int> *ints() const {
+    return std::get_if<vector<int>>(&storage);
+  }
+  const vector<double> *floats() const {
+    return std::get_if<vector<double>>(&storage);
+  }
+
+private:
+  // the element type of Elems (a reference to one of the storage vectors)
+  template <typename Elems, typename T = std::decay_t<Elems>::value_type>
+  static T unbox(const BoxedValue &value) {
+    if constexpr (std::is_same_v<T, BoxedValue>) {
+      return value;
+    } else {
+      return std::get<T>(value.value);
+    }
+  }
+
+  // Switches to a representation that can hold value.
+  void fit(const BoxedValue &value) {
+    if (std::holds_alternative<vector<BoxedValue>>(storage) ||
+        (value.type == DataType::INT &&
+         std::holds_alternative<vector<int>>(storage)) ||
+        (value.type == DataType::FLOAT &&
+         std::holds_alternative<vector<double>>(storage))) {
+      return;
+    }
+    if (empty() && value.type == DataType::INT) {
+      storage = vector<int>{};
+    } else if (empty() && value.type == DataType::FLOAT) {
+      storage = vector<double>{};
+    } else {
+      vector<BoxedValue> boxed;
+      boxed.reserve(size() + 1);
+      for (size_t i = 0; i < size(); ++i) {
+        boxed.push_back(at(i));
+      }
+      storage = std::move(boxed);
+    }
+  }
+
+  std::variant<vector<int>, vector<double>, vector<BoxedValue>> storage;
+};
+
+// Dictionary keyed by getDictKey strings. Iterates in insertion order, like
+// the compiled runtime's dicts, so both backends print dicts the same way.
+// Erasing a key only drops its position and leaves the entry behind as a
+// tombstone; tombstones are squeezed out before the next iteration, or once
+// they outnumber the live entries.
+class Dict {
+public:
+  typedef std::pair<BoxedValue, shared_ptr<BoxedValue>> KeyValue;
+  typedef vector<std::pair<string, KeyValue>> Entries;
+
+  KeyValue &operator[](const string &key) {
+    auto [it, inserted] = positions.try_emplace(key, entries.size());
+    if (inserted) {
+      entries.emplace_back(key, KeyValue{});
+    }
+    return entries[it->second].second;
+  }
+  KeyValue &at(const string &key) { return entries[positions.at(key)].second; }
+  bool contains(const string &key) const { return positions.contains(key); }
+  size_t size() const { return positions.size(); }
+
+  bool erase(const string &key) {
+    auto it = positions.find(key);
+    if (it == positions.end()) {
+      return false;
+    }
+    entries[it->second].second = KeyValue{};
+    positions.erase(it);
+    if (entries.size() > 2 * positions.size()) {
+      compact();
+    }
+    return true;
+  }
+  void clear() {
+    positions.clear();
+    entries.clear();
+  }
+
+  Entries::iterator begin() {
+    compact();
+    return entries.begin();
+  }
+  Entries::iterator end() { return entries.end(); }
+
+private:
+  // Drops the entries of erased keys. An entry is live if its key still maps
+  // to its position.
+  void compact() {
+    if (entries.size() == positions.size()) {
+      return;
+    }
+    size_t live = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+      auto it = positions.find(entries[i].first);
+      if (it != positions.end() && it->second == i) {
+        if (live != i) {
+          entries[live] = std::move(entries[i]);
+        }
+        it->second = live++;
+      }
+    }
+    entries.resize(live);
+  }
+
+  unordered_map<string, size_t> positions;
+  Entries entries;
+};
+
 class LValue {
 public:
   virtual void assign(BoxedValue value) { throw NotImplemented(); };
@@ -132,6 +371,18 @@ public:
   BoxedValue currentValue() override;
 };
 
+class BytesIndexLV : public LValue {
+public:
+  shared_ptr<Bytes> bytes;
+  BoxedValue index;
+
+  BytesIndexLV(shared_ptr<Bytes> _bytes, BoxedValue _index)
+      : bytes{_bytes}, index{_index} {}
+
+  void assign(BoxedValue value) override;
+  BoxedValue currentValue() override;
+};
+
 class DictIndexLV : public LValue {
 public:
   shared_ptr<Dict> dict;
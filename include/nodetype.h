@@ -27,12 +27,56 @@ enum class NodeType {
   VAR_LOOKUP,
   EXPR_LIST,
   BUILTIN_PRINT,
+  BUILTIN_WRITE,
+  BUILTIN_FLUSH,
+  BUILTIN_READ_FILE,
+  BUILTIN_LINES,
+  BUILTIN_READ_LINE,
+  BUILTIN_READ_ALL,
+  BUILTIN_READ_CHUNK,
+  BUILTIN_JSON_PARSE,
+  BUILTIN_JSON_DUMP,
+  BUILTIN_READ_INTO,
+  BUILTIN_BYTES,
+  BUILTIN_READ_BYTES,
+  BUILTIN_WRITE_BYTES,
   BUILTIN_VECTOR_LENGTH,
   BUILTIN_VECTOR_APPEND,
+  BUILTIN_VECTOR_RESERVE,
+  BUILTIN_VECTOR_EXTEND,
+  BUILTIN_VECTOR_POP,
+  BUILTIN_VECTOR_INSERT,
+  BUILTIN_VECTOR_REMOVE,
+  BUILTIN_VECTOR_CLEAR,
+  BUILTIN_VECTOR_SHRINK_TO_FIT,
+  BUILTIN_VECTOR_SUM,
+  BUILTIN_VECTOR_MIN,
+  BUILTIN_VECTOR_MAX,
+  BUILTIN_VECTOR_DOT,
+  BUILTIN_VECTOR_COUNT,
+  BUILTIN_VECTOR_FILL,
+  BUILTIN_VECTOR_SORT,
+  BUILTIN_VECTOR_SORT_BY,
   BUILTIN_STRING_LENGTH,
+  BUILTIN_STRING_SUBSTR,
+  BUILTIN_STRING_FIND,
+  BUILTIN_STRING_CONTAINS,
+  BUILTIN_STRING_STARTS_WITH,
+  BUILTIN_STRING_ENDS_WITH,
+  BUILTIN_STRING_SPLIT,
+  BUILTIN_STRING_JOIN,
+  BUILTIN_STRING_REPLACE,
+  BUILTIN_STRING_TRIM,
+  BUILTIN_STRING_NEXT_LINE,
+  BUILTIN_BYTES_LENGTH,
+  BUILTIN_BYTES_SLICE,
+  BUILTIN_BYTES_COPY_FROM,
+  BUILTIN_BYTES_TO_STRING,
   BUILTIN_DICT_LENGTH,
   BUILTIN_DICT_KEYS,
   BUILTIN_DICT_CONTAINS,
+  BUILTIN_DICT_REMOVE,
+  BUILTIN_DICT_CLEAR,
   VEC_LITERAL,
   DICT_LITERAL,
   BOOL_LITERAL,
@@ -88,10 +88,59 @@ BoxedValue apply_unary_operator(TokenType op, BoxedValue rhs);
 string getDictKey(BoxedValue bv);
 bool get_conditional_result(BoxedValue bv);
 
+void init_output();
 void builtin_print(BoxedValue arg);
+void builtin_write(BoxedValue arg);
+void builtin_flush();
+BoxedValue builtin_read_file(BoxedValue path);
+BoxedValue builtin_lines(BoxedValue path);
+BoxedValue builtin_read_line();
+BoxedValue builtin_read_all();
+BoxedValue builtin_read_chunk(BoxedValue count);
+BoxedValue builtin_read_into(BoxedValue buffer);
+BoxedValue builtin_bytes(BoxedValue from);
+BoxedValue builtin_read_bytes(BoxedValue path);
+BoxedValue builtin_write_bytes(BoxedValue path, BoxedValue data);
+BoxedValue builtin_json_parse(BoxedValue text);
+BoxedValue builtin_json_dump(BoxedValue value);
 BoxedValue builtin_vector_length(BoxedValue arg);
 BoxedValue builtin_string_length(BoxedValue arg);
+BoxedValue builtin_string_substr(BoxedValue arg, BoxedValue start,
+                                 BoxedValue count);
+BoxedValue builtin_string_find(BoxedValue arg, BoxedValue needle);
+BoxedValue builtin_string_contains(BoxedValue arg, BoxedValue needle);
+BoxedValue builtin_string_starts_with(BoxedValue arg, BoxedValue prefix);
+BoxedValue builtin_string_ends_with(BoxedValue arg, BoxedValue suffix);
+BoxedValue builtin_string_split(BoxedValue arg, BoxedValue separator);
+BoxedValue builtin_string_join(BoxedValue arg, BoxedValue parts);
+BoxedValue builtin_string_replace(BoxedValue arg, BoxedValue from,
+                                  BoxedValue to);
+BoxedValue builtin_string_trim(BoxedValue arg);
+BoxedValue builtin_string_next_line(BoxedValue arg, BoxedValue start);
+BoxedValue bytes_get(const Bytes &bytes, int index);
+void bytes_set(Bytes &bytes, int index, BoxedValue value);
+BoxedValue builtin_bytes_length(BoxedValue arg);
+BoxedValue builtin_bytes_slice(BoxedValue arg, BoxedValue start,
+                               BoxedValue end);
+void builtin_bytes_copy_from(BoxedValue arg, BoxedValue source, BoxedValue at);
+BoxedValue builtin_bytes_to_string(BoxedValue arg);
 BoxedValue builtin_dict_length(BoxedValue arg);
 BoxedValue builtin_dict_keys(BoxedValue arg);
 BoxedValue builtin_dict_contains(BoxedValue arg, BoxedValue key);
+BoxedValue builtin_dict_remove(BoxedValue arg, BoxedValue key);
+BoxedValue builtin_dict_clear(BoxedValue arg);
 void builtin_vector_append(BoxedValue vec, BoxedValue elem);
+void builtin_vector_reserve(BoxedValue vec, BoxedValue capacity);
+void builtin_vector_extend(BoxedValue vec, BoxedValue other);
+BoxedValue builtin_vector_pop(BoxedValue vec);
+void builtin_vector_insert(BoxedValue vec, BoxedValue index, BoxedValue elem);
+BoxedValue builtin_vector_remove(BoxedValue vec, BoxedValue index);
+void builtin_vector_clear(BoxedValue vec);
+void builtin_vector_shrink_to_fit(BoxedValue vec);
+BoxedValue builtin_vector_sum(BoxedValue vec);
+BoxedValue builtin_vector_min(BoxedValue vec);
+BoxedValue builtin_vector_max(BoxedValue vec);
+BoxedValue builtin_vector_dot(BoxedValue vec, BoxedValue other);
+BoxedValue builtin_vector_count(BoxedValue vec, BoxedValue value);
+void builtin_vector_fill(BoxedValue vec, BoxedValue value, BoxedValue count);
+void builtin_vector_sort(BoxedValue vec);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Small helpers shared by the runtime benchmarks. Each benchmark is a
+ * standalone program linked against the runtime library, see the
+ * RUNTIME_BENCHMARKS option in runtime/CMakeLists.txt.
+ */
+
+static inline uint64_t bench_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline double bench_ms(uint64_t start_ns, uint64_t end_ns) {
+  return (double)(end_ns - start_ns) / 1e6;
+}
+
+// Parse an optional element count from argv[1], falling back to a default.
+static inline size_t bench_arg_size(int argc, char **argv, size_t fallback) {
+  if (argc > 1) {
+    return (size_t)strtoull(argv[1], NULL, 10);
+  }
+  return fallback;
+}
@@ -0,0 +1,109 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * Parses a binary file of n records (2 million by default), each a one-byte
+ * id and a little-endian 32-bit value, the way a program does: loading the
+ * file, then reading it a byte at a time with get_index and putting the
+ * values together with op_mul and op_add.
+ *
+ * Before bytes a program had to hold binary data as a vector of ints, one
+ * per byte: 8 bytes of storage per byte while the vector stays packed.
+ * read_bytes maps the file instead, one byte per byte. Either way reading a
+ * byte gives a preallocated small int.
+ */
+
+static const char *path = "/tmp/l528_bench_records.bin";
+
+#define RECORD_SIZE 5
+
+static size_t write_records(size_t records) {
+  FILE *file = fopen(path, "wb");
+  for (size_t i = 0; i < records; ++i) {
+    uint32_t value = (uint32_t)(i * 2654435761u);
+    uint8_t record[RECORD_SIZE] = {(uint8_t)(i % 251), (uint8_t)value,
+                                   (uint8_t)(value >> 8),
+                                   (uint8_t)(value >> 16),
+                                   (uint8_t)(value >> 24)};
+    fwrite(record, 1, RECORD_SIZE, file);
+  }
+  fclose(file);
+  return records * RECORD_SIZE;
+}
+
+// The file as a vector with an int per byte, as a program would build it.
+static RuntimeObject *load_as_vector() {
+  RuntimeObject *data = builtin_read_bytes(make_string((char *)path));
+  RuntimeObject *vec = make_vector();
+  Bytes *bytes = data->value.v_bytes;
+  for (size_t i = 0; i < bytes->length; ++i) {
+    vec_append(vec, make_int(bytes->data[i]));
+  }
+  return vec;
+}
+
+static RuntimeObject *byte_at(RuntimeObject *data, size_t at) {
+  RuntimeObject index = {.type = T_INT, .value.v_int = (int64_t)at};
+  return get_index(data, &index);
+}
+
+// Sum of the values of the records with an even id.
+static int64_t parse(RuntimeObject *data, size_t length) {
+  RuntimeObject *total = make_int(0);
+  RuntimeObject *base = make_int(256);
+  for (size_t at = 0; at + RECORD_SIZE <= length; at += RECORD_SIZE) {
+    if (byte_at(data, at)->value.v_int % 2 != 0) {
+      continue;
+    }
+    RuntimeObject *value = byte_at(data, at + 4);
+    for (size_t i = 3; i >= 1; --i) {
+      value = op_add(op_mul(value, base), byte_at(data, at + i));
+    }
+    total = op_add(total, value);
+  }
+  return total->value.v_int;
+}
+
+static void report(const char *name, double load_ms, double parse_ms,
+                   size_t storage, size_t length) {
+  printf("%-16s %12.2f %12.2f %14zu %10.1f\n", name, load_ms, parse_ms,
+         storage, (double)storage / (double)length);
+}
+
+int main(int argc, char **argv) {
+  size_t records = bench_arg_size(argc, argv, 2000000);
+  size_t length = write_records(records);
+  printf("%zu records, %zu bytes\n", records, length);
+  printf("%-16s %12s %12s %14s %10s\n", "representation", "load (ms)",
+         "parse (ms)", "storage (B)", "per byte");
+
+  uint64_t start = bench_now_ns();
+  RuntimeObject *vec = load_as_vector();
+  double load_ms = bench_ms(start, bench_now_ns());
+  start = bench_now_ns();
+  int64_t vec_total = parse(vec, length);
+  double parse_ms = bench_ms(start, bench_now_ns());
+  Vector *raw_vec = vec->value.v_vec;
+  size_t element_size =
+      raw_vec->packed == T_INT ? sizeof(int64_t) : sizeof(RuntimeObject);
+  report("vector of ints", load_ms, parse_ms,
+         raw_vec->internal_size * element_size, length);
+
+  start = bench_now_ns();
+  RuntimeObject *bytes = builtin_read_bytes(make_string((char *)path));
+  load_ms = bench_ms(start, bench_now_ns());
+  start = bench_now_ns();
+  int64_t bytes_total = parse(bytes, length);
+  parse_ms = bench_ms(start, bench_now_ns());
+  report("bytes", load_ms, parse_ms, bytes->value.v_bytes->length, length);
+
+  remove(path);
+  return vec_total != bytes_total;
+}
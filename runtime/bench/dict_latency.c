@@ -0,0 +1,103 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "dictionary.h"
+#include "runtime.h"
+
+/*
+ * Fills a dict with int keys and times every single insert, comparing tables
+ * that rebuild their index in one go when they grow against ones that resize
+ * incrementally. Reports throughput and the tail of the insert latency, where
+ * one-shot resizes of a large table show up as long pauses.
+ */
+
+// Latencies are bucketed by power of two, each power split into SUB_BUCKETS
+// linear steps, so a percentile is reported to within 1/SUB_BUCKETS.
+#define SUB_BITS 4
+#define SUB_BUCKETS (1 << SUB_BITS)
+#define BUCKETS (64 * SUB_BUCKETS)
+
+static size_t bucket_of(uint64_t ns) {
+  if (ns < SUB_BUCKETS) {
+    return (size_t)ns;
+  }
+  int power = 63 - __builtin_clzll(ns);
+  uint64_t sub = (ns >> (power - SUB_BITS)) & (SUB_BUCKETS - 1);
+  return (size_t)(power - SUB_BITS + 1) * SUB_BUCKETS + (size_t)sub;
+}
+
+// Largest latency that falls into bucket.
+static uint64_t bucket_limit(size_t bucket) {
+  if (bucket < SUB_BUCKETS) {
+    return bucket;
+  }
+  int power = (int)(bucket / SUB_BUCKETS) + SUB_BITS - 1;
+  uint64_t sub = bucket % SUB_BUCKETS;
+  return ((SUB_BUCKETS + sub + 1) << (power - SUB_BITS)) - 1;
+}
+
+static uint64_t percentile(const uint64_t *histogram, size_t n, double p) {
+  size_t rank = (size_t)((double)n * p);
+  size_t seen = 0;
+  for (size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+    seen += histogram[bucket];
+    if (seen > rank) {
+      return bucket_limit(bucket);
+    }
+  }
+  return 0;
+}
+
+static int64_t key_at(size_t i) {
+  return (int64_t)((uint64_t)i * 0x9E3779B97F4A7C15ull);
+}
+
+static void run(const char *name, size_t n, size_t incremental_min,
+                RuntimeObject *value) {
+  dict_incremental_resize_min = incremental_min;
+  uint64_t *histogram = calloc(BUCKETS, sizeof(uint64_t));
+  uint64_t max_ns = 0;
+  Dict dict;
+  dict_init(&dict, 0);
+  RuntimeObject key = {.type = T_INT};
+
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    key.value.v_int = key_at(i);
+    uint64_t before = bench_now_ns();
+    dict_set(&dict, &key, value);
+    uint64_t ns = bench_now_ns() - before;
+    histogram[bucket_of(ns)]++;
+    if (ns > max_ns) {
+      max_ns = ns;
+    }
+  }
+  double total_ms = bench_ms(start, bench_now_ns());
+
+  printf("%-12s %10zu %10.0f %10.1f %10.1f %10.1f %10.1f\n", name, n,
+         total_ms, percentile(histogram, n, 0.5) / 1e3,
+         percentile(histogram, n, 0.99) / 1e3,
+         percentile(histogram, n, 0.999) / 1e3, max_ns / 1e3);
+
+  free(dict.ctrl);
+  free(dict.index);
+  free(dict.old_ctrl);
+  free(dict.old_index);
+  free(dict.entries);
+  free(histogram);
+}
+
+int main(int argc, char **argv) {
+  size_t n = bench_arg_size(argc, argv, 50000000);
+  RuntimeObject *value = make_int(1);
+
+  printf("%-12s %10s %10s %10s %10s %10s %10s\n", "resize", "entries",
+         "total (ms)", "p50 (us)", "p99 (us)", "p99.9 (us)", "max (us)");
+  run("one-shot", n, SIZE_MAX, value);
+  run("incremental", n, DICT_INCREMENTAL_RESIZE_MIN, value);
+  return 0;
+}
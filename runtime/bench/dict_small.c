@@ -0,0 +1,92 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "dictionary.h"
+#include "runtime.h"
+
+/*
+ * Builds many record-like dicts of a few string keys each, and compares the
+ * small representation (no index, linear search) against the same dicts
+ * forced into an indexed table by sizing them past DICT_SMALL_SIZE up front.
+ * Measures memory per dict, build time and lookup time per key.
+ */
+
+static const char *field_names[] = {"id",   "name",  "email", "age",
+                                    "city", "score", "tags",  "active"};
+
+typedef struct {
+  double bytes_per_dict;
+  double build_ns;
+  double lookup_ns;
+} Result;
+
+static size_t dict_bytes(Dict *dict) {
+  size_t entries = (dict->size + dict->growth_left) * sizeof(DictEntry);
+  return sizeof(Dict) + dict->capacity * (1 + sizeof(uint32_t)) + entries;
+}
+
+static Result run(size_t count, size_t fields, size_t initial_size,
+                  RuntimeObject *keys, RuntimeObject *value) {
+  Result result;
+  Dict *dicts = malloc(count * sizeof(Dict));
+
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < count; ++i) {
+    dict_init(&dicts[i], initial_size);
+    for (size_t f = 0; f < fields; ++f) {
+      dict_set(&dicts[i], &keys[f], value);
+    }
+  }
+  result.build_ns = (double)(bench_now_ns() - start) / count;
+
+  size_t bytes = 0;
+  for (size_t i = 0; i < count; ++i) {
+    bytes += dict_bytes(&dicts[i]);
+  }
+  result.bytes_per_dict = (double)bytes / count;
+
+  volatile size_t found = 0;
+  start = bench_now_ns();
+  for (size_t i = 0; i < count; ++i) {
+    for (size_t f = 0; f < fields; ++f) {
+      found += dict_get(&dicts[i], &keys[(f * 5 + i) % fields]) != NULL;
+    }
+  }
+  result.lookup_ns = (double)(bench_now_ns() - start) / (count * fields);
+
+  for (size_t i = 0; i < count; ++i) {
+    free(dicts[i].ctrl);
+    free(dicts[i].index);
+    free(dicts[i].entries);
+  }
+  free(dicts);
+  return result;
+}
+
+static void print_result(const char *name, size_t fields, Result r) {
+  printf("%-8s %8zu %12.1f %12.1f %12.1f\n", name, fields, r.bytes_per_dict,
+         r.build_ns, r.lookup_ns);
+}
+
+int main(int argc, char **argv) {
+  size_t count = bench_arg_size(argc, argv, 200000);
+  size_t num_fields = sizeof(field_names) / sizeof(field_names[0]);
+  RuntimeObject *keys = malloc(num_fields * sizeof(RuntimeObject));
+  for (size_t f = 0; f < num_fields; ++f) {
+    keys[f] = *make_string((char *)field_names[f]);
+  }
+  RuntimeObject value = {.type = T_NOTHING};
+
+  printf("%-8s %8s %12s %12s %12s\n", "dict", "fields", "B/dict",
+         "build (ns)", "lookup (ns)");
+  for (size_t fields = 2; fields <= num_fields; fields *= 2) {
+    print_result("small", fields, run(count, fields, 0, keys, &value));
+    print_result("indexed", fields,
+                 run(count, fields, DICT_SMALL_SIZE + 1, keys, &value));
+  }
+  return 0;
+}
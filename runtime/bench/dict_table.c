@@ -0,0 +1,222 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "dictionary.h"
+#include "runtime.h"
+
+/*
+ * Compares the dict (a Swiss table index over dense, insertion-ordered
+ * entries) against the linear probing table it replaced, which kept entries
+ * in a single sparse array and grew at 50% load. Measures memory per entry and
+ * insert, hit and miss throughput for int keys.
+ */
+
+typedef struct {
+  DictEntry *entries;
+  size_t capacity;
+  size_t size;
+} LegacyDict;
+
+static bool legacy_keys_equal(RuntimeObject *lhs, RuntimeObject *rhs) {
+  if (lhs->type != rhs->type) {
+    return false;
+  }
+  switch (lhs->type) {
+  case T_BOOL:
+    return lhs->value.v_bool == rhs->value.v_bool;
+  case T_INT:
+    return lhs->value.v_int == rhs->value.v_int;
+  case T_FLOAT:
+    return memcmp(&lhs->value.v_float, &rhs->value.v_float,
+                  sizeof(double)) == 0;
+  case T_STRING:
+    return lhs->value.v_str->length == rhs->value.v_str->length &&
+           memcmp(lhs->value.v_str->contents, rhs->value.v_str->contents,
+                  lhs->value.v_str->length) == 0;
+  default:
+    return false;
+  }
+}
+
+static DictEntry *legacy_find_slot(DictEntry *entries, size_t capacity,
+                                   RuntimeObject *key, uint64_t hash) {
+  size_t index = (size_t)(hash & (uint64_t)(capacity - 1));
+  while (entries[index].value != NULL) {
+    if (entries[index].hash == hash &&
+        legacy_keys_equal(key, &entries[index].key)) {
+      return &entries[index];
+    }
+    index = (index + 1) & (capacity - 1);
+  }
+  return &entries[index];
+}
+
+static RuntimeObject *legacy_get(LegacyDict *dict, RuntimeObject *key) {
+  DictEntry *entry = legacy_find_slot(dict->entries, dict->capacity, key,
+                                      dict_hash_key(key));
+  return entry->value;
+}
+
+static void legacy_expand(LegacyDict *table) {
+  size_t new_capacity = table->capacity * 2;
+  DictEntry *new_entries = calloc(new_capacity, sizeof(DictEntry));
+  for (size_t i = 0; i < table->capacity; i++) {
+    DictEntry *entry = &(table->entries[i]);
+    if (entry->value != NULL) {
+      size_t index = (size_t)(entry->hash & (uint64_t)(new_capacity - 1));
+      while (new_entries[index].value != NULL) {
+        index = (index + 1) & (new_capacity - 1);
+      }
+      new_entries[index] = *entry;
+    }
+  }
+  free(table->entries);
+  table->entries = new_entries;
+  table->capacity = new_capacity;
+}
+
+static void legacy_set(LegacyDict *dict, RuntimeObject *key,
+                       RuntimeObject *value) {
+  uint64_t hash = dict_hash_key(key);
+  DictEntry *entry =
+      legacy_find_slot(dict->entries, dict->capacity, key, hash);
+  if (entry->value != NULL) {
+    entry->value = value;
+    return;
+  }
+  if (dict->size >= dict->capacity / 2) {
+    legacy_expand(dict);
+    entry = legacy_find_slot(dict->entries, dict->capacity, key, hash);
+  }
+  entry->hash = hash;
+  entry->key = *key;
+  entry->value = value;
+  dict->size++;
+}
+
+// Keys are a bijective scramble of 0..n-1, so they are distinct but not
+// sequential; keys from n upwards are misses.
+static int64_t key_at(size_t i) {
+  return (int64_t)((uint64_t)i * 0x9E3779B97F4A7C15ull);
+}
+
+typedef struct {
+  double bytes_per_entry;
+  double insert_ns;
+  double hit_ns;
+  double miss_ns;
+} Result;
+
+static Result run_legacy(size_t n, int passes, RuntimeObject *value) {
+  Result result;
+  LegacyDict dict = {calloc(DICT_INITIAL_SIZE, sizeof(DictEntry)),
+                     DICT_INITIAL_SIZE, 0};
+  RuntimeObject key = {.type = T_INT};
+
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    key.value.v_int = key_at(i);
+    legacy_set(&dict, &key, value);
+  }
+  result.insert_ns = (double)(bench_now_ns() - start) / n;
+  result.bytes_per_entry = (double)(dict.capacity * sizeof(DictEntry)) / n;
+
+  volatile size_t found = 0;
+  start = bench_now_ns();
+  for (int p = 0; p < passes; ++p) {
+    for (size_t i = 0; i < n; ++i) {
+      key.value.v_int = key_at((i * 7919) % n);
+      found += legacy_get(&dict, &key) != NULL;
+    }
+  }
+  result.hit_ns = (double)(bench_now_ns() - start) / ((double)n * passes);
+
+  start = bench_now_ns();
+  for (int p = 0; p < passes; ++p) {
+    for (size_t i = 0; i < n; ++i) {
+      key.value.v_int = key_at(n + i);
+      found += legacy_get(&dict, &key) != NULL;
+    }
+  }
+  result.miss_ns = (double)(bench_now_ns() - start) / ((double)n * passes);
+
+  free(dict.entries);
+  return result;
+}
+
+static Result run_current(size_t n, int passes, RuntimeObject *value) {
+  Result result;
+  Dict dict;
+  dict_init(&dict, 0);
+  RuntimeObject key = {.type = T_INT};
+
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    key.value.v_int = key_at(i);
+    dict_set(&dict, &key, value);
+  }
+  result.insert_ns = (double)(bench_now_ns() - start) / n;
+  // control byte and position per index slot, plus the dense entries
+  size_t entries_capacity = dict.capacity - dict.capacity / 8;
+  result.bytes_per_entry =
+      (double)(dict.capacity * (1 + sizeof(uint32_t)) +
+               entries_capacity * sizeof(DictEntry)) /
+      n;
+
+  volatile size_t found = 0;
+  start = bench_now_ns();
+  for (int p = 0; p < passes; ++p) {
+    for (size_t i = 0; i < n; ++i) {
+      key.value.v_int = key_at((i * 7919) % n);
+      found += dict_get(&dict, &key) != NULL;
+    }
+  }
+  result.hit_ns = (double)(bench_now_ns() - start) / ((double)n * passes);
+
+  start = bench_now_ns();
+  for (int p = 0; p < passes; ++p) {
+    for (size_t i = 0; i < n; ++i) {
+      key.value.v_int = key_at(n + i);
+      found += dict_get(&dict, &key) != NULL;
+    }
+  }
+  result.miss_ns = (double)(bench_now_ns() - start) / ((double)n * passes);
+
+  free(dict.ctrl);
+  free(dict.index);
+  free(dict.old_ctrl);
+  free(dict.old_index);
+  free(dict.entries);
+  return result;
+}
+
+static void print_result(const char *name, size_t n, Result r) {
+  printf("%-8s %10zu %12.1f %12.1f %12.1f %12.1f\n", name, n,
+         r.bytes_per_entry, r.insert_ns, r.hit_ns, r.miss_ns);
+}
+
+int main(int argc, char **argv) {
+  size_t sizes[] = {1000, 1000000, 10000000};
+  size_t num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+  if (argc > 1) {
+    sizes[0] = bench_arg_size(argc, argv, 0);
+    num_sizes = 1;
+  }
+
+  RuntimeObject value = {.type = T_NOTHING};
+  printf("%-8s %10s %12s %12s %12s %12s\n", "table", "entries", "B/entry",
+         "insert (ns)", "hit (ns)", "miss (ns)");
+  for (size_t i = 0; i < num_sizes; ++i) {
+    size_t n = sizes[i];
+    // repeat lookups on small tables so they run long enough to time
+    int passes = n >= 1000000 ? 1 : (int)(1000000 / n);
+    print_result("legacy", n, run_legacy(n, passes, &value));
+    print_result("compact", n, run_current(n, passes, &value));
+  }
+  return 0;
+}
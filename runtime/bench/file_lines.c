@@ -0,0 +1,100 @@
+#define _GNU_SOURCE // getline
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * Reads a log file of about n MB (256 by default) a line at a time: through
+ * read_file and next_line, which only look at the mapped file, and through
+ * lines(), which also builds the vector of all the lines. For scale, the same
+ * file is read with plain read() into a buffer, which is as fast as reading
+ * it can be, and with getline(), which copies every line.
+ *
+ * The file is written first, so it's in the page cache: this measures the
+ * cost of going over the bytes, not the disk.
+ */
+
+static const char *path = "/tmp/l528_bench_lines.log";
+
+static size_t write_log(size_t megabytes) {
+  FILE *file = fopen(path, "w");
+  size_t bytes = 0;
+  for (size_t i = 0; bytes < megabytes << 20; ++i) {
+    bytes += (size_t)fprintf(
+        file, "10.0.%zu.%zu - [18/Oct/2026:10:%02zu] GET /api/v1/items/%zu %s\n",
+        i % 250, i % 7, i % 60, i % 100000, i % 13 == 0 ? "503" : "200");
+  }
+  fclose(file);
+  return bytes;
+}
+
+static void report(const char *name, size_t bytes, size_t lines,
+                   uint64_t start) {
+  double ms = bench_ms(start, bench_now_ns());
+  printf("%-24s %10zu %12.2f %10.0f\n", name, lines, ms,
+         (double)bytes / 1e6 / (ms / 1e3));
+}
+
+int main(int argc, char **argv) {
+  size_t megabytes = bench_arg_size(argc, argv, 256);
+  size_t bytes = write_log(megabytes);
+  printf("%zu bytes\n", bytes);
+  printf("%-24s %10s %12s %10s\n", "read", "lines", "time (ms)", "MB/s");
+
+  RuntimeObject *name = make_string((char *)path);
+  uint64_t start = bench_now_ns();
+  RuntimeObject *text = builtin_read_file(name);
+  RuntimeObject pos = {.type = T_INT, .value.v_int = 0};
+  size_t lines = 0, errors = 0;
+  while ((size_t)pos.value.v_int < text->value.v_str->length) {
+    String *line = str_next_line(text, &pos)->value.v_str;
+    errors += line->length > 3 && line->contents[line->length - 3] == '5';
+    pos.value.v_int += (int64_t)line->length + 1;
+    lines++;
+  }
+  report("read_file + next_line", bytes, lines, start);
+
+  start = bench_now_ns();
+  Vector *all = builtin_lines(name)->value.v_vec;
+  for (size_t i = 0; i < all->size; ++i) {
+    String *line = all->contents[i].value.v_str;
+    errors += line->length > 3 && line->contents[line->length - 3] == '5';
+  }
+  report("lines()", bytes, all->size, start);
+
+  start = bench_now_ns();
+  int fd = open(path, O_RDONLY);
+  size_t size = 1 << 20;
+  char *buffer = malloc(size);
+  ssize_t got;
+  lines = 0;
+  while ((got = read(fd, buffer, size)) > 0) {
+    for (char *at = buffer; (at = memchr(at, '\n', buffer + got - at)); ++at) {
+      lines++;
+    }
+  }
+  close(fd);
+  report("read() + memchr", bytes, lines, start);
+
+  start = bench_now_ns();
+  FILE *file = fopen(path, "r");
+  char *line = NULL;
+  size_t capacity = 0;
+  lines = 0;
+  while (getline(&line, &capacity, file) > 0) {
+    lines++;
+  }
+  fclose(file);
+  report("getline()", bytes, lines, start);
+
+  unlink(path);
+  return errors == 0;
+}
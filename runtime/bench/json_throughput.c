@@ -0,0 +1,79 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * json_parse and json_dump on a document of about n MB (100 by default): an
+ * array of event records, each an object with string, int, float, bool and
+ * null fields, a tag array, a nested object and now and then an escaped
+ * string, the kind of thing a program ingests. For scale, the first row is
+ * one memchr pass over the text, about the least any parser can do.
+ */
+
+static const char *kinds[] = {"click", "view", "purchase", "signup",
+                              "logout"};
+static const char *pages[] = {"/", "/index.html", "/api/v1/users",
+                              "/checkout?step=2", "/static/app.js"};
+
+static RuntimeObject *make_document(size_t megabytes) {
+  size_t capacity = (megabytes << 20) + 4096, used = 0;
+  char *text = malloc(capacity);
+  text[used++] = '[';
+  for (size_t i = 0; used < megabytes << 20; ++i) {
+    used += (size_t)snprintf(
+        text + used, capacity - used,
+        "%s{\"id\": %zu, \"kind\": \"%s\", \"page\": \"%s\", "
+        "\"user\": {\"id\": %zu, \"name\": \"user-%zu\", \"admin\": %s}, "
+        "\"duration\": %zu.%03zu, \"score\": %.6g, \"tags\": [\"t%zu\", "
+        "\"t%zu\"], \"counts\": [%zu, %zu, %zu], \"referrer\": %s, "
+        "\"note\": \"%s\"}",
+        i == 0 ? "" : ",\n", i, kinds[i % 5], pages[i % 5], i % 10007,
+        i % 10007, i % 97 == 0 ? "true" : "false", i % 5000, i % 1000,
+        (double)(i % 1013) / 7.0, i % 13, i % 17, i % 10, i % 100, i % 1000,
+        i % 3 == 0 ? "null" : "\"https://example.com/\"",
+        i % 50 == 0 ? "line one\\nline two \\\"quoted\\\" \\u00e9"
+                    : "plain text note");
+  }
+  text[used++] = ']';
+  text[used] = '\0';
+  return make_string_from_raw(make_string_length_raw(text, used));
+}
+
+static void report(const char *name, size_t bytes, uint64_t start) {
+  double ms = bench_ms(start, bench_now_ns());
+  printf("%-20s %12.2f %10.0f\n", name, ms, (double)bytes / 1e6 / (ms / 1e3));
+}
+
+int main(int argc, char **argv) {
+  size_t megabytes = bench_arg_size(argc, argv, 100);
+  RuntimeObject *text = make_document(megabytes);
+  String *str = text->value.v_str;
+  printf("document: %zu bytes\n", str->length);
+  printf("%-20s %12s %10s\n", "operation", "time (ms)", "MB/s");
+
+  uint64_t start = bench_now_ns();
+  size_t quotes = 0;
+  for (const char *at = str->contents, *end = at + str->length;
+       (at = memchr(at, '"', (size_t)(end - at))) != NULL; ++at) {
+    quotes++;
+  }
+  report("memchr scan", str->length, start);
+
+  start = bench_now_ns();
+  RuntimeObject *doc = builtin_json_parse(text);
+  report("json_parse", str->length, start);
+
+  start = bench_now_ns();
+  RuntimeObject *dumped = builtin_json_dump(doc);
+  report("json_dump", dumped->value.v_str->length, start);
+
+  printf("(%zu records, %zu quotes, %zu bytes dumped)\n",
+         doc->value.v_vec->size, quotes, dumped->value.v_str->length);
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "numfmt.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * Formats n ints and n floats (10M of each by default) with format_int and
+ * format_float, and with the snprintf calls they replace: "%lld", "%.1f",
+ * which was fast but kept a single decimal, and "%.17g", the cheapest way to
+ * get digits that read back exactly out of printf. The last row turns the
+ * numbers into runtime strings through to_string_raw.
+ *
+ * The floats are the kind programs compute: quotients, sums of small steps
+ * and the odd large or tiny value.
+ */
+
+static int64_t sample_int(size_t i) {
+  int64_t magnitude = (int64_t)((i * 2654435761u) % 1000000000u);
+  int64_t scale[] = {1, 1000, 1000000};
+  int64_t value = magnitude / scale[i % 3];
+  return i % 5 == 0 ? -value : value;
+}
+
+static double sample_float(size_t i) {
+  switch (i % 4) {
+  case 0:
+    return (double)i / 7.0;
+  case 1:
+    return (double)(i % 1000) * 0.01;
+  case 2:
+    return 1e20 / (double)(i + 1);
+  default:
+    return -(double)(i % 97) / 1e9;
+  }
+}
+
+typedef size_t (*IntFormat)(char *out, int64_t value);
+typedef size_t (*FloatFormat)(char *out, double value);
+
+static size_t snprintf_lld(char *out, int64_t value) {
+  return (size_t)snprintf(out, 32, "%lld", (long long)value);
+}
+
+static size_t snprintf_1f(char *out, double value) {
+  return (size_t)snprintf(out, 512, "%.1f", value);
+}
+
+static size_t snprintf_17g(char *out, double value) {
+  return (size_t)snprintf(out, 32, "%.17g", value);
+}
+
+static size_t total_bytes;
+
+static double time_ints(IntFormat format, size_t n) {
+  char buffer[32];
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    total_bytes += format(buffer, sample_int(i));
+  }
+  return bench_ms(start, bench_now_ns());
+}
+
+static double time_floats(FloatFormat format, size_t n) {
+  // "%.1f" writes out all the integral digits of 1e20 / 1
+  char buffer[512];
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    total_bytes += format(buffer, sample_float(i));
+  }
+  return bench_ms(start, bench_now_ns());
+}
+
+static void report(const char *name, size_t n, double ms) {
+  printf("%-28s %12.2f %10.1f\n", name, ms, ms * 1e6 / (double)n);
+}
+
+int main(int argc, char **argv) {
+  size_t n = bench_arg_size(argc, argv, 10000000);
+  printf("%zu ints and %zu floats\n", n, n);
+  printf("%-28s %12s %10s\n", "format", "time (ms)", "ns/number");
+
+  report("snprintf %lld", n, time_ints(snprintf_lld, n));
+  report("format_int", n, time_ints(format_int, n));
+  report("snprintf %.1f (rounded)", n, time_floats(snprintf_1f, n));
+  report("snprintf %.17g", n, time_floats(snprintf_17g, n));
+  report("format_float", n, time_floats(format_float, n));
+
+  RuntimeObject number;
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    number = i % 2 == 0 ? (RuntimeObject){.type = T_INT,
+                                          .value.v_int = sample_int(i)}
+                        : (RuntimeObject){.type = T_FLOAT,
+                                          .value.v_float = sample_float(i)};
+    total_bytes += to_string_raw(&number)->length;
+  }
+  report("to_string_raw (mixed)", n, bench_ms(start, bench_now_ns()));
+  return total_bytes == 0;
+}
@@ -0,0 +1,122 @@
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "numfmt.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * Printing through the output buffer (see output.c) against the stdio call
+ * per fragment that print used to make, with numbers formatted the same way
+ * in both: n lines of one int each, n lines of a short string, and a vector
+ * of n floats. The output goes to /dev/null, or to the
+ * file named by the second argument, so that it costs what writing to a pipe
+ * or a file does rather than what a terminal does.
+ */
+
+static void stdio_helper(RuntimeObject *obj);
+
+static void stdio_vector(Vector *vec) {
+  printf("[");
+  for (size_t i = 0; i < vec->size; ++i) {
+    RuntimeObject elem;
+    vec_get(vec, i, &elem);
+    stdio_helper(&elem);
+    if (i != vec->size - 1) {
+      printf(", ");
+    }
+  }
+  printf("]");
+}
+
+static void stdio_helper(RuntimeObject *obj) {
+  char buffer[FORMAT_FLOAT_MAX];
+  switch (obj->type) {
+  case T_INT:
+    fwrite(buffer, 1, format_int(buffer, obj->value.v_int), stdout);
+    return;
+  case T_FLOAT:
+    fwrite(buffer, 1, format_float(buffer, obj->value.v_float), stdout);
+    return;
+  case T_STRING:
+    fwrite(obj->value.v_str->contents, 1, obj->value.v_str->length, stdout);
+    return;
+  case T_VECTOR:
+    stdio_vector(obj->value.v_vec);
+    return;
+  default:
+    return;
+  }
+}
+
+static void stdio_print(RuntimeObject *obj) {
+  stdio_helper(obj);
+  printf("\n");
+}
+
+typedef void (*Print)(RuntimeObject *obj);
+
+typedef struct {
+  double ints, strings, vector;
+} Timings;
+
+static Timings run(Print print, size_t n, RuntimeObject *floats) {
+  Timings timings;
+  RuntimeObject number = {.type = T_INT};
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    number.value.v_int = (int64_t)(i * 7919);
+    print(&number);
+  }
+  timings.ints = bench_ms(start, bench_now_ns());
+
+  RuntimeObject *line = make_string("GET /api/v1/orders 200");
+  start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    print(line);
+  }
+  timings.strings = bench_ms(start, bench_now_ns());
+
+  start = bench_now_ns();
+  print(floats);
+  timings.vector = bench_ms(start, bench_now_ns());
+  return timings;
+}
+
+int main(int argc, char **argv) {
+  size_t n = bench_arg_size(argc, argv, 2000000);
+  const char *sink = argc > 2 ? argv[2] : "/dev/null";
+
+  RuntimeObject *floats = make_vector();
+  for (size_t i = 0; i < n; ++i) {
+    vec_append(floats, make_float((double)i / 8.0));
+  }
+
+  int terminal = dup(STDOUT_FILENO);
+  int out = open(sink, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out < 0) {
+    perror(sink);
+    return 1;
+  }
+  dup2(out, STDOUT_FILENO);
+  Timings before = run(stdio_print, n, floats);
+  fflush(stdout);
+  Timings after = run(builtin_print, n, floats);
+  builtin_flush();
+  dup2(terminal, STDOUT_FILENO);
+
+  printf("%-24s %12s %12s %10s\n", "print", "stdio (ms)", "buffer (ms)",
+         "speedup");
+  printf("%-24s %12.2f %12.2f %9.1fx\n", "int lines", before.ints,
+         after.ints, before.ints / after.ints);
+  printf("%-24s %12.2f %12.2f %9.1fx\n", "string lines", before.strings,
+         after.strings, before.strings / after.strings);
+  printf("%-24s %12.2f %12.2f %9.1fx\n", "vector of floats", before.vector,
+         after.vector, before.vector / after.vector);
+  return 0;
+}
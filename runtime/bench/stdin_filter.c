@@ -0,0 +1,106 @@
+#define _GNU_SOURCE // getline
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * Pipes a file of about n MB (256 by default) through this program, run as a
+ * filter that copies standard input to standard output: a line at a time with
+ * read_line and print, in 64KB pieces with read_chunk and write, and all at
+ * once with read_all. For scale, the same pipeline runs with cat as the
+ * filter, and with a C loop over stdio's getline and fputs.
+ *
+ * Every pipeline starts with `cat file |`, so the file comes in through a
+ * pipe, and ends in /dev/null; `cat file > /dev/null` on its own is the time
+ * of just reading the file. read_line makes a new string for every line,
+ * which getline doesn't, so some of the difference between the two is memory.
+ */
+
+static const char *path = "/tmp/l528_bench_stdin.log";
+
+static size_t write_log(size_t megabytes) {
+  FILE *file = fopen(path, "w");
+  size_t bytes = 0;
+  for (size_t i = 0; bytes < megabytes << 20; ++i) {
+    bytes += (size_t)fprintf(file,
+                             "10.0.%zu.%zu - [18/Oct/2026:10:%02zu] "
+                             "GET /api/v1/items/%zu %s\n",
+                             i % 250, i % 7, i % 60, i % 100000,
+                             i % 13 == 0 ? "503" : "200");
+  }
+  fclose(file);
+  return bytes;
+}
+
+static int filter(const char *mode) {
+  if (strcmp(mode, "lines") == 0) {
+    RuntimeObject *line;
+    while ((line = builtin_read_line())->type != T_NOTHING) {
+      builtin_print(line);
+    }
+  } else if (strcmp(mode, "chunks") == 0) {
+    RuntimeObject *size = make_int(64 * 1024);
+    RuntimeObject *chunk;
+    while ((chunk = builtin_read_chunk(size))->type != T_NOTHING) {
+      builtin_write(chunk);
+    }
+  } else if (strcmp(mode, "all") == 0) {
+    RuntimeObject *all = builtin_read_all();
+    if (all->type != T_NOTHING) {
+      builtin_write(all);
+    }
+  } else if (strcmp(mode, "getline") == 0) {
+    char *line = NULL;
+    size_t capacity = 0;
+    while (getline(&line, &capacity, stdin) != -1) {
+      fputs(line, stdout);
+    }
+  } else {
+    return 1;
+  }
+  return 0;
+}
+
+static void run(const char *name, const char *command, size_t bytes) {
+  uint64_t start = bench_now_ns();
+  if (system(command) != 0) {
+    printf("%-24s failed: %s\n", name, command);
+    return;
+  }
+  double ms = bench_ms(start, bench_now_ns());
+  printf("%-24s %12.2f %10.0f\n", name, ms, (double)bytes / 1e6 / (ms / 1e3));
+}
+
+int main(int argc, char **argv) {
+  if (argc > 2 && strcmp(argv[1], "--filter") == 0) {
+    return filter(argv[2]);
+  }
+
+  size_t megabytes = bench_arg_size(argc, argv, 256);
+  size_t bytes = write_log(megabytes);
+  printf("%zu bytes\n", bytes);
+  printf("%-24s %12s %10s\n", "filter", "time (ms)", "MB/s");
+
+  char command[4096];
+  snprintf(command, sizeof(command), "cat %s > /dev/null", path);
+  run("cat file (no pipe)", command, bytes);
+  snprintf(command, sizeof(command), "cat %s | cat > /dev/null", path);
+  run("cat", command, bytes);
+
+  const char *modes[] = {"getline", "lines", "chunks", "all"};
+  const char *names[] = {"stdio getline/fputs", "read_line/print",
+                         "read_chunk/write", "read_all/write"};
+  for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); ++i) {
+    snprintf(command, sizeof(command), "cat %s | %s --filter %s > /dev/null",
+             path, argv[0], modes[i]);
+    run(names[i], command, bytes);
+  }
+  remove(path);
+  return 0;
+}
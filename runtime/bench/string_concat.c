@@ -0,0 +1,65 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "runtime.h"
+
+/*
+ * Builds a string out of small pieces the way generated code runs
+ * `s = s + piece` in a loop: one op_add per piece. Next to it is the same loop
+ * with the concatenation strings used to have, which copied both sides into a
+ * fresh allocation every time and so is quadratic in the final length. That
+ * one only gets a fraction of the pieces, and the time per piece shows the
+ * difference: flat for op_add, growing with the length for the copy.
+ */
+
+static const char piece[] = "0123456789abcdef";
+#define PIECE_LENGTH (sizeof(piece) - 1)
+
+// The old str_concat_raw: strdupcat of both contents.
+static RuntimeObject *copying_concat(RuntimeObject *lhs, RuntimeObject *rhs) {
+  String *lhs_str = lhs->value.v_str, *rhs_str = rhs->value.v_str;
+  char *contents = malloc(lhs_str->length + rhs_str->length + 1);
+  memcpy(contents, lhs_str->contents, lhs_str->length);
+  memcpy(contents + lhs_str->length, rhs_str->contents, rhs_str->length + 1);
+  return make_string_nocopy(contents);
+}
+
+static void report(const char *name, size_t pieces, RuntimeObject *str,
+                   uint64_t start) {
+  double ms = bench_ms(start, bench_now_ns());
+  printf("%-16s %10zu %12zu %12.2f %12.1f\n", name, pieces,
+         str->value.v_str->length, ms, ms * 1e6 / (double)pieces);
+}
+
+int main(int argc, char **argv) {
+  // 10MB by default
+  size_t pieces = bench_arg_size(argc, argv, 10 * 1000 * 1000 / PIECE_LENGTH);
+  RuntimeObject *small = make_string((char *)piece);
+
+  printf("%-16s %10s %12s %12s %12s\n", "concatenation", "pieces", "bytes",
+         "time (ms)", "ns/piece");
+  for (size_t n = pieces / 64; n <= pieces; n *= 4) {
+    RuntimeObject *str = make_string("");
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < n; ++i) {
+      str = op_add(str, small);
+    }
+    report("op_add", n, str, start);
+  }
+  for (size_t n = pieces / 256; n <= pieces / 32; n *= 2) {
+    RuntimeObject *str = make_string_nocopy(calloc(1, 1));
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < n; ++i) {
+      RuntimeObject *next = copying_concat(str, small);
+      // unlike op_add results, nothing else can point at these contents
+      free(str->value.v_str->contents);
+      str = next;
+    }
+    report("copying", n, str, start);
+  }
+  return 0;
+}
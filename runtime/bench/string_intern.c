@@ -0,0 +1,107 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * What interning buys. Each row does the same work with strings that are
+ * interned (the way a program's literals are) and with equal strings made at
+ * run time, which have to be hashed and compared byte by byte, as every
+ * string was before: dict lookups, comparing strings that differ only at the
+ * end, and indexing a string a character at a time, which used to allocate
+ * every one-character result.
+ */
+
+#define KEYS 1000
+
+static RuntimeObject *volatile sink;
+
+static RuntimeObject *fresh_key(size_t i) {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "customer.account.settings.field-%04zu", i);
+  return make_string(buffer);
+}
+
+static RuntimeObject *interned_key(size_t i) {
+  RuntimeObject *key = fresh_key(i);
+  key->value.v_str = str_intern(key->value.v_str);
+  return key;
+}
+
+int main(int argc, char **argv) {
+  size_t n = bench_arg_size(argc, argv, 2000000);
+
+  RuntimeObject *dict = make_dict();
+  RuntimeObject *interned[KEYS], *fresh[KEYS];
+  for (size_t i = 0; i < KEYS; ++i) {
+    _dict_put(dict, fresh_key(i), make_int((int64_t)i));
+    interned[i] = interned_key(i);
+    fresh[i] = fresh_key(i);
+  }
+
+  printf("%-28s %12s %12s %10s\n", "operation", "fresh (ns)", "interned (ns)",
+         "speedup");
+
+  // a fresh key has its hash computed on first use, like the key strings
+  // programs build, so those are remade every round
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    if (i % KEYS == 0) {
+      for (size_t k = 0; k < KEYS; ++k) {
+        fresh[k]->value.v_str->hash = 0;
+      }
+    }
+    sink = get_index(dict, fresh[i % KEYS]);
+  }
+  double fresh_ns = bench_ms(start, bench_now_ns()) * 1e6 / (double)n;
+  start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    sink = get_index(dict, interned[i % KEYS]);
+  }
+  double interned_ns = bench_ms(start, bench_now_ns()) * 1e6 / (double)n;
+  printf("%-28s %12.1f %12.1f %9.1fx\n", "dict lookup", fresh_ns, interned_ns,
+         fresh_ns / interned_ns);
+
+  // without the result allocation of op_eq, which would dwarf the rest
+  for (size_t k = 0; k < KEYS; ++k) {
+    fresh[k]->value.v_str->hash = 0;
+  }
+  size_t equal = 0;
+  start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    equal += equality_comparison(fresh[i % KEYS], fresh[(i + 1) % KEYS]);
+  }
+  fresh_ns = bench_ms(start, bench_now_ns()) * 1e6 / (double)n;
+  start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    equal +=
+        equality_comparison(interned[i % KEYS], interned[(i + 1) % KEYS]);
+  }
+  interned_ns = bench_ms(start, bench_now_ns()) * 1e6 / (double)n;
+  printf("%-28s %12.1f %12.1f %9.1fx\n", "compare unequal strings",
+         fresh_ns, interned_ns, fresh_ns / interned_ns);
+
+  // indexing: the old get_index made a new string per character
+  RuntimeObject *text = fresh_key(0);
+  size_t length = text->value.v_str->length;
+  RuntimeObject index = {.type = T_INT};
+  start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    char single[2] = {text->value.v_str->contents[i % length], '\0'};
+    sink = make_string(single);
+  }
+  fresh_ns = bench_ms(start, bench_now_ns()) * 1e6 / (double)n;
+  start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    index.value.v_int = (int64_t)(i % length);
+    sink = get_index(text, &index);
+  }
+  interned_ns = bench_ms(start, bench_now_ns()) * 1e6 / (double)n;
+  printf("%-28s %12.1f %12.1f %9.1fx\n", "index a character", fresh_ns,
+         interned_ns, fresh_ns / interned_ns);
+  return equal != 0;
+}
@@ -0,0 +1,143 @@
+#define _GNU_SOURCE // memmem
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * Parses an access log: splits it into lines, each line into fields, and
+ * counts the lines with a 5xx status and the ones mentioning "timeout".
+ *
+ * The string methods do it with split, starts_with and contains on views of
+ * the log. Before them a program had to walk the log a character at a time,
+ * the way generated code runs `c = log[i]; if c == " " ... field = field +
+ * c`: get_index, op_eq and op_add per byte, and that only gets a slice of
+ * the lines. The raw search speed of bytes_find is compared with memmem too.
+ */
+
+static const char *methods[] = {"GET", "POST", "PUT", "DELETE"};
+static const char *paths[] = {"/", "/index.html", "/api/v1/users",
+                              "/api/v1/orders?page=2", "/static/app.js"};
+static const char *statuses[] = {"200", "200", "200", "304", "404", "503"};
+
+static RuntimeObject *make_log(size_t lines) {
+  size_t capacity = lines * 96 + 1, used = 0;
+  char *log = malloc(capacity);
+  for (size_t i = 0; i < lines; ++i) {
+    used += snprintf(log + used, capacity - used,
+                     "10.0.%zu.%zu - [18/Oct/2026:10:%02zu] %s %s %s %zu%s\n",
+                     i % 250, i % 7, i % 60, methods[i % 4], paths[i % 5],
+                     statuses[i % 6], i % 5000,
+                     i % 97 == 0 ? " upstream timeout" : "");
+  }
+  return make_string_from_raw(make_string_length_raw(log, used));
+}
+
+typedef struct {
+  size_t lines, errors, timeouts;
+} LogStats;
+
+static LogStats parse_with_methods(RuntimeObject *log) {
+  LogStats stats = {0, 0, 0};
+  RuntimeObject *newline = make_string("\n");
+  RuntimeObject *space = make_string(" ");
+  RuntimeObject *five = make_string("5");
+  RuntimeObject *timeout = make_string("timeout");
+  Vector *lines = str_split(log, newline)->value.v_vec;
+  for (size_t i = 0; i < lines->size; ++i) {
+    RuntimeObject *line = &lines->contents[i];
+    Vector *fields = str_split(line, space)->value.v_vec;
+    if (fields->size < 6) {
+      continue;
+    }
+    stats.lines++;
+    stats.errors += str_starts_with(&fields->contents[5], five)->value.v_bool;
+    stats.timeouts += str_contains(line, timeout)->value.v_bool;
+  }
+  return stats;
+}
+
+static LogStats parse_by_character(RuntimeObject *log, size_t max_lines) {
+  LogStats stats = {0, 0, 0};
+  RuntimeObject *newline = make_string("\n");
+  RuntimeObject *space = make_string(" ");
+  RuntimeObject index = {.type = T_INT};
+  RuntimeObject *field = make_string("");
+  size_t field_number = 0;
+  for (size_t i = 0; stats.lines < max_lines; ++i) {
+    index.value.v_int = (int64_t)i;
+    RuntimeObject *c = get_index(log, &index);
+    bool end_of_line = get_conditional_result(op_eq(c, newline));
+    if (end_of_line || get_conditional_result(op_eq(c, space))) {
+      if (field_number == 5) {
+        stats.errors += field->value.v_str->contents[0] == '5';
+      }
+      // a program would compare field with "timeout" here
+      stats.timeouts += get_conditional_result(
+          op_eq(field, make_string("timeout")));
+      field = make_string("");
+      field_number++;
+      if (end_of_line) {
+        stats.lines++;
+        field_number = 0;
+      }
+      continue;
+    }
+    field = op_add(field, c);
+  }
+  return stats;
+}
+
+static void report(const char *name, size_t lines, LogStats stats,
+                   uint64_t start) {
+  double ms = bench_ms(start, bench_now_ns());
+  printf("%-22s %10zu %8zu %8zu %12.2f %10.1f\n", name, lines, stats.errors,
+         stats.timeouts, ms, ms * 1e6 / (double)lines);
+}
+
+int main(int argc, char **argv) {
+  size_t lines = bench_arg_size(argc, argv, 200000);
+  RuntimeObject *log = make_log(lines);
+  String *str = log->value.v_str;
+  printf("log: %zu lines, %zu bytes\n", lines, str->length);
+
+  printf("%-22s %10s %8s %8s %12s %10s\n", "parse", "lines", "5xx",
+         "timeout", "time (ms)", "ns/line");
+  uint64_t start = bench_now_ns();
+  LogStats stats = parse_with_methods(log);
+  report("split/starts_with", stats.lines, stats, start);
+
+  start = bench_now_ns();
+  stats = parse_by_character(log, lines / 100);
+  report("character loop", stats.lines, stats, start);
+
+  // searching the whole log for something it doesn't contain. memmem is a
+  // pure function, so each call gets different arguments and its result is
+  // used, or the compiler could make one call of the lot.
+  const char *needle = "[18/Oct/2026:11:";
+  const int passes = 20;
+  size_t found = 0;
+  start = bench_now_ns();
+  for (int p = 0; p < passes; ++p) {
+    found += bytes_find(str->contents + p, str->length - p, needle,
+                        strlen(needle)) != NULL;
+  }
+  double find_ms = bench_ms(start, bench_now_ns()) / passes;
+  start = bench_now_ns();
+  for (int p = 0; p < passes; ++p) {
+    found += memmem(str->contents + p, str->length - p, needle,
+                    strlen(needle)) != NULL;
+  }
+  double memmem_ms = bench_ms(start, bench_now_ns()) / passes;
+  printf("\n%-22s %12s %10s\n", "search", "time (ms)", "GB/s");
+  printf("%-22s %12.2f %10.2f\n", "bytes_find", find_ms,
+         (double)str->length / find_ms / 1e6);
+  printf("%-22s %12.2f %10.2f\n", "memmem", memmem_ms,
+         (double)str->length / memmem_ms / 1e6);
+  return found != 0;
+}
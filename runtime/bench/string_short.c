@@ -0,0 +1,95 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * Short strings, made one allocation each (see make_string_block and
+ * str_append), against the way they were made before: the object, its String
+ * header and the contents each allocated on their own, and every
+ * concatenation that couldn't append in place starting a new StringBuffer.
+ *
+ * The tokenizer splits text into words a character at a time, the way a
+ * program would: `c = text[i]; if c == " " ... else word = word + c`.
+ */
+
+static RuntimeObject *separate_make_string(char *value) {
+  return make_string_from_raw(make_string_nocopy_raw(strdup(value)));
+}
+
+static RuntimeObject *separate_concat(RuntimeObject *lhs, RuntimeObject *rhs) {
+  return make_string_from_raw(str_concat_raw(lhs->value.v_str,
+                                             rhs->value.v_str));
+}
+
+typedef RuntimeObject *(*Concat)(RuntimeObject *lhs, RuntimeObject *rhs);
+
+static size_t tokenize(RuntimeObject *text, Concat concat) {
+  RuntimeObject *space = make_string(" ");
+  RuntimeObject *words = make_vector();
+  RuntimeObject *word = make_string("");
+  RuntimeObject index = {.type = T_INT};
+  size_t length = text->value.v_str->length;
+  for (size_t i = 0; i < length; ++i) {
+    index.value.v_int = (int64_t)i;
+    RuntimeObject *c = get_index(text, &index);
+    if (equality_comparison(c, space)) {
+      vec_append(words, word);
+      word = make_string("");
+    } else {
+      word = concat(word, c);
+    }
+  }
+  return words->value.v_vec->size;
+}
+
+static const char *vocabulary[] = {"the",   "quick",     "brown", "fox",
+                                   "jumps", "over",      "a",     "lazy",
+                                   "dog",   "tokenizer", "of",    "strings"};
+#define VOCABULARY (sizeof(vocabulary) / sizeof(vocabulary[0]))
+
+static RuntimeObject *volatile sink;
+
+int main(int argc, char **argv) {
+  size_t n = bench_arg_size(argc, argv, 2000000);
+
+  printf("%-24s %12s %12s %10s\n", "operation", "before (ms)", "after (ms)",
+         "speedup");
+
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    sink = separate_make_string((char *)vocabulary[i % VOCABULARY]);
+  }
+  double before = bench_ms(start, bench_now_ns());
+  start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    sink = make_string((char *)vocabulary[i % VOCABULARY]);
+  }
+  double after = bench_ms(start, bench_now_ns());
+  printf("%-24s %12.2f %12.2f %9.1fx\n", "make_string", before, after,
+         before / after);
+
+  // about n bytes of text
+  size_t capacity = n + 16, used = 0;
+  char *text = malloc(capacity);
+  for (size_t i = 0; used + 12 < capacity; ++i) {
+    used += sprintf(text + used, "%s ", vocabulary[i * 7 % VOCABULARY]);
+  }
+  RuntimeObject *text_obj = make_string_nocopy(text);
+
+  start = bench_now_ns();
+  size_t words = tokenize(text_obj, separate_concat);
+  before = bench_ms(start, bench_now_ns());
+  start = bench_now_ns();
+  words = tokenize(text_obj, op_add);
+  after = bench_ms(start, bench_now_ns());
+  printf("%-24s %12.2f %12.2f %9.1fx\n", "tokenize", before, after,
+         before / after);
+  printf("(%zu words in %zu bytes)\n", words, used);
+  return 0;
+}
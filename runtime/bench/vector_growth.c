@@ -0,0 +1,83 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "runtime.h"
+
+/*
+ * Times building a vector by repeated appends: with the previous growth
+ * strategy (calloc a buffer twice the size and copy every slot over), with
+ * the current realloc-based growth, and with the capacity reserved up front.
+ * Also reports the slowest single append, which is the largest grow.
+ */
+
+// The previous vec_append, minus copy-on-write handling.
+static RuntimeObject *legacy_append(Vector *vec, RuntimeObject *obj) {
+  size_t new_size = vec->size + 1;
+  if (new_size > vec->internal_size) {
+    size_t new_internal_size = vec->internal_size * 2;
+    RuntimeObject *new_contents =
+        calloc(new_internal_size, sizeof(RuntimeObject));
+    for (size_t i = 0; i < vec->internal_size; i++) {
+      new_contents[i] = vec->contents[i];
+    }
+    free(vec->contents);
+    vec->contents = new_contents;
+    vec->internal_size = new_internal_size;
+  }
+  vec->size = new_size;
+  vec->contents[vec->size - 1] = *obj;
+  return make_nothing();
+}
+
+typedef struct {
+  double total_ms;
+  double max_append_us;
+} Result;
+
+static Result run(size_t n, int mode) {
+  RuntimeObject *vec_obj = make_vector();
+  RuntimeObject elem = {.type = T_INT};
+  if (mode == 2) {
+    RuntimeObject capacity = {.type = T_INT, .value.v_int = (int64_t)n};
+    vec_reserve(vec_obj, &capacity);
+  }
+
+  uint64_t max_ns = 0;
+  uint64_t start = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    elem.value.v_int = (int64_t)i;
+    uint64_t before = bench_now_ns();
+    if (mode == 0) {
+      legacy_append(vec_obj->value.v_vec, &elem);
+    } else {
+      vec_append(vec_obj, &elem);
+    }
+    uint64_t ns = bench_now_ns() - before;
+    if (ns > max_ns) {
+      max_ns = ns;
+    }
+  }
+  Result result = {bench_ms(start, bench_now_ns()), max_ns / 1e3};
+
+  free(vec_obj->value.v_vec->contents);
+  free(vec_obj->value.v_vec);
+  free(vec_obj);
+  return result;
+}
+
+int main(int argc, char **argv) {
+  size_t n = bench_arg_size(argc, argv, 50000000);
+  const char *names[] = {"copy", "realloc", "reserved"};
+
+  printf("elements: %zu\n", n);
+  printf("%-10s %12s %16s\n", "growth", "total (ms)", "max append (us)");
+  for (int mode = 0; mode < 3; ++mode) {
+    Result r = run(n, mode);
+    printf("%-10s %12.1f %16.1f\n", names[mode], r.total_ms, r.max_append_us);
+  }
+  return 0;
+}
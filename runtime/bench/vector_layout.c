@@ -0,0 +1,125 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "runtime.h"
+
+/*
+ * Compares the memory footprint and scan speed of a vector of ints stored as
+ * boxed RuntimeObjects, as packed int64_t (what the runtime does for an
+ * all-int vector), and in the previous object layout, where Function was
+ * stored by value in the union and every object took 24 bytes.
+ */
+
+typedef struct {
+  RuntimeObject *(*fn_ptr)(size_t argc, RuntimeObject *argv[]);
+  char *signature;
+} LegacyFunction;
+
+typedef struct {
+  enum DataType type;
+  union {
+    bool v_bool;
+    int64_t v_int;
+    double v_float;
+    String *v_str;
+    Vector *v_vec;
+    Dict *v_dict;
+    LegacyFunction v_func;
+    Module *v_mod;
+  } value;
+} LegacyRuntimeObject;
+
+static int64_t scan_current(Vector *vec) {
+  int64_t sum = 0;
+  for (size_t i = 0; i < vec->size; ++i) {
+    RuntimeObject *elem = &vec->contents[i];
+    if (elem->type == T_INT) {
+      sum += elem->value.v_int;
+    }
+  }
+  return sum;
+}
+
+static int64_t scan_packed(Vector *vec) {
+  int64_t sum = 0;
+  for (size_t i = 0; i < vec->size; ++i) {
+    sum += vec->ints[i];
+  }
+  return sum;
+}
+
+static int64_t scan_legacy(LegacyRuntimeObject *contents, size_t size) {
+  int64_t sum = 0;
+  for (size_t i = 0; i < size; ++i) {
+    LegacyRuntimeObject *elem = &contents[i];
+    if (elem->type == T_INT) {
+      sum += elem->value.v_int;
+    }
+  }
+  return sum;
+}
+
+int main(int argc, char **argv) {
+  size_t n = bench_arg_size(argc, argv, 10000000);
+  const int passes = 10;
+
+  // packed, built through the runtime itself
+  RuntimeObject *packed_obj = make_vector();
+  RuntimeObject elem = {.type = T_INT};
+  for (size_t i = 0; i < n; ++i) {
+    elem.value.v_int = (int64_t)i;
+    vec_append(packed_obj, &elem);
+  }
+  Vector *packed = packed_obj->value.v_vec;
+
+  // boxed, the way generated code fills a non-constant vector literal
+  Vector *vec = make_vector_known_size(n)->value.v_vec;
+  for (size_t i = 0; i < n; ++i) {
+    vec->contents[i].type = T_INT;
+    vec->contents[i].value.v_int = (int64_t)i;
+  }
+
+  // previous layout, filled directly
+  LegacyRuntimeObject *legacy = calloc(n, sizeof(LegacyRuntimeObject));
+  for (size_t i = 0; i < n; ++i) {
+    legacy[i].type = T_INT;
+    legacy[i].value.v_int = (int64_t)i;
+  }
+
+  volatile int64_t sink = 0;
+  uint64_t start = bench_now_ns();
+  for (int p = 0; p < passes; ++p) {
+    sink += scan_legacy(legacy, n);
+  }
+  double legacy_ms = bench_ms(start, bench_now_ns()) / passes;
+
+  start = bench_now_ns();
+  for (int p = 0; p < passes; ++p) {
+    sink += scan_current(vec);
+  }
+  double current_ms = bench_ms(start, bench_now_ns()) / passes;
+
+  start = bench_now_ns();
+  for (int p = 0; p < passes; ++p) {
+    sink += scan_packed(packed);
+  }
+  double packed_ms = bench_ms(start, bench_now_ns()) / passes;
+
+  printf("elements: %zu\n", n);
+  printf("%-8s %12s %14s %12s\n", "layout", "object (B)", "elements (MB)",
+         "scan (ms)");
+  printf("%-8s %12zu %14.1f %12.2f\n", "legacy", sizeof(LegacyRuntimeObject),
+         (double)(n * sizeof(LegacyRuntimeObject)) / 1e6, legacy_ms);
+  printf("%-8s %12zu %14.1f %12.2f\n", "boxed", sizeof(RuntimeObject),
+         (double)(n * sizeof(RuntimeObject)) / 1e6, current_ms);
+  printf("%-8s %12zu %14.1f %12.2f\n", "packed", sizeof(int64_t),
+         (double)(n * sizeof(int64_t)) / 1e6, packed_ms);
+
+  free(legacy);
+  (void)sink;
+  return 0;
+}
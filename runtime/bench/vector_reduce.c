@@ -0,0 +1,113 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "runtime.h"
+
+/*
+ * Compares the numeric vector methods against the loop a program had to
+ * write before they existed: get_index and op_add (or op_lt, op_eq, op_mul)
+ * per element, the way generated code evaluates `s = s + v[i]`. An element
+ * used as an operand is boxed into a temporary (get_index_into), but every op
+ * allocates its result, and nothing is freed, which is what keeps the default
+ * size down.
+ */
+
+static RuntimeObject *loop_sum(RuntimeObject *vec) {
+  RuntimeObject *sum = make_int(0);
+  RuntimeObject index = {.type = T_INT};
+  RuntimeObject elem;
+  for (size_t i = 0; i < vec->value.v_vec->size; ++i) {
+    index.value.v_int = (int64_t)i;
+    sum = op_add(sum, get_index_into(vec, &index, &elem));
+  }
+  return sum;
+}
+
+static RuntimeObject *loop_min(RuntimeObject *vec) {
+  RuntimeObject index = {.type = T_INT, .value.v_int = 0};
+  RuntimeObject *min = get_index(vec, &index);
+  for (size_t i = 1; i < vec->value.v_vec->size; ++i) {
+    index.value.v_int = (int64_t)i;
+    RuntimeObject *elem = get_index(vec, &index);
+    if (op_lt(elem, min)->value.v_bool) {
+      min = elem;
+    }
+  }
+  return min;
+}
+
+static RuntimeObject *loop_dot(RuntimeObject *lhs, RuntimeObject *rhs) {
+  RuntimeObject *dot = make_int(0);
+  RuntimeObject index = {.type = T_INT};
+  RuntimeObject lhs_elem, rhs_elem;
+  for (size_t i = 0; i < lhs->value.v_vec->size; ++i) {
+    index.value.v_int = (int64_t)i;
+    dot = op_add(dot, op_mul(get_index_into(lhs, &index, &lhs_elem),
+                             get_index_into(rhs, &index, &rhs_elem)));
+  }
+  return dot;
+}
+
+static RuntimeObject *loop_count(RuntimeObject *vec, RuntimeObject *value) {
+  int64_t count = 0;
+  RuntimeObject index = {.type = T_INT};
+  RuntimeObject elem;
+  for (size_t i = 0; i < vec->value.v_vec->size; ++i) {
+    index.value.v_int = (int64_t)i;
+    count += op_eq(get_index_into(vec, &index, &elem), value)->value.v_bool;
+  }
+  return make_int(count);
+}
+
+static RuntimeObject *volatile sink;
+
+// Stores the average time of `passes` runs of expr, in milliseconds, in ms.
+#define TIME_MS(ms, passes, expr)                                              \
+  do {                                                                         \
+    uint64_t start = bench_now_ns();                                           \
+    for (int p = 0; p < (passes); ++p) {                                       \
+      sink = (expr);                                                           \
+    }                                                                          \
+    ms = bench_ms(start, bench_now_ns()) / (passes);                           \
+  } while (0)
+
+// Times a hand-written loop against the method doing the same thing.
+#define COMPARE(name, loop_expr, method_expr)                                  \
+  do {                                                                         \
+    double loop_ms, method_ms;                                                 \
+    TIME_MS(loop_ms, passes, loop_expr);                                       \
+    TIME_MS(method_ms, passes, method_expr);                                   \
+    printf("%-12s %12.2f %12.2f %9.1fx\n", name, loop_ms, method_ms,           \
+           loop_ms / method_ms);                                               \
+  } while (0)
+
+int main(int argc, char **argv) {
+  size_t n = bench_arg_size(argc, argv, 1000000);
+  const int passes = 3;
+
+  RuntimeObject *ints = make_vector();
+  RuntimeObject *floats = make_vector();
+  RuntimeObject elem;
+  for (size_t i = 0; i < n; ++i) {
+    elem = (RuntimeObject){.type = T_INT, .value.v_int = (int64_t)(i % 1000)};
+    vec_append(ints, &elem);
+    elem = (RuntimeObject){.type = T_FLOAT, .value.v_float = (double)i / 3};
+    vec_append(floats, &elem);
+  }
+  RuntimeObject needle = {.type = T_INT, .value.v_int = 7};
+
+  printf("elements: %zu\n", n);
+  printf("%-12s %12s %12s %10s\n", "operation", "loop (ms)", "method (ms)",
+         "speedup");
+  COMPARE("int sum", loop_sum(ints), vec_sum(ints));
+  COMPARE("float sum", loop_sum(floats), vec_sum(floats));
+  COMPARE("int min", loop_min(ints), vec_min(ints));
+  COMPARE("float min", loop_min(floats), vec_min(floats));
+  COMPARE("float dot", loop_dot(floats, floats), vec_dot(floats, floats));
+  COMPARE("int count", loop_count(ints, &needle), vec_count(ints, &needle));
+  (void)sink;
+  return 0;
+}
@@ -0,0 +1,146 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "datatype.h"
+#include "runtime.h"
+
+/*
+ * Compares v.sort() and v.sort_by() with the insertion sort programs had to
+ * write before they existed, run the way generated code runs it: get_index,
+ * set_index and op_lt per step. That one is quadratic, so it only gets a
+ * small vector; the native sorts are also timed on a large one per element
+ * type, next to qsort as a reference point.
+ */
+
+static RuntimeObject *index_obj(size_t i) { return make_int((int64_t)i); }
+
+// while j > 0 & v[j] < v[j - 1] ... swap ...
+static void lang_insertion_sort(RuntimeObject *vec) {
+  size_t n = vec->value.v_vec->size;
+  for (size_t i = 1; i < n; ++i) {
+    for (size_t j = i; j > 0; --j) {
+      RuntimeObject *a = get_index(vec, index_obj(j));
+      RuntimeObject *b = get_index(vec, index_obj(j - 1));
+      if (!get_conditional_result(op_lt(a, b))) {
+        break;
+      }
+      RuntimeObject tmp = *a;
+      set_index(vec, index_obj(j), b);
+      set_index(vec, index_obj(j - 1), &tmp);
+    }
+  }
+}
+
+// What a compiled `function less(a, b) return a < b; ..` boils down to.
+static RuntimeObject *less_fn(size_t argc, RuntimeObject *argv[]) {
+  return op_lt(argv[0], argv[1]);
+}
+
+static int compare_int64(const void *lhs, const void *rhs) {
+  int64_t a = *(const int64_t *)lhs, b = *(const int64_t *)rhs;
+  return (a > b) - (a < b);
+}
+
+static uint64_t rng_state = 88172645463325252ull;
+
+static uint64_t next_random() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return rng_state;
+}
+
+static RuntimeObject *random_ints(size_t n) {
+  RuntimeObject *vec = make_vector();
+  RuntimeObject elem = {.type = T_INT};
+  for (size_t i = 0; i < n; ++i) {
+    elem.value.v_int = (int64_t)next_random();
+    vec_append(vec, &elem);
+  }
+  return vec;
+}
+
+static RuntimeObject *random_floats(size_t n) {
+  RuntimeObject *vec = make_vector();
+  RuntimeObject elem = {.type = T_FLOAT};
+  for (size_t i = 0; i < n; ++i) {
+    elem.value.v_float = (double)(int64_t)next_random() / 1e9;
+    vec_append(vec, &elem);
+  }
+  return vec;
+}
+
+static RuntimeObject *random_strings(size_t n) {
+  RuntimeObject *vec = make_vector();
+  char buffer[32];
+  for (size_t i = 0; i < n; ++i) {
+    snprintf(buffer, sizeof(buffer), "key-%llu",
+             (unsigned long long)(next_random() % 100000000));
+    vec_append(vec, make_string(buffer));
+  }
+  return vec;
+}
+
+int main(int argc, char **argv) {
+  size_t small = bench_arg_size(argc, argv, 5000);
+  size_t large = argc > 2 ? (size_t)strtoull(argv[2], NULL, 10) : 1000000;
+  RuntimeObject *less = make_function(less_fn);
+
+  printf("%-26s %10s %12s\n", "sort", "elements", "time (ms)");
+
+  RuntimeObject *vec = random_ints(small);
+  uint64_t start = bench_now_ns();
+  lang_insertion_sort(vec);
+  printf("%-26s %10zu %12.2f\n", "insertion sort (program)", small,
+         bench_ms(start, bench_now_ns()));
+
+  vec = random_ints(small);
+  start = bench_now_ns();
+  vec_sort(vec);
+  printf("%-26s %10zu %12.2f\n", "sort() ints", small,
+         bench_ms(start, bench_now_ns()));
+
+  vec = random_ints(small);
+  start = bench_now_ns();
+  vec_sort_by(vec, less);
+  printf("%-26s %10zu %12.2f\n", "sort_by() ints", small,
+         bench_ms(start, bench_now_ns()));
+
+  int64_t *raw = malloc(large * sizeof(int64_t));
+  for (size_t i = 0; i < large; ++i) {
+    raw[i] = (int64_t)next_random();
+  }
+  start = bench_now_ns();
+  qsort(raw, large, sizeof(int64_t), compare_int64);
+  printf("%-26s %10zu %12.2f\n", "qsort int64_t", large,
+         bench_ms(start, bench_now_ns()));
+  free(raw);
+
+  vec = random_ints(large);
+  start = bench_now_ns();
+  vec_sort(vec);
+  printf("%-26s %10zu %12.2f\n", "sort() ints", large,
+         bench_ms(start, bench_now_ns()));
+
+  vec = random_floats(large);
+  start = bench_now_ns();
+  vec_sort(vec);
+  printf("%-26s %10zu %12.2f\n", "sort() floats", large,
+         bench_ms(start, bench_now_ns()));
+
+  vec = random_strings(large);
+  start = bench_now_ns();
+  vec_sort(vec);
+  printf("%-26s %10zu %12.2f\n", "sort() strings", large,
+         bench_ms(start, bench_now_ns()));
+
+  vec = random_ints(large);
+  start = bench_now_ns();
+  vec_sort_by(vec, less);
+  printf("%-26s %10zu %12.2f\n", "sort_by() ints", large,
+         bench_ms(start, bench_now_ns()));
+  return 0;
+}
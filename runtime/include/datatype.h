@@ -5,8 +5,15 @@
 
 #define VEC_INITIAL_SIZE 16
 #define DICT_INITIAL_SIZE 16
+// dicts of up to this many entries have no index and are searched linearly
+#define DICT_SMALL_SIZE 8
+// dicts with at least this many index slots are resized incrementally
+#define DICT_INCREMENTAL_RESIZE_MIN (1 << 16)
+// entries moved to the new index per insert during an incremental resize
+#define DICT_MIGRATE_STEP 32
 
 typedef struct RuntimeObject RuntimeObject;
+typedef struct DictEntry DictEntry;
 
 enum DataType {
   T_NOTHING,
@@ -17,30 +24,74 @@ enum DataType {
   T_VECTOR,
   T_DICT,
   T_MODULE,
-  T_FUNCTION
+  T_FUNCTION,
+  T_BYTES
 };
 
+// Bytes shared by the strings built by appending to one another, see
+// str_append_raw. data[used] is always a NUL.
+typedef struct {
+  size_t used;
+  size_t capacity;
+  char data[];
+} StringBuffer;
+
+// contents is only NUL-terminated at contents[length] if nothing has been
+// appended to the string since: always go by the length.
 typedef struct {
   size_t length;
   char *contents;
+  StringBuffer *buffer; // the buffer contents point into, if any
+  uint64_t hash;        // of the contents, 0 until str_hash computes it
+  // The string is the one in the intern table with its contents, so it is
+  // equal to another interned string only if that is the same String.
+  bool interned;
 } String;
 
+// Mutable binary data, one byte per element. A slice is a Bytes of its own
+// whose data points into the bytes it was taken from, so a write through
+// either shows in both.
+typedef struct {
+  size_t length;
+  uint8_t *data;
+} Bytes;
+
 typedef struct {
   size_t size;
   size_t internal_size;
-  RuntimeObject *contents;
+  // While every element is an int (or every element a float) the elements are
+  // stored unboxed in `ints` (`floats`) and `packed` is T_INT (T_FLOAT). The
+  // first element of any other type converts the vector to boxed `contents`
+  // for good, and `packed` becomes T_NOTHING. An empty vector adopts the
+  // representation of whatever is put into it first.
+  union {
+    RuntimeObject *contents;
+    int64_t *ints;
+    double *floats;
+  };
+  enum DataType packed;
+  // contents are borrowed from a constant literal and must be copied before
+  // the first mutation (copy-on-write).
+  bool shared;
 } Vector;
 
 typedef struct {
-  String key_hash;
-  RuntimeObject *key;
-  RuntimeObject *value;
-} DictEntry;
-
-typedef struct {
-  DictEntry *entries;
-  size_t capacity; // internal size
-  size_t size;     // utilized size
+  uint8_t *ctrl;       // one control byte per index slot, NULL while small
+                       // (see dictionary.c)
+  uint32_t *index;     // index slots, each the position of an entry
+  DictEntry *entries;  // dense, in insertion order
+  size_t capacity;     // number of index slots, a power of two (0 if small)
+  size_t size;         // number of entries
+  size_t used;         // entries in use, including holes left by removals
+  size_t growth_left;  // inserts left before the table has to grow
+  bool shared;         // storage is borrowed, copy-on-write (see Vector)
+  // Index being replaced by an incremental resize, NULL otherwise. Entries
+  // [migrated, migrate_end) are still only indexed here.
+  uint8_t *old_ctrl;
+  uint32_t *old_index;
+  size_t old_capacity;
+  size_t migrated;
+  size_t migrate_end;
 } Dict;
 
 typedef struct {
@@ -51,12 +102,24 @@ typedef struct {
 
 typedef struct {
   const char *name;
+  // Where the member is held. For a module's variables and constants that is
+  // the global the module's own code and static accesses (mod.x) use, so
+  // there is one cell per member whichever way it is read or assigned;
+  // otherwise it is `value`.
+  RuntimeObject **slot;
   RuntimeObject *value;
+  // only a module's variables can be assigned to, not its constants,
+  // functions or imports
+  bool assignable;
 } RuntimeSymbolTableEntry;
 
 typedef struct {
   size_t size;
   RuntimeSymbolTableEntry *entries;
+  // open-addressed hash index into entries (position + 1, 0 is empty), built
+  // on first lookup since entries are filled in after the table is made.
+  uint32_t *index;
+  size_t index_capacity;
 } RuntimeSymbolTable;
 
 typedef struct {
@@ -73,7 +136,19 @@ struct RuntimeObject {
     String *v_str;
     Vector *v_vec;
     Dict *v_dict;
-    Function v_func; // TODO replace with ptr to keep objects small
+    Function *v_func;
     Module *v_mod;
+    Bytes *v_bytes;
   } value;
-};
\ No newline at end of file
+};
+
+struct DictEntry {
+  uint64_t hash;        // cached so growing never rehashes the key
+  RuntimeObject *value;
+  RuntimeObject key;    // stored inline, so inserting a key doesn't allocate
+};
+
+// Vectors store their elements inline, so every byte here is paid once per
+// element. Keep every union member pointer-sized or smaller.
+_Static_assert(sizeof(RuntimeObject) <= 16,
+               "RuntimeObject must not grow beyond 16 bytes");
\ No newline at end of file
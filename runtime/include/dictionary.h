@@ -5,11 +5,21 @@
 #define FNV_OFFSET 14695981039346656037UL
 #define FNV_PRIME 1099511628211UL
 
-// static uint64_t hash_key(const char* key);
+extern size_t dict_incremental_resize_min;
+extern size_t dict_migrate_step;
 
-RuntimeObject *dict_get(Dict *dict, const char *key);
+void dict_init(Dict *dict, size_t size);
 
-const char *dict_set(Dict *dict, String key_hash, RuntimeObject *key,
-                     RuntimeObject *value);
+uint64_t dict_hash_key(RuntimeObject *key);
 
-DictEntry *dict_get_entry(Dict *dict, const char *key);
+RuntimeObject *dict_get(Dict *dict, RuntimeObject *key);
+
+bool dict_set(Dict *dict, RuntimeObject *key, RuntimeObject *value);
+
+bool dict_delete(Dict *dict, RuntimeObject *key);
+
+void dict_reset(Dict *dict);
+
+DictEntry *dict_get_entry(Dict *dict, RuntimeObject *key);
+
+void dict_unshare(Dict *dict);
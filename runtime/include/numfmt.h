@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Number formatting shared by the runtime and the interpreter, so that both
+ * print the same text for the same number, see numfmt.c.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest results, including the terminating NUL:
+// "-9223372036854775808" and "-2.2250738585072014e-308".
+#define FORMAT_INT_MAX 21
+#define FORMAT_FLOAT_MAX 32
+
+// Write the decimal form of value to out, NUL-terminated, and return its
+// length.
+size_t format_int(char *out, int64_t value);
+
+// Write the shortest decimal that reads back as exactly value to out,
+// NUL-terminated, and return its length.
+size_t format_float(char *out, double value);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,10 +8,71 @@ String *make_string_raw(char *value);
 
 String *make_string_nocopy_raw(char *value);
 
+String *make_string_length_raw(char *value, size_t length);
+
+void string_init(String *str, char *contents, size_t length);
+
+RuntimeObject *make_string_block(size_t room);
+
+String *str_view_raw(String *parent, char *contents, size_t length);
+
+String *str_append_raw(String *lhs, const char *bytes, size_t length);
+
+RuntimeObject *str_append(String *lhs, const char *bytes, size_t length);
+
 String *str_concat_raw(String *lhs, String *rhs);
 
+RuntimeObject *make_string_from_raw(String *str);
+
 String *to_string_raw(RuntimeObject *obj);
 
-String *get_dict_key(RuntimeObject *key);
+// A shared int object if value is small, otherwise a new one.
+RuntimeObject *small_int(int64_t value);
+
+// Hashing, equality and interning of strings, see intern.c.
+uint64_t str_hash(String *str);
+
+bool str_equal(String *lhs, String *rhs);
+
+RuntimeObject *single_char_string(char c);
+
+// Bytes, see bytes.c. Indexes are bounds-checked.
+RuntimeObject *make_bytes_raw(uint8_t *data, size_t length);
+
+RuntimeObject *bytes_get(Bytes *bytes, int64_t index);
+
+void bytes_set(Bytes *bytes, int64_t index, RuntimeObject *value);
+
+String *bytes_to_string_raw(Bytes *bytes);
 
 RuntimeObject *dict_keys_raw(Dict *dict);
+
+void vec_get(Vector *vec, size_t index, RuntimeObject *out);
+
+bool equality_comparison(RuntimeObject *lhs, RuntimeObject *rhs);
+
+// Numeric kernels over packed vector storage, see vecmath.c. The min and max
+// kernels need at least one element.
+#define VEC_LANES 4
+int64_t ints_sum(const int64_t *elems, size_t n);
+double floats_sum(const double *elems, size_t n);
+int64_t ints_min(const int64_t *elems, size_t n);
+int64_t ints_max(const int64_t *elems, size_t n);
+double floats_min(const double *elems, size_t n);
+double floats_max(const double *elems, size_t n);
+int64_t ints_dot(const int64_t *lhs, const int64_t *rhs, size_t n);
+double floats_dot(const double *lhs, const double *rhs, size_t n);
+size_t ints_count(const int64_t *elems, size_t n, int64_t value);
+size_t floats_count(const double *elems, size_t n, double value);
+void ints_fill(int64_t *elems, size_t n, int64_t value);
+void floats_fill(double *elems, size_t n, double value);
+
+// Position of the first occurrence of needle in haystack, or NULL, see
+// strscan.c.
+const char *bytes_find(const char *haystack, size_t n, const char *needle,
+                       size_t length);
+
+// Buffered standard output, see output.c.
+void output_write(const char *bytes, size_t length);
+void output_end();
+void output_flush();
@@ -9,15 +9,34 @@
 bool get_conditional_result(RuntimeObject *obj);
 
 void builtin_print(RuntimeObject *arg);
+void builtin_write(RuntimeObject *arg);
+void builtin_flush();
+RuntimeObject *builtin_read_file(RuntimeObject *path);
+RuntimeObject *builtin_lines(RuntimeObject *path);
+RuntimeObject *builtin_read_line();
+RuntimeObject *builtin_read_all();
+RuntimeObject *builtin_read_chunk(RuntimeObject *count);
+RuntimeObject *builtin_read_into(RuntimeObject *buffer);
+RuntimeObject *builtin_bytes(RuntimeObject *from);
+RuntimeObject *builtin_read_bytes(RuntimeObject *path);
+RuntimeObject *builtin_write_bytes(RuntimeObject *path, RuntimeObject *data);
+RuntimeObject *builtin_json_parse(RuntimeObject *text);
+RuntimeObject *builtin_json_dump(RuntimeObject *value);
 void runtime_error(char *msg);
 
 RuntimeObject *dynamic_function_call(RuntimeObject *dynamic_fn, size_t argc,
                                      RuntimeObject *argv[]);
+RuntimeObject *dynamic_method_call(RuntimeObject *self, char *identifier,
+                                   size_t argc, RuntimeObject *argv[]);
 
 RuntimeObject *make_argv(int argc, char *argv[]);
 
 RuntimeObject *get_index(RuntimeObject *lhs, RuntimeObject *rhs);
+RuntimeObject *get_index_into(RuntimeObject *lhs, RuntimeObject *rhs,
+                              RuntimeObject *out);
+void set_index(RuntimeObject *lhs, RuntimeObject *rhs, RuntimeObject *value);
 RuntimeObject *field_access(RuntimeObject *lhs, char *identifier);
+RuntimeObject **field_access_lvalue(RuntimeObject *lhs, char *identifier);
 
 // ARITHMETIC OP + STRCAT
 RuntimeObject *op_add(RuntimeObject *lhs, RuntimeObject *rhs);
@@ -52,34 +71,119 @@ RuntimeObject *make_string_nocopy(char *value);
 RuntimeObject *make_vector();
 RuntimeObject *make_dict();
 RuntimeObject *make_vector_known_size(size_t size);
+RuntimeObject *make_dict_known_size(size_t size);
+RuntimeObject *make_vector_cow(RuntimeObject *template);
+RuntimeObject *make_dict_cow(RuntimeObject *template);
 RuntimeObject *make_function(RuntimeObject *(*fn_ptr)(size_t argc,
                                                       RuntimeObject *argv[]));
 RuntimeObject *make_function_with_metadata(
     RuntimeObject *(*fn_ptr)(size_t argc, RuntimeObject *argv[]),
     char *signature);
 RuntimeObject *make_module(char *module_name, size_t num_entries);
+RuntimeObject *make_object_copy(RuntimeObject *value);
+
+// The String in the intern table with the contents of str, which becomes it
+// if there is none yet. Generated code interns its string literals.
+String *str_intern(String *str);
+
+// The String in the intern table with the contents of str, or NULL; unlike
+// str_intern this never adds str, so str can be a temporary.
+String *str_intern_find(String *str);
 
 // Vector Methods
+void vec_unshare(Vector *vec);
 RuntimeObject *vec_length(RuntimeObject *self);
 RuntimeObject *vec_append(RuntimeObject *self, RuntimeObject *obj);
+RuntimeObject *vec_reserve(RuntimeObject *self, RuntimeObject *capacity);
+RuntimeObject *vec_extend(RuntimeObject *self, RuntimeObject *other);
+RuntimeObject *vec_pop(RuntimeObject *self);
+RuntimeObject *vec_insert(RuntimeObject *self, RuntimeObject *index,
+                          RuntimeObject *obj);
+RuntimeObject *vec_remove(RuntimeObject *self, RuntimeObject *index);
+RuntimeObject *vec_clear(RuntimeObject *self);
+RuntimeObject *vec_shrink_to_fit(RuntimeObject *self);
+RuntimeObject *vec_sum(RuntimeObject *self);
+RuntimeObject *vec_min(RuntimeObject *self);
+RuntimeObject *vec_max(RuntimeObject *self);
+RuntimeObject *vec_dot(RuntimeObject *self, RuntimeObject *other);
+RuntimeObject *vec_count(RuntimeObject *self, RuntimeObject *value);
+RuntimeObject *vec_fill(RuntimeObject *self, RuntimeObject *value,
+                        RuntimeObject *count);
+RuntimeObject *vec_sort(RuntimeObject *self);
+RuntimeObject *vec_sort_by(RuntimeObject *self, RuntimeObject *less);
 RuntimeObject *vec_length_dynamic(size_t argc, RuntimeObject *argv[]);
 RuntimeObject *vec_append_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_reserve_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_extend_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_pop_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_insert_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_remove_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_clear_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_shrink_to_fit_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_sum_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_min_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_max_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_dot_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_count_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_fill_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_sort_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *vec_sort_by_dynamic(size_t argc, RuntimeObject *argv[]);
 
 // String Methods
 RuntimeObject *str_length(RuntimeObject *self);
 RuntimeObject *str_length_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *str_substr(RuntimeObject *self, RuntimeObject *start,
+                          RuntimeObject *count);
+RuntimeObject *str_substr_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *str_find(RuntimeObject *self, RuntimeObject *needle);
+RuntimeObject *str_find_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *str_contains(RuntimeObject *self, RuntimeObject *needle);
+RuntimeObject *str_contains_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *str_starts_with(RuntimeObject *self, RuntimeObject *prefix);
+RuntimeObject *str_starts_with_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *str_ends_with(RuntimeObject *self, RuntimeObject *suffix);
+RuntimeObject *str_ends_with_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *str_split(RuntimeObject *self, RuntimeObject *separator);
+RuntimeObject *str_split_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *str_join(RuntimeObject *self, RuntimeObject *parts);
+RuntimeObject *str_join_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *str_replace(RuntimeObject *self, RuntimeObject *from,
+                           RuntimeObject *to);
+RuntimeObject *str_replace_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *str_trim(RuntimeObject *self);
+RuntimeObject *str_trim_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *str_next_line(RuntimeObject *self, RuntimeObject *start);
+RuntimeObject *str_next_line_dynamic(size_t argc, RuntimeObject *argv[]);
+
+// Bytes Methods
+RuntimeObject *bytes_length(RuntimeObject *self);
+RuntimeObject *bytes_length_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *bytes_slice(RuntimeObject *self, RuntimeObject *start,
+                           RuntimeObject *end);
+RuntimeObject *bytes_slice_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *bytes_copy_from(RuntimeObject *self, RuntimeObject *source,
+                               RuntimeObject *at);
+RuntimeObject *bytes_copy_from_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *bytes_to_string(RuntimeObject *self);
+RuntimeObject *bytes_to_string_dynamic(size_t argc, RuntimeObject *argv[]);
 
 // Dictionary Methods
 void _dict_put(RuntimeObject *dict, RuntimeObject *key, RuntimeObject *value);
 RuntimeObject *dict_length(RuntimeObject *self);
 RuntimeObject *dict_keys(RuntimeObject *self);
 RuntimeObject *dict_contains(RuntimeObject *self, RuntimeObject *key);
+RuntimeObject *dict_remove(RuntimeObject *self, RuntimeObject *key);
+RuntimeObject *dict_clear(RuntimeObject *self);
 RuntimeObject *dict_length_dynamic(size_t argc, RuntimeObject *argv[]);
 RuntimeObject *dict_keys_dynamic(size_t argc, RuntimeObject *argv[]);
 RuntimeObject *dict_contains_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *dict_remove_dynamic(size_t argc, RuntimeObject *argv[]);
+RuntimeObject *dict_clear_dynamic(size_t argc, RuntimeObject *argv[]);
 
 // Module Methods
 void make_rtste(RuntimeSymbolTableEntry *rtste, char *name,
                 RuntimeObject *value);
+void make_rtste_global(RuntimeSymbolTableEntry *rtste, char *name,
+                       RuntimeObject **global, bool assignable);
 RuntimeSymbolTableEntry *runtime_st_lookup(RuntimeSymbolTable *st,
                                            char *identifier);
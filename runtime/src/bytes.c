@@ -0,0 +1,156 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "datatype.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * Bytes: mutable binary data stored one byte per element, where a vector of
+ * ints would take a 16-byte RuntimeObject per element once boxed and a string
+ * can't be written to. Indexing reads and writes a byte in place. A slice is
+ * a view sharing the bytes of the buffer it was taken from, like the views
+ * substr makes of strings, except that writes show through: slicing a header
+ * off a record and filling it in fills in the record.
+ *
+ * Reading a byte gives one of the preallocated small ints (see small_int), so
+ * walking a buffer doesn't allocate, the same way indexing a string gives one
+ * of the preallocated one-character strings.
+ */
+
+// The object and its Bytes header in one allocation; data is not copied.
+RuntimeObject *make_bytes_raw(uint8_t *data, size_t length) {
+  struct {
+    RuntimeObject obj;
+    Bytes bytes;
+  } *block = malloc(sizeof(*block));
+  block->bytes = (Bytes){.length = length, .data = data};
+  block->obj = (RuntimeObject){.type = T_BYTES, .value.v_bytes = &block->bytes};
+  return &block->obj;
+}
+
+// The contents of a bytes or string argument, or a runtime error.
+static const uint8_t *bytes_arg(RuntimeObject *arg, size_t *length,
+                                char *error) {
+  if (arg->type == T_BYTES) {
+    *length = arg->value.v_bytes->length;
+    return arg->value.v_bytes->data;
+  }
+  if (arg->type == T_STRING) {
+    *length = arg->value.v_str->length;
+    return (const uint8_t *)arg->value.v_str->contents;
+  }
+  runtime_error(error);
+  return NULL;
+}
+
+RuntimeObject *builtin_bytes(RuntimeObject *from) {
+  if (from->type == T_INT) {
+    if (from->value.v_int < 0) {
+      runtime_error("bytes() length must not be negative.");
+    }
+    size_t length = (size_t)from->value.v_int;
+    // calloc rather than malloc and memset: fresh pages are already zero
+    return make_bytes_raw(calloc(length > 0 ? length : 1, 1), length);
+  }
+  size_t length = 0;
+  const uint8_t *data =
+      bytes_arg(from, &length, "bytes() needs a length, a string or bytes.");
+  uint8_t *copy = malloc(length > 0 ? length : 1);
+  memcpy(copy, data, length);
+  return make_bytes_raw(copy, length);
+}
+
+RuntimeObject *bytes_get(Bytes *bytes, int64_t index) {
+  if (index < 0 || (uint64_t)index >= bytes->length) {
+    runtime_error("Bytes index out of bounds.");
+  }
+  return small_int(bytes->data[index]);
+}
+
+void bytes_set(Bytes *bytes, int64_t index, RuntimeObject *value) {
+  if (index < 0 || (uint64_t)index >= bytes->length) {
+    runtime_error("Bytes index out of bounds.");
+  }
+  if (value->type != T_INT || value->value.v_int < 0 ||
+      value->value.v_int > 255) {
+    runtime_error("A byte must be an int from 0 to 255.");
+  }
+  bytes->data[index] = (uint8_t)value->value.v_int;
+}
+
+String *bytes_to_string_raw(Bytes *bytes) {
+  char *contents = malloc(bytes->length + 1);
+  memcpy(contents, bytes->data, bytes->length);
+  contents[bytes->length] = '\0';
+  return make_string_length_raw(contents, bytes->length);
+}
+
+RuntimeObject *bytes_length(RuntimeObject *self) {
+  return make_int(self->value.v_bytes->length);
+}
+
+RuntimeObject *bytes_slice(RuntimeObject *self, RuntimeObject *start,
+                           RuntimeObject *end) {
+  Bytes *bytes = self->value.v_bytes;
+  if (start->type != T_INT || end->type != T_INT) {
+    runtime_error("slice() needs an int start and end.");
+  }
+  int64_t from = start->value.v_int, to = end->value.v_int;
+  if (from < 0 || from > to || (uint64_t)to > bytes->length) {
+    runtime_error("slice() bounds out of range.");
+  }
+  return make_bytes_raw(bytes->data + from, (size_t)(to - from));
+}
+
+RuntimeObject *bytes_copy_from(RuntimeObject *self, RuntimeObject *source,
+                               RuntimeObject *at) {
+  Bytes *bytes = self->value.v_bytes;
+  size_t length = 0;
+  const uint8_t *data =
+      bytes_arg(source, &length, "copy_from() needs bytes or a string.");
+  if (at->type != T_INT) {
+    runtime_error("copy_from() needs an int position.");
+  }
+  int64_t to = at->value.v_int;
+  if (to < 0 || (uint64_t)to > bytes->length ||
+      length > bytes->length - (size_t)to) {
+    runtime_error("copy_from() past the end of the bytes.");
+  }
+  // the source may be a slice overlapping the destination
+  memmove(bytes->data + to, data, length);
+  return make_nothing();
+}
+
+RuntimeObject *bytes_to_string(RuntimeObject *self) {
+  return make_string_from_raw(bytes_to_string_raw(self->value.v_bytes));
+}
+
+RuntimeObject *bytes_length_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 1) {
+    runtime_error("Argument number mismatch for bytes length.");
+  }
+  return bytes_length(argv[0]);
+}
+
+RuntimeObject *bytes_slice_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 3) {
+    runtime_error("Argument number mismatch for bytes slice.");
+  }
+  return bytes_slice(argv[0], argv[1], argv[2]);
+}
+
+RuntimeObject *bytes_copy_from_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 3) {
+    runtime_error("Argument number mismatch for bytes copy_from.");
+  }
+  return bytes_copy_from(argv[0], argv[1], argv[2]);
+}
+
+RuntimeObject *bytes_to_string_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 1) {
+    runtime_error("Argument number mismatch for bytes to_string.");
+  }
+  return bytes_to_string(argv[0]);
+}
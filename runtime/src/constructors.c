@@ -4,6 +4,8 @@
 #include <string.h>
 
 #include "datatype.h"
+#include "dictionary.h"
+#include "rtutil.h"
 
 #define max(a, b) a > b ? a : b;
 
@@ -11,7 +13,9 @@ Vector *make_empty_vector() {
   Vector *vec = malloc(sizeof(Vector));
   vec->size = 0;
   vec->internal_size = VEC_INITIAL_SIZE;
-  vec->contents = calloc(VEC_INITIAL_SIZE, sizeof(RuntimeObject));
+  vec->ints = calloc(VEC_INITIAL_SIZE, sizeof(int64_t));
+  vec->packed = T_INT;
+  vec->shared = false;
   return vec;
 }
 
@@ -23,22 +27,21 @@ RuntimeObject *make_vector_known_size(size_t size) {
   vec->size = size;
   vec->internal_size = final_size;
   vec->contents = calloc(final_size, sizeof(RuntimeObject));
+  vec->packed = T_NOTHING; // filled in by the caller, element by element
+  vec->shared = false;
 
   obj->value.v_vec = vec;
   return obj;
 }
 
-Dict *make_empty_dict() {
+Dict *make_empty_dict_for_size(size_t size) {
   Dict *dict = malloc(sizeof(Dict));
-  dict->size = 0;
-  dict->capacity = DICT_INITIAL_SIZE;
-  dict->entries = calloc(DICT_INITIAL_SIZE, sizeof(DictEntry));
-  for (size_t i = 0; i < DICT_INITIAL_SIZE; ++i) {
-    dict->entries[i].key_hash.contents = NULL;
-  }
+  dict_init(dict, size);
   return dict;
 }
 
+Dict *make_empty_dict() { return make_empty_dict_for_size(0); }
+
 RuntimeObject *make_nothing() {
   RuntimeObject *obj = malloc(sizeof(RuntimeObject));
   obj->type = T_NOTHING;
@@ -60,6 +63,32 @@ RuntimeObject *make_int(int64_t value) {
   return obj;
 }
 
+/*
+ * Ints from SMALL_INT_MIN up to SMALL_INT_MAX are preallocated, for reads of
+ * elements (of packed vectors, of bytes) that would otherwise allocate an int
+ * per read. Sharing them is safe because assignment rebinds whatever holds
+ * one and no operation writes into its operands.
+ */
+#define SMALL_INT_MIN (-128)
+#define SMALL_INT_MAX 1023
+
+static RuntimeObject small_ints[SMALL_INT_MAX - SMALL_INT_MIN + 1];
+static bool small_ints_ready = false;
+
+RuntimeObject *small_int(int64_t value) {
+  if (value < SMALL_INT_MIN || value > SMALL_INT_MAX) {
+    return make_int(value);
+  }
+  if (!small_ints_ready) {
+    for (int64_t i = SMALL_INT_MIN; i <= SMALL_INT_MAX; ++i) {
+      small_ints[i - SMALL_INT_MIN] =
+          (RuntimeObject){.type = T_INT, .value.v_int = i};
+    }
+    small_ints_ready = true;
+  }
+  return &small_ints[value - SMALL_INT_MIN];
+}
+
 RuntimeObject *make_float(double value) {
   RuntimeObject *obj = malloc(sizeof(RuntimeObject));
   obj->type = T_FLOAT;
@@ -67,26 +96,50 @@ RuntimeObject *make_float(double value) {
   return obj;
 }
 
+/*
+ * A string object with its String header and `room` bytes for the contents
+ * all in one allocation, instead of one each. contents points at the room,
+ * and the string is empty until the caller fills it in.
+ */
+RuntimeObject *make_string_block(size_t room) {
+  struct {
+    RuntimeObject obj;
+    String str;
+    char room[];
+  } *block = malloc(sizeof(*block) + room);
+  string_init(&block->str, room > 0 ? block->room : NULL, 0);
+  block->obj.type = T_STRING;
+  block->obj.value.v_str = &block->str;
+  return &block->obj;
+}
+
 RuntimeObject *make_string(char *value) {
-  RuntimeObject *obj = malloc(sizeof(RuntimeObject));
-  obj->type = T_STRING;
-  String *str = malloc(sizeof(String));
-  str->length = strlen(value);
-  str->contents = strdup(value);
-  obj->value.v_str = str;
+  size_t length = strlen(value);
+  RuntimeObject *obj = make_string_block(length + 1);
+  memcpy(obj->value.v_str->contents, value, length + 1);
+  obj->value.v_str->length = length;
   return obj;
 }
 
 RuntimeObject *make_string_nocopy(char *value) {
+  RuntimeObject *obj = make_string_block(0);
+  string_init(obj->value.v_str, value, strlen(value));
+  return obj;
+}
+
+RuntimeObject *make_string_from_raw(String *str) {
   RuntimeObject *obj = malloc(sizeof(RuntimeObject));
   obj->type = T_STRING;
-  String *str = malloc(sizeof(String));
-  str->length = strlen(value);
-  str->contents = value;
   obj->value.v_str = str;
   return obj;
 }
 
+RuntimeObject *make_object_copy(RuntimeObject *value) {
+  RuntimeObject *obj = malloc(sizeof(RuntimeObject));
+  *obj = *value;
+  return obj;
+}
+
 RuntimeObject *make_vector() {
   RuntimeObject *obj = malloc(sizeof(RuntimeObject));
   obj->type = T_VECTOR;
@@ -101,12 +154,46 @@ RuntimeObject *make_dict() {
   return obj;
 }
 
+RuntimeObject *make_dict_known_size(size_t size) {
+  RuntimeObject *obj = malloc(sizeof(RuntimeObject));
+  obj->type = T_DICT;
+  obj->value.v_dict = make_empty_dict_for_size(size);
+  return obj;
+}
+
+/*
+ * Constant aggregate literals are built once and then handed out as
+ * copy-on-write instances: each evaluation gets its own header that borrows
+ * the template's storage until it's first mutated.
+ */
+RuntimeObject *make_vector_cow(RuntimeObject *template) {
+  RuntimeObject *obj = malloc(sizeof(RuntimeObject));
+  obj->type = T_VECTOR;
+  Vector *vec = malloc(sizeof(Vector));
+  *vec = *template->value.v_vec;
+  vec->shared = true;
+  obj->value.v_vec = vec;
+  return obj;
+}
+
+RuntimeObject *make_dict_cow(RuntimeObject *template) {
+  RuntimeObject *obj = malloc(sizeof(RuntimeObject));
+  obj->type = T_DICT;
+  Dict *dict = malloc(sizeof(Dict));
+  *dict = *template->value.v_dict;
+  dict->shared = true;
+  obj->value.v_dict = dict;
+  return obj;
+}
+
 RuntimeObject *make_function(RuntimeObject *(*fn_ptr)(size_t argc,
                                                       RuntimeObject *argv[])) {
   RuntimeObject *obj = malloc(sizeof(RuntimeObject));
   obj->type = T_FUNCTION;
-  obj->value.v_func.fn_ptr = fn_ptr;
-  obj->value.v_func.signature = NULL;
+  Function *fn = malloc(sizeof(Function));
+  fn->fn_ptr = fn_ptr;
+  fn->signature = NULL;
+  obj->value.v_func = fn;
   return obj;
 }
 
@@ -115,8 +202,10 @@ RuntimeObject *make_function_with_metadata(
     char *signature) {
   RuntimeObject *obj = malloc(sizeof(RuntimeObject));
   obj->type = T_FUNCTION;
-  obj->value.v_func.fn_ptr = fn_ptr;
-  obj->value.v_func.signature = signature;
+  Function *fn = malloc(sizeof(Function));
+  fn->fn_ptr = fn_ptr;
+  fn->signature = signature;
+  obj->value.v_func = fn;
   return obj;
 }
 
@@ -128,6 +217,8 @@ RuntimeObject *make_module(char *module_name, size_t num_entries) {
   mod->name = strdup(module_name);
   mod->table.size = num_entries;
   mod->table.entries = malloc(num_entries * sizeof(RuntimeSymbolTableEntry));
+  mod->table.index = NULL;
+  mod->table.index_capacity = 0;
 
   obj->value.v_mod = mod;
   return obj;
@@ -137,4 +228,14 @@ void make_rtste(RuntimeSymbolTableEntry *rtste, char *name,
                 RuntimeObject *value) {
   rtste->name = strdup(name);
   rtste->value = value;
+  rtste->slot = &rtste->value;
+  rtste->assignable = false;
+}
+
+void make_rtste_global(RuntimeSymbolTableEntry *rtste, char *name,
+                       RuntimeObject **global, bool assignable) {
+  rtste->name = strdup(name);
+  rtste->value = NULL;
+  rtste->slot = global;
+  rtste->assignable = assignable;
 }
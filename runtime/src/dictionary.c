@@ -3,137 +3,554 @@
 
 #include "datatype.h"
 #include "dictionary.h"
+#include "rtutil.h"
+#include "runtime.h"
 
-static uint64_t hash_key(const char *key) {
-  uint64_t hash = FNV_OFFSET;
-  for (const char *p = key; *p; p++) {
-    hash ^= (uint64_t)(unsigned char)(*p);
-    hash *= FNV_PRIME;
+// Finalizer from MurmurHash3, spreads the bits of scalar keys (which are often
+// small, sequential ints) across the whole word.
+static uint64_t hash_scalar(uint64_t bits) {
+  bits ^= bits >> 33;
+  bits *= 0xff51afd7ed558ccdUL;
+  bits ^= bits >> 33;
+  bits *= 0xc4ceb9fe1a85ec53UL;
+  bits ^= bits >> 33;
+  return bits;
+}
+
+// Only bools, numbers and strings can be keys.
+static void check_hashable(RuntimeObject *key) {
+  switch (key->type) {
+  case T_BOOL:
+  case T_INT:
+  case T_FLOAT:
+  case T_STRING:
+    return;
+  default:
+    runtime_error("Unhashable type used for dictionary key");
+  }
+}
+
+/*
+ * Hashes a key by its type and native value. Keys of different types never
+ * compare equal (1, 1.0, "1" and true are all distinct keys).
+ */
+uint64_t dict_hash_key(RuntimeObject *key) {
+  switch (key->type) {
+  case T_BOOL:
+    return hash_scalar(key->value.v_bool) + T_BOOL;
+  case T_INT:
+    return hash_scalar((uint64_t)key->value.v_int) + T_INT;
+  case T_FLOAT: {
+    uint64_t bits;
+    memcpy(&bits, &key->value.v_float, sizeof(bits));
+    return hash_scalar(bits) + T_FLOAT;
+  }
+  case T_STRING:
+    return str_hash(key->value.v_str);
+  default:
+    runtime_error("Unhashable type used for dictionary key");
+  }
+  return 0;
+}
+
+static bool keys_equal(RuntimeObject *lhs, RuntimeObject *rhs) {
+  if (lhs->type != rhs->type) {
+    return false;
+  }
+  switch (lhs->type) {
+  case T_BOOL:
+    return lhs->value.v_bool == rhs->value.v_bool;
+  case T_INT:
+    return lhs->value.v_int == rhs->value.v_int;
+  case T_FLOAT:
+    // bitwise, so that a nan key can be found again
+    return memcmp(&lhs->value.v_float, &rhs->value.v_float,
+                  sizeof(double)) == 0;
+  case T_STRING:
+    return str_equal(lhs->value.v_str, rhs->value.v_str);
+  default:
+    return false;
   }
-  return hash;
 }
 
-RuntimeObject *dict_get(Dict *dict, const char *key) {
-  // AND hash with capacity-1 to ensure it's within entries array.
-  uint64_t hash = hash_key(key);
-  size_t index = (size_t)(hash & (uint64_t)(dict->capacity - 1));
+/*
+ * The table is a Swiss table: slots are split into groups of GROUP_WIDTH, and
+ * each slot has a control byte which is either CTRL_EMPTY, CTRL_DELETED (its
+ * key was removed; probes carry on past it and inserts can reuse it) or, for
+ * a used slot, the low 7 bits of its key's hash (h2) with the top bit set.
+ * A probe compares
+ * a whole group of control bytes against h2 at once, so keys are only
+ * compared on a likely match, and stops at the first group with an empty
+ * slot. Groups are probed in triangular order from the one picked by the rest
+ * of the hash (h1), which visits every group of a power-of-two table. The
+ * table grows at 7/8 load. Empty is zero so that a fresh index can come
+ * straight from calloc, which for large tables maps zeroed pages lazily
+ * instead of clearing them up front.
+ *
+ * The slots themselves only hold the position of an entry in the dense,
+ * insertion-ordered entries array (as in CPython's compact dict), so iterating
+ * a dict is a linear scan and its order is deterministic.
+ */
+#define CTRL_EMPTY 0x00
+#define CTRL_DELETED 0x01
+#define H1(hash) ((hash) >> 7)
+#define H2(hash) ((uint8_t)(0x80 | ((hash)&0x7f)))
 
-  // Loop till we find an empty entry.
-  while (dict->entries[index].key_hash.contents != NULL) {
-    if (strcmp(key, dict->entries[index].key_hash.contents) == 0) {
-      return dict->entries[index].value;
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GROUP_WIDTH 32
+
+// bit i is set if control byte i of the group equals byte
+static inline uint32_t group_match(const uint8_t *group, uint8_t byte) {
+  __m256i ctrl = _mm256_loadu_si256((const __m256i *)group);
+  return (uint32_t)_mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8((char)byte)));
+}
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define GROUP_WIDTH 16
+
+static inline uint32_t group_match(const uint8_t *group, uint8_t byte) {
+  __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+  return (uint32_t)_mm_movemask_epi8(
+      _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)byte)));
+}
+#else
+#define GROUP_WIDTH 8
+
+static inline uint32_t group_match(const uint8_t *group, uint8_t byte) {
+  uint32_t mask = 0;
+  for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+    mask |= (uint32_t)(group[i] == byte) << i;
+  }
+  return mask;
+}
+#endif
+
+static size_t max_load(size_t capacity) { return capacity - capacity / 8; }
+
+/*
+ * Tables with at least this many index slots grow incrementally: instead of
+ * reindexing every entry at once, the new index is filled dict_migrate_step
+ * entries per insert while lookups consult both indexes. Small tables are
+ * still rebuilt in one go, which is cheaper overall. Both are variables so
+ * that the benchmarks and tests can change them.
+ */
+size_t dict_incremental_resize_min = DICT_INCREMENTAL_RESIZE_MIN;
+size_t dict_migrate_step = DICT_MIGRATE_STEP;
+
+// Allocates an empty index of `capacity` slots, and room for as many entries
+// as it can hold. Existing entries are kept but not indexed.
+static void alloc_table(Dict *dict, size_t capacity) {
+  dict->ctrl = calloc(capacity, 1);
+  dict->index = malloc(capacity * sizeof(uint32_t));
+  dict->entries =
+      realloc(dict->entries, max_load(capacity) * sizeof(DictEntry));
+  dict->capacity = capacity;
+  dict->growth_left = max_load(capacity) - dict->used;
+}
+
+/*
+ * Dicts of up to DICT_SMALL_SIZE entries have no index at all (ctrl is NULL):
+ * lookups compare keys against each entry in turn, which for a handful of
+ * entries is faster than hashing the key, and the dict only takes as much
+ * memory as its entries. Entry hashes aren't computed until the dict outgrows
+ * this and gets an index.
+ */
+static bool is_small(Dict *dict) { return dict->ctrl == NULL; }
+
+static size_t initial_capacity() {
+  return DICT_INITIAL_SIZE < GROUP_WIDTH ? GROUP_WIDTH : DICT_INITIAL_SIZE;
+}
+
+/*
+ * Initializes an empty dict with room for `size` entries before it has to
+ * grow.
+ */
+void dict_init(Dict *dict, size_t size) {
+  dict->size = 0;
+  dict->used = 0;
+  dict->shared = false;
+  dict->entries = NULL;
+  dict->old_ctrl = NULL;
+  dict->old_index = NULL;
+  if (size <= DICT_SMALL_SIZE) {
+    dict->ctrl = NULL;
+    dict->index = NULL;
+    dict->capacity = 0;
+    dict->growth_left = size;
+    if (size > 0) {
+      dict->entries = malloc(size * sizeof(DictEntry));
     }
-    // Key wasn't in this slot, move to next (linear probing).
-    index++;
-    if (index >= dict->capacity) {
-      // At end of entries array, wrap around.
-      index = 0;
+    return;
+  }
+  size_t capacity = initial_capacity();
+  while (max_load(capacity) < size) {
+    capacity *= 2;
+  }
+  alloc_table(dict, capacity);
+}
+
+// Index of the first unused (empty or deleted) slot on key's probe sequence.
+static size_t find_unused_slot(uint8_t *ctrl, size_t capacity, uint64_t hash) {
+  size_t group_mask = capacity / GROUP_WIDTH - 1;
+  size_t group = H1(hash) & group_mask;
+  for (size_t step = 1;; ++step) {
+    const uint8_t *group_ctrl = &ctrl[group * GROUP_WIDTH];
+    uint32_t unused = group_match(group_ctrl, CTRL_EMPTY) |
+                      group_match(group_ctrl, CTRL_DELETED);
+    if (unused != 0) {
+      return group * GROUP_WIDTH + (size_t)__builtin_ctz(unused);
     }
+    group = (group + step) & group_mask;
   }
-  return NULL;
 }
 
-DictEntry *dict_get_entry(Dict *dict, const char *key) {
-  // AND hash with capacity-1 to ensure it's within entries array.
-  uint64_t hash = hash_key(key);
-  size_t index = (size_t)(hash & (uint64_t)(dict->capacity - 1));
+#define NO_SLOT SIZE_MAX
+
+// Slot of key in the given index, or NO_SLOT. Slots left pointing at removed
+// entries (see dict_delete) never match.
+static size_t find_slot(Dict *dict, const uint8_t *ctrl_bytes,
+                        const uint32_t *index, size_t capacity,
+                        RuntimeObject *key, uint64_t hash) {
+  size_t group_mask = capacity / GROUP_WIDTH - 1;
+  size_t group = H1(hash) & group_mask;
+  uint8_t h2 = H2(hash);
+  for (size_t step = 1;; ++step) {
+    // the positions of a group are needed as soon as its control bytes
+    // match, so fetch both at once rather than one after the other
+    __builtin_prefetch(&index[group * GROUP_WIDTH]);
+    const uint8_t *ctrl = &ctrl_bytes[group * GROUP_WIDTH];
+    for (uint32_t match = group_match(ctrl, h2); match != 0;
+         match &= match - 1) {
+      size_t slot = group * GROUP_WIDTH + (size_t)__builtin_ctz(match);
+      DictEntry *entry = &dict->entries[index[slot]];
+      if (entry->hash == hash && entry->value != NULL &&
+          keys_equal(key, &entry->key)) {
+        return slot;
+      }
+    }
+    if (group_match(ctrl, CTRL_EMPTY) != 0) {
+      return NO_SLOT;
+    }
+    group = (group + step) & group_mask;
+  }
+}
 
-  // Loop till we find an empty entry.
-  while (dict->entries[index].key_hash.contents != NULL) {
-    if (strcmp(key, dict->entries[index].key_hash.contents) == 0) {
-      return &dict->entries[index];
+// While a resize is in progress, entries that haven't been migrated yet are
+// only in the old index.
+static DictEntry *dict_get_entry_hashed(Dict *dict, RuntimeObject *key,
+                                        uint64_t hash) {
+  size_t slot =
+      find_slot(dict, dict->ctrl, dict->index, dict->capacity, key, hash);
+  if (slot != NO_SLOT) {
+    return &dict->entries[dict->index[slot]];
+  }
+  if (dict->old_ctrl != NULL) {
+    slot = find_slot(dict, dict->old_ctrl, dict->old_index,
+                     dict->old_capacity, key, hash);
+    if (slot != NO_SLOT) {
+      return &dict->entries[dict->old_index[slot]];
     }
-    // Key wasn't in this slot, move to next (linear probing).
-    index++;
-    if (index >= dict->capacity) {
-      // At end of entries array, wrap around.
-      index = 0;
+  }
+  return NULL;
+}
+
+// Small dicts never hash their keys, so the key's type is checked here
+// instead, before it can be stored or compared.
+static DictEntry *small_dict_find(Dict *dict, RuntimeObject *key) {
+  check_hashable(key);
+  for (size_t i = 0; i < dict->size; i++) {
+    if (keys_equal(key, &dict->entries[i].key)) {
+      return &dict->entries[i];
     }
   }
   return NULL;
 }
 
-static const char *dict_set_entry(DictEntry *entries, size_t capacity,
-                                  const char *key_hash, RuntimeObject *key,
-                                  RuntimeObject *value, size_t *plength) {
-  // AND hash with capacity-1 to ensure it's within entries array.
-  uint64_t hash = hash_key(key_hash);
-  size_t index = (size_t)(hash & (uint64_t)(capacity - 1));
+DictEntry *dict_get_entry(Dict *dict, RuntimeObject *key) {
+  if (is_small(dict)) {
+    return small_dict_find(dict, key);
+  }
+  return dict_get_entry_hashed(dict, key, dict_hash_key(key));
+}
+
+/*
+ * Looks up the value for key, or NULL if it isn't present. Never allocates
+ * and never modifies the dict.
+ */
+RuntimeObject *dict_get(Dict *dict, RuntimeObject *key) {
+  DictEntry *entry = dict_get_entry(dict, key);
+  return entry != NULL ? entry->value : NULL;
+}
+
+static void index_entry(Dict *dict, size_t position) {
+  uint64_t hash = dict->entries[position].hash;
+  size_t slot = find_unused_slot(dict->ctrl, dict->capacity, hash);
+  dict->ctrl[slot] = H2(hash);
+  dict->index[slot] = (uint32_t)position;
+}
 
-  // Loop till we find an empty entry.
-  while (entries[index].key_hash.contents != NULL) {
-    if (strcmp(key_hash, entries[index].key_hash.contents) == 0) {
-      // Found key (it already exists), update value.
-      entries[index].value = value;
-      return entries[index].key_hash.contents;
+// Moves up to `steps` more entries into the new index, and drops the old one
+// once they all are.
+static void dict_migrate(Dict *dict, size_t steps) {
+  // steps may be SIZE_MAX (finish it), so compare before adding
+  size_t end = steps >= dict->migrate_end - dict->migrated
+                   ? dict->migrate_end
+                   : dict->migrated + steps;
+  for (; dict->migrated < end; dict->migrated++) {
+    if (dict->entries[dict->migrated].value != NULL) {
+      index_entry(dict, dict->migrated);
     }
-    // Key wasn't in this slot, move to next (linear probing).
-    index++;
-    if (index >= capacity) {
-      // At end of entries array, wrap around.
-      index = 0;
+  }
+  if (dict->migrated == dict->migrate_end) {
+    free(dict->old_ctrl);
+    free(dict->old_index);
+    dict->old_ctrl = NULL;
+    dict->old_index = NULL;
+  }
+}
+
+/*
+ * Rebuilds the index at `capacity` slots in one go, squeezing out the entries
+ * of removed keys on the way. Used to grow a table that has removed entries,
+ * and to shrink one.
+ */
+static void dict_rebuild(Dict *dict, size_t capacity) {
+  free(dict->old_ctrl);
+  free(dict->old_index);
+  dict->old_ctrl = NULL;
+  dict->old_index = NULL;
+  size_t live = 0;
+  for (size_t i = 0; i < dict->used; i++) {
+    if (dict->entries[i].value != NULL) {
+      dict->entries[live++] = dict->entries[i];
     }
   }
+  dict->used = live;
+  free(dict->ctrl);
+  free(dict->index);
+  alloc_table(dict, capacity);
+  for (size_t i = 0; i < dict->used; i++) {
+    index_entry(dict, i);
+  }
+}
 
-  // Didn't find key, allocate+copy if needed, then insert it.
-  if (plength != NULL) {
-    key_hash = strdup(key_hash);
-    if (key_hash == NULL) {
-      return NULL;
+/*
+ * Makes room for another entry once growth_left has run out. If removed
+ * entries make up a good part of the table, it's compacted in place;
+ * otherwise the index doubles. Keys are unique and their hashes are cached,
+ * so each entry just goes into the first unused slot of the new index. Large
+ * tables keep the old index around and migrate into the new one a few
+ * entries at a time (see dict_incremental_resize_min); entries inserted
+ * meanwhile go straight into the new index.
+ */
+static void dict_expand(Dict *dict) {
+  if (dict->old_ctrl != NULL) {
+    // the new index filled up before the last resize finished
+    dict_migrate(dict, SIZE_MAX);
+  }
+  if (dict->size < max_load(dict->capacity) / 2) {
+    dict_rebuild(dict, dict->capacity);
+    return;
+  }
+  if (dict->used != dict->size ||
+      dict->capacity < dict_incremental_resize_min) {
+    dict_rebuild(dict, dict->capacity * 2);
+    return;
+  }
+  dict->old_ctrl = dict->ctrl;
+  dict->old_index = dict->index;
+  dict->old_capacity = dict->capacity;
+  dict->migrated = 0;
+  dict->migrate_end = dict->used;
+  alloc_table(dict, dict->capacity * 2);
+}
+
+// Gives a small dict that's full an index, hashing its entries.
+static void small_dict_promote(Dict *dict) {
+  for (size_t i = 0; i < dict->size; i++) {
+    dict->entries[i].hash = dict_hash_key(&dict->entries[i].key);
+  }
+  alloc_table(dict, initial_capacity());
+  for (size_t i = 0; i < dict->size; i++) {
+    index_entry(dict, i);
+  }
+}
+
+/*
+ * Give a copy-on-write dict its own storage before it's mutated.
+ */
+void dict_unshare(Dict *dict) {
+  if (!dict->shared) {
+    return;
+  }
+  size_t entries_capacity = dict->used + dict->growth_left;
+  DictEntry *entries = malloc(entries_capacity * sizeof(DictEntry));
+  memcpy(entries, dict->entries, dict->used * sizeof(DictEntry));
+  dict->entries = entries;
+  dict->shared = false;
+  if (is_small(dict)) {
+    return;
+  }
+  if (dict->old_ctrl != NULL) {
+    // the borrowed indexes are mid-resize, build a complete one instead
+    dict->old_ctrl = NULL;
+    dict->old_index = NULL;
+    dict->ctrl = calloc(dict->capacity, 1);
+    dict->index = malloc(dict->capacity * sizeof(uint32_t));
+    for (size_t i = 0; i < dict->used; i++) {
+      if (dict->entries[i].value != NULL) {
+        index_entry(dict, i);
+      }
     }
-    (*plength)++;
+    return;
   }
-  entries[index].key_hash.contents = (char *)key_hash;
-  entries[index].key_hash.length = strlen(key_hash);
-  entries[index].key = key;
-  entries[index].value = value;
-  return key_hash;
+  uint8_t *ctrl = malloc(dict->capacity);
+  memcpy(ctrl, dict->ctrl, dict->capacity);
+  uint32_t *index = malloc(dict->capacity * sizeof(uint32_t));
+  memcpy(index, dict->index, dict->capacity * sizeof(uint32_t));
+  dict->ctrl = ctrl;
+  dict->index = index;
 }
 
-// Expand hash table to twice its current size. Return true on success,
-// false if out of memory.
-static bool dict_expand(Dict *table) {
-  // Allocate new entries array.
-  size_t new_capacity = table->capacity * 2;
-  if (new_capacity < table->capacity) {
-    return false; // overflow (capacity would be too big)
+// String keys are stored interned, so looking them up with a string literal
+// (or another key) compares pointers rather than contents.
+static void store_key(DictEntry *entry, RuntimeObject *key) {
+  entry->key = *key;
+  if (key->type == T_STRING) {
+    entry->key.value.v_str = str_intern(key->value.v_str);
   }
-  DictEntry *new_entries = calloc(new_capacity, sizeof(DictEntry));
-  if (new_entries == NULL) {
+}
+
+/*
+ * Inserts or updates key. The key object is copied into the table; the value
+ * is stored by reference. Returns false if key or value is missing.
+ */
+bool dict_set(Dict *dict, RuntimeObject *key, RuntimeObject *value) {
+  if (value == NULL || key == NULL) {
     return false;
   }
-  for (size_t i = 0; i < new_capacity; ++i) {
-    new_entries[i].key_hash.contents = NULL;
-  }
 
-  // Iterate entries, move all non-empty ones to new table's entries.
-  for (size_t i = 0; i < table->capacity; i++) {
-    DictEntry *entry = &(table->entries[i]);
-    if (entry->key_hash.contents != NULL) {
-      dict_set_entry(new_entries, new_capacity, entry->key_hash.contents,
-                     entry->key, entry->value, NULL);
+  dict_unshare(dict);
+
+  if (is_small(dict)) {
+    DictEntry *entry = small_dict_find(dict, key);
+    if (entry != NULL) {
+      entry->value = value;
+      return true;
+    }
+    if (dict->size < DICT_SMALL_SIZE) {
+      if (dict->growth_left == 0) {
+        size_t grown = dict->size == 0 ? 2 : dict->size * 2;
+        grown = grown < DICT_SMALL_SIZE ? grown : DICT_SMALL_SIZE;
+        dict->entries = realloc(dict->entries, grown * sizeof(DictEntry));
+        dict->growth_left = grown - dict->size;
+      }
+      entry = &dict->entries[dict->size];
+      store_key(entry, key);
+      entry->value = value;
+      dict->size++;
+      dict->used++;
+      dict->growth_left--;
+      return true;
     }
+    small_dict_promote(dict);
   }
 
-  // Free old entries array and update this table's details.
-  free(table->entries);
-  table->entries = new_entries;
-  table->capacity = new_capacity;
+  if (dict->old_ctrl != NULL) {
+    dict_migrate(dict, dict_migrate_step);
+  }
+
+  uint64_t hash = dict_hash_key(key);
+  DictEntry *entry = dict_get_entry_hashed(dict, key, hash);
+  if (entry != NULL) {
+    // Found key (it already exists), update value.
+    entry->value = value;
+    return true;
+  }
+
+  if (dict->growth_left == 0) {
+    dict_expand(dict);
+  }
+
+  entry = &dict->entries[dict->used];
+  entry->hash = hash;
+  store_key(entry, key);
+  entry->value = value;
+  index_entry(dict, dict->used);
+  dict->size++;
+  dict->used++;
+  dict->growth_left--;
   return true;
 }
 
-const char *dict_set(Dict *dict, String key_hash, RuntimeObject *key,
-                     RuntimeObject *value) {
-  if (value == NULL || key == NULL) {
-    return NULL;
+// Marks key's slot in the given index as deleted, if it's there.
+static void unindex_key(Dict *dict, uint8_t *ctrl, uint32_t *index,
+                        size_t capacity, RuntimeObject *key, uint64_t hash) {
+  size_t slot = find_slot(dict, ctrl, index, capacity, key, hash);
+  if (slot != NO_SLOT) {
+    ctrl[slot] = CTRL_DELETED;
   }
+}
 
-  if (dict->size >= dict->capacity / 2) {
-    if (!dict_expand(dict)) {
-      return NULL;
+/*
+ * Removes key, returning whether it was present. In a small dict the
+ * following entries just move down. Otherwise the entry is left in place as
+ * a hole (its value is NULL) and its index slot is marked deleted, so that
+ * probes carry on past it; both are reclaimed the next time the table is
+ * rebuilt. A table that falls below a quarter of its load limit is rebuilt
+ * at half the size, so a dict that's emptied out gives its memory back.
+ */
+bool dict_delete(Dict *dict, RuntimeObject *key) {
+  dict_unshare(dict);
+
+  if (is_small(dict)) {
+    DictEntry *entry = small_dict_find(dict, key);
+    if (entry == NULL) {
+      return false;
     }
+    size_t position = (size_t)(entry - dict->entries);
+    memmove(entry, entry + 1,
+            (dict->size - position - 1) * sizeof(DictEntry));
+    dict->size--;
+    dict->used--;
+    dict->growth_left++;
+    return true;
+  }
+
+  uint64_t hash = dict_hash_key(key);
+  DictEntry *entry = dict_get_entry_hashed(dict, key, hash);
+  if (entry == NULL) {
+    return false;
+  }
+  // mid-resize, the key may be indexed in both the new and the old index
+  unindex_key(dict, dict->ctrl, dict->index, dict->capacity, key, hash);
+  if (dict->old_ctrl != NULL) {
+    unindex_key(dict, dict->old_ctrl, dict->old_index, dict->old_capacity,
+                key, hash);
   }
+  entry->value = NULL;
+  dict->size--;
 
-  return dict_set_entry(dict->entries, dict->capacity, key_hash.contents, key,
-                        value, &(dict->size));
-}
\ No newline at end of file
+  if (dict->capacity > initial_capacity() &&
+      dict->size < max_load(dict->capacity) / 4) {
+    dict_rebuild(dict, dict->capacity / 2);
+  }
+  return true;
+}
+
+/*
+ * Removes every entry, giving back the dict's storage (unless it's borrowed
+ * from a constant).
+ */
+void dict_reset(Dict *dict) {
+  if (!dict->shared) {
+    free(dict->ctrl);
+    free(dict->index);
+    free(dict->old_ctrl);
+    free(dict->old_index);
+    free(dict->entries);
+  }
+  dict_init(dict, 0);
+}
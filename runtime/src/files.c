@@ -0,0 +1,141 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "datatype.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * Reading files. A file is mapped into memory rather than read into a
+ * buffer, and the string read_file returns is the mapping itself, as are the
+ * lines lines() splits it into: no byte of the file is copied. The kernel
+ * pages the file in as it is scanned and can drop clean pages again, so a
+ * program can walk a file larger than memory. Mappings are never unmapped,
+ * the same way nothing else is ever freed.
+ *
+ * read_bytes maps the file the same way, but writable: the mapping is
+ * private, so writing to the bytes copies only the page written to, and
+ * never changes the file.
+ */
+
+static char error_message[512];
+
+static void file_error(const char *function, const char *verb,
+                       const char *path) {
+  snprintf(error_message, sizeof(error_message), "%s() could not %s %s: %s",
+           function, verb, path, strerror(errno));
+  runtime_error(error_message);
+}
+
+// The name in a path argument, NUL-terminated.
+static char *path_name(RuntimeObject *path, const char *function) {
+  if (path->type != T_STRING) {
+    snprintf(error_message, sizeof(error_message), "%s() needs a string path.",
+             function);
+    runtime_error(error_message);
+  }
+  return strndup(path->value.v_str->contents, path->value.v_str->length);
+}
+
+// The contents of the file named by path, mapped privately with protection
+// prot; size is set to their length.
+static char *map_file(RuntimeObject *path, const char *function, int prot,
+                      size_t *size) {
+  char *name = path_name(path, function);
+  int fd = open(name, O_RDONLY);
+  struct stat info;
+  if (fd < 0 || fstat(fd, &info) != 0) {
+    file_error(function, "read", name);
+  }
+  *size = (size_t)info.st_size;
+  char *contents = "";
+  if (*size > 0) {
+    contents = mmap(NULL, *size, prot, MAP_PRIVATE, fd, 0);
+    if (contents == MAP_FAILED) {
+      file_error(function, "read", name);
+    }
+    // read ahead aggressively, and drop pages behind once they're read
+    madvise(contents, *size, MADV_SEQUENTIAL);
+  }
+  close(fd);
+  free(name);
+  return contents;
+}
+
+static String *map_file_string(RuntimeObject *path, const char *function) {
+  size_t size;
+  char *contents = map_file(path, function, PROT_READ, &size);
+  return make_string_length_raw(contents, size);
+}
+
+RuntimeObject *builtin_read_file(RuntimeObject *path) {
+  return make_string_from_raw(map_file_string(path, "read_file"));
+}
+
+RuntimeObject *builtin_read_bytes(RuntimeObject *path) {
+  size_t size;
+  char *contents = map_file(path, "read_bytes", PROT_READ | PROT_WRITE, &size);
+  if (size == 0) {
+    // not the shared "" an empty file maps to, which nothing may write
+    return builtin_bytes(make_int(0));
+  }
+  return make_bytes_raw((uint8_t *)contents, size);
+}
+
+// Writes data, bytes or a string, to the file named by path, replacing what
+// it held.
+RuntimeObject *builtin_write_bytes(RuntimeObject *path, RuntimeObject *data) {
+  const char *contents = NULL;
+  size_t size = 0;
+  if (data->type == T_BYTES) {
+    contents = (const char *)data->value.v_bytes->data;
+    size = data->value.v_bytes->length;
+  } else if (data->type == T_STRING) {
+    contents = data->value.v_str->contents;
+    size = data->value.v_str->length;
+  } else {
+    runtime_error("write_bytes() needs bytes or a string to write.");
+  }
+  char *name = path_name(path, "write_bytes");
+  int fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0) {
+    file_error("write_bytes", "write", name);
+  }
+  while (size > 0) {
+    ssize_t written = write(fd, contents, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0) {
+      file_error("write_bytes", "write", name);
+    }
+    contents += written;
+    size -= (size_t)written;
+  }
+  close(fd);
+  free(name);
+  return make_nothing();
+}
+
+RuntimeObject *builtin_lines(RuntimeObject *path) {
+  String *str = map_file_string(path, "lines");
+  RuntimeObject *lines = make_vector();
+  RuntimeObject line = {.type = T_STRING};
+  char *from = str->contents;
+  char *end = str->contents + str->length;
+  // a newline ends a line, so there's no empty line after the last one
+  while (from < end) {
+    char *at = memchr(from, '\n', end - from);
+    char *line_end = at != NULL ? at : end;
+    line.value.v_str = str_view_raw(str, from, line_end - from);
+    vec_append(lines, &line);
+    from = line_end + 1;
+  }
+  return lines;
+}
@@ -0,0 +1,188 @@
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "datatype.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * Buffered standard input. read_line, read_all, read_chunk and read_into take
+ * what they need from one large buffer, which is refilled with a single
+ * read() when it runs out, so a program reading a line at a time makes one
+ * system call per buffer rather than per line. Together with the output
+ * buffer (see output.c) that lets a compiled program work as a filter in a
+ * pipeline at close to the speed of cat.
+ *
+ * At the end of input each of them but read_into returns nothing.
+ */
+
+#define INPUT_BUFFER_SIZE (256 * 1024)
+
+static struct {
+  char data[INPUT_BUFFER_SIZE];
+  size_t start, end; // the unread bytes are data[start, end)
+  bool eof;
+} input;
+
+// Read from stdin into bytes, retrying when interrupted; 0 at the end of
+// input, which a read error is treated as too.
+static size_t read_some(char *bytes, size_t length) {
+  for (;;) {
+    ssize_t got = read(STDIN_FILENO, bytes, length);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    return got > 0 ? (size_t)got : 0;
+  }
+}
+
+// Refill the buffer once it's all been read. False at the end of input.
+static bool input_fill() {
+  if (input.eof) {
+    return false;
+  }
+  input.start = 0;
+  input.end = read_some(input.data, INPUT_BUFFER_SIZE);
+  input.eof = input.end == 0;
+  return !input.eof;
+}
+
+static RuntimeObject *copy_string(const char *bytes, size_t length) {
+  RuntimeObject *obj = make_string_block(length + 1);
+  String *str = obj->value.v_str;
+  memcpy(str->contents, bytes, length);
+  str->contents[length] = '\0';
+  str->length = length;
+  return obj;
+}
+
+// Bytes collected across refills, for lines longer than what was buffered
+// and for read_all.
+typedef struct {
+  char *bytes;
+  size_t length, capacity;
+} Collected;
+
+static void collect(Collected *collected, const char *bytes, size_t length) {
+  // room for the bytes and the terminating '\0'
+  if (collected->capacity - collected->length <= length) {
+    size_t capacity = collected->capacity == 0 ? 1024 : collected->capacity;
+    while (capacity - collected->length <= length) {
+      capacity *= 2;
+    }
+    collected->bytes = realloc(collected->bytes, capacity);
+    collected->capacity = capacity;
+  }
+  memcpy(collected->bytes + collected->length, bytes, length);
+  collected->length += length;
+}
+
+static RuntimeObject *collected_string(Collected *collected) {
+  collected->bytes[collected->length] = '\0';
+  return make_string_from_raw(
+      make_string_length_raw(collected->bytes, collected->length));
+}
+
+RuntimeObject *builtin_read_line() {
+  Collected collected = {NULL, 0, 0};
+  for (;;) {
+    char *from = input.data + input.start;
+    size_t available = input.end - input.start;
+    char *at = memchr(from, '\n', available);
+    if (at != NULL) {
+      size_t length = (size_t)(at - from);
+      input.start += length + 1;
+      if (collected.bytes == NULL) {
+        return copy_string(from, length);
+      }
+      collect(&collected, from, length);
+      return collected_string(&collected);
+    }
+    if (available > 0) {
+      collect(&collected, from, available);
+      input.start = input.end;
+    }
+    if (!input_fill()) {
+      // the last line needn't end with a newline
+      if (collected.length == 0) {
+        free(collected.bytes);
+        return make_nothing();
+      }
+      return collected_string(&collected);
+    }
+  }
+}
+
+RuntimeObject *builtin_read_all() {
+  Collected collected = {NULL, 0, 0};
+  collect(&collected, input.data + input.start, input.end - input.start);
+  input.start = input.end;
+  while (input_fill()) {
+    collect(&collected, input.data, input.end);
+    input.start = input.end;
+  }
+  if (collected.length == 0) {
+    free(collected.bytes);
+    return make_nothing();
+  }
+  return collected_string(&collected);
+}
+
+// Read wanted bytes into `into`, or fewer only at the end of input. Returns
+// how many were read.
+static size_t input_read(char *into, size_t wanted) {
+  size_t length = 0;
+  while (length < wanted) {
+    size_t available = input.end - input.start;
+    if (available == 0) {
+      if (input.eof) {
+        break;
+      }
+      // big reads go straight into the destination, small ones through the
+      // buffer
+      if (wanted - length >= INPUT_BUFFER_SIZE) {
+        size_t got = read_some(into + length, wanted - length);
+        length += got;
+        input.eof = got == 0;
+        continue;
+      }
+      input_fill();
+      continue;
+    }
+    size_t take = wanted - length < available ? wanted - length : available;
+    memcpy(into + length, input.data + input.start, take);
+    input.start += take;
+    length += take;
+  }
+  return length;
+}
+
+RuntimeObject *builtin_read_chunk(RuntimeObject *count) {
+  if (count->type != T_INT || count->value.v_int <= 0) {
+    runtime_error("read_chunk() needs a positive int.");
+  }
+  size_t wanted = (size_t)count->value.v_int;
+  RuntimeObject *chunk = make_string_block(wanted + 1);
+  String *str = chunk->value.v_str;
+  str->length = input_read(str->contents, wanted);
+  if (str->length == 0) {
+    return make_nothing();
+  }
+  str->contents[str->length] = '\0';
+  return chunk;
+}
+
+// Fills buffer, which must be bytes, from the input without allocating, and
+// returns how many bytes were read: the buffer's length, or fewer only at the
+// end of input, where it is 0 rather than nothing so that a loop can compare
+// it.
+RuntimeObject *builtin_read_into(RuntimeObject *buffer) {
+  if (buffer->type != T_BYTES) {
+    runtime_error("read_into() needs bytes to read into.");
+  }
+  Bytes *bytes = buffer->value.v_bytes;
+  return make_int(input_read((char *)bytes->data, bytes->length));
+}
@@ -0,0 +1,151 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "datatype.h"
+#include "dictionary.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * The intern table holds one String per distinct contents. String literals
+ * (interned once when a program starts) and dict keys (when they are
+ * inserted) are replaced by the table's String, so comparing two of them is a
+ * pointer comparison, and a dict lookup with a literal key finds its entry
+ * without looking at the bytes. Every String also caches its hash.
+ *
+ * One-character strings don't go in the table: there are only 256 of them,
+ * and they are preallocated, which also lets indexing a string return one
+ * without allocating. The objects are shared by every string they were read
+ * out of, which is safe because assigning to whatever holds one (a variable,
+ * a module member, an element) rebinds it rather than writing into the object.
+ */
+
+#define INTERN_MIN_CAPACITY 64
+
+static struct {
+  String **slots; // open addressing, linear probing; NULL is empty
+  size_t capacity;
+  size_t size;
+} table;
+
+static char single_char_bytes[256][2];
+static String single_char_strings[256];
+static RuntimeObject single_char_objects[256];
+static bool single_chars_ready = false;
+
+uint64_t str_hash(String *str) {
+  // a string whose hash really is 0 is hashed every time, which is harmless
+  if (str->hash == 0) {
+    uint64_t hash = FNV_OFFSET;
+    for (size_t i = 0; i < str->length; i++) {
+      hash ^= (uint64_t)(unsigned char)str->contents[i];
+      hash *= FNV_PRIME;
+    }
+    str->hash = hash;
+  }
+  return str->hash;
+}
+
+bool str_equal(String *lhs, String *rhs) {
+  if (lhs == rhs) {
+    return true;
+  }
+  if (lhs->interned && rhs->interned) {
+    return false;
+  }
+  if (lhs->length != rhs->length) {
+    return false;
+  }
+  if (lhs->hash != 0 && rhs->hash != 0 && lhs->hash != rhs->hash) {
+    return false;
+  }
+  return memcmp(lhs->contents, rhs->contents, lhs->length) == 0;
+}
+
+static void make_single_chars() {
+  for (size_t c = 0; c < 256; ++c) {
+    single_char_bytes[c][0] = (char)c;
+    String *str = &single_char_strings[c];
+    *str = (String){.length = 1, .contents = single_char_bytes[c]};
+    str_hash(str);
+    str->interned = true;
+    single_char_objects[c] =
+        (RuntimeObject){.type = T_STRING, .value.v_str = str};
+  }
+  single_chars_ready = true;
+}
+
+RuntimeObject *single_char_string(char c) {
+  if (!single_chars_ready) {
+    make_single_chars();
+  }
+  return &single_char_objects[(unsigned char)c];
+}
+
+// Slot of the string in the table with the contents of str, or of the empty
+// slot where it would go.
+static size_t intern_probe(String **slots, size_t capacity, String *str) {
+  size_t mask = capacity - 1;
+  size_t i = str->hash & mask;
+  while (slots[i] != NULL) {
+    String *entry = slots[i];
+    if (entry->hash == str->hash && entry->length == str->length &&
+        memcmp(entry->contents, str->contents, str->length) == 0) {
+      break;
+    }
+    i = (i + 1) & mask;
+  }
+  return i;
+}
+
+static void intern_grow() {
+  size_t capacity =
+      table.capacity == 0 ? INTERN_MIN_CAPACITY : 2 * table.capacity;
+  String **slots = calloc(capacity, sizeof(String *));
+  for (size_t i = 0; i < table.capacity; ++i) {
+    if (table.slots[i] != NULL) {
+      slots[intern_probe(slots, capacity, table.slots[i])] = table.slots[i];
+    }
+  }
+  free(table.slots);
+  table.slots = slots;
+  table.capacity = capacity;
+}
+
+String *str_intern(String *str) {
+  if (str->interned) {
+    return str;
+  }
+  if (str->length == 1) {
+    return single_char_string(str->contents[0])->value.v_str;
+  }
+  str_hash(str);
+  // at most half full
+  if (2 * (table.size + 1) > table.capacity) {
+    intern_grow();
+  }
+  size_t i = intern_probe(table.slots, table.capacity, str);
+  if (table.slots[i] == NULL) {
+    // strings never change, so this one can be the table's from now on
+    str->interned = true;
+    table.slots[i] = str;
+    table.size++;
+  }
+  return table.slots[i];
+}
+
+String *str_intern_find(String *str) {
+  if (str->interned) {
+    return str;
+  }
+  if (str->length == 1) {
+    return single_char_string(str->contents[0])->value.v_str;
+  }
+  if (table.size == 0) {
+    return NULL;
+  }
+  str_hash(str);
+  return table.slots[intern_probe(table.slots, table.capacity, str)];
+}
@@ -0,0 +1,730 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "datatype.h"
+#include "dictionary.h"
+#include "numfmt.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * json_parse and json_dump.
+ *
+ * The parser makes one pass over the text and builds the values as it reads
+ * them: there is no tokenizer and no intermediate tree. The elements of an
+ * array (the keys and values of an object) are gathered on a stack shared by
+ * the whole parse, and moved into a vector (dict) of exactly the right size
+ * at the closing bracket, so nothing is regrown. Arrays of only ints or only
+ * floats become packed vectors. Strings without escapes, which is most of
+ * them, are found a block of bytes at a time and copied straight out of the
+ * text, and an object key that is already interned isn't copied at all.
+ * Strings, dict values and the vector and dict headers are carved out of
+ * large blocks instead of being allocated one by one: nothing in the runtime
+ * is ever freed, so nothing needs them to be separate allocations. (Vector
+ * and dict storage is still malloc'd, since it's resized in place.)
+ *
+ * null, true and false are nothing and the bools, numbers without a fraction
+ * or exponent that fit in 64 bits are ints and other numbers floats, arrays
+ * are vectors and objects dicts. json_dump writes that back, compactly, with
+ * numbers formatted the way print does; dict keys have to be strings.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// deeper documents are rejected rather than risk the stack
+#define JSON_MAX_DEPTH 1000
+#define JSON_BLOCK_SIZE (256 * 1024)
+
+typedef struct {
+  const char *text; // for error positions
+  const char *at;
+  const char *end;
+  size_t depth;
+  // elements of the arrays and objects being parsed, innermost last
+  RuntimeObject *stack;
+  size_t stack_size, stack_capacity;
+  // contents of a string with escapes, as they are decoded
+  char *scratch;
+  size_t scratch_length, scratch_capacity;
+  // what's left of the block being carved up
+  char *block;
+  size_t block_left;
+} Parser;
+
+static char error_message[256];
+
+// byte positions count from 1, as in the interpreter's messages
+static void parse_error(Parser *p, const char *what) {
+  snprintf(error_message, sizeof(error_message),
+           "json_parse(): %s at byte %zu.", what,
+           (size_t)(p->at - p->text) + 1);
+  runtime_error(error_message);
+}
+
+static inline void skip_space(Parser *p) {
+  while (p->at < p->end && (*p->at == ' ' || *p->at == '\n' ||
+                            *p->at == '\r' || *p->at == '\t')) {
+    p->at++;
+  }
+}
+
+// Skips whitespace and the character c, which has to be next.
+static void expect(Parser *p, char c, const char *what) {
+  skip_space(p);
+  if (p->at == p->end || *p->at != c) {
+    parse_error(p, what);
+  }
+  p->at++;
+}
+
+static void *carve(Parser *p, size_t size) {
+  size = (size + 7) & ~(size_t)7;
+  if (size > p->block_left) {
+    if (size > JSON_BLOCK_SIZE / 8) {
+      return malloc(size);
+    }
+    p->block = malloc(JSON_BLOCK_SIZE);
+    p->block_left = JSON_BLOCK_SIZE;
+  }
+  void *at = p->block;
+  p->block += size;
+  p->block_left -= size;
+  return at;
+}
+
+static void push(Parser *p, RuntimeObject *value) {
+  if (p->stack_size == p->stack_capacity) {
+    p->stack_capacity = p->stack_capacity == 0 ? 256 : 2 * p->stack_capacity;
+    p->stack = realloc(p->stack, p->stack_capacity * sizeof(RuntimeObject));
+  }
+  p->stack[p->stack_size++] = *value;
+}
+
+static void scratch_append(Parser *p, const char *bytes, size_t length) {
+  if (p->scratch_capacity - p->scratch_length < length) {
+    size_t capacity = p->scratch_capacity == 0 ? 256 : p->scratch_capacity;
+    while (capacity - p->scratch_length < length) {
+      capacity *= 2;
+    }
+    p->scratch = realloc(p->scratch, capacity);
+    p->scratch_capacity = capacity;
+  }
+  memcpy(p->scratch + p->scratch_length, bytes, length);
+  p->scratch_length += length;
+}
+
+// The first byte at or after at that ends a run of plain string contents: a
+// quote, a backslash or a control character. end if there is none.
+static const char *string_run_end(const char *at, const char *end) {
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1f);
+  for (; end - at >= 16; at += 16) {
+    __m128i bytes = _mm_loadu_si128((const __m128i *)at);
+    // min(b, 0x1f) == b exactly for the control characters
+    __m128i special = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(bytes, quote),
+                     _mm_cmpeq_epi8(bytes, backslash)),
+        _mm_cmpeq_epi8(_mm_min_epu8(bytes, control), bytes));
+    int mask = _mm_movemask_epi8(special);
+    if (mask != 0) {
+      return at + __builtin_ctz((unsigned)mask);
+    }
+  }
+#endif
+  while (at < end && (unsigned char)*at >= 0x20 && *at != '"' && *at != '\\') {
+    at++;
+  }
+  return at;
+}
+
+static int hex_digit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+// The four hex digits of a \u escape, p->at just past the u.
+static uint32_t parse_hex4(Parser *p) {
+  if (p->end - p->at < 4) {
+    parse_error(p, "invalid unicode escape");
+  }
+  uint32_t unit = 0;
+  for (int i = 0; i < 4; ++i) {
+    int digit = hex_digit(p->at[i]);
+    if (digit < 0) {
+      parse_error(p, "invalid unicode escape");
+    }
+    unit = unit << 4 | (uint32_t)digit;
+  }
+  p->at += 4;
+  return unit;
+}
+
+// Decodes a \u escape, and the low surrogate after it if it's a high one,
+// into UTF-8 on the scratch buffer.
+static void parse_unicode_escape(Parser *p) {
+  uint32_t code = parse_hex4(p);
+  if (code >= 0xdc00 && code <= 0xdfff) {
+    parse_error(p, "invalid unicode escape");
+  }
+  if (code >= 0xd800 && code <= 0xdbff) {
+    if (p->end - p->at < 2 || p->at[0] != '\\' || p->at[1] != 'u') {
+      parse_error(p, "invalid unicode escape");
+    }
+    p->at += 2;
+    uint32_t low = parse_hex4(p);
+    if (low < 0xdc00 || low > 0xdfff) {
+      parse_error(p, "invalid unicode escape");
+    }
+    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+  }
+  char utf8[4];
+  size_t length;
+  if (code < 0x80) {
+    utf8[0] = (char)code;
+    length = 1;
+  } else if (code < 0x800) {
+    utf8[0] = (char)(0xc0 | code >> 6);
+    utf8[1] = (char)(0x80 | (code & 0x3f));
+    length = 2;
+  } else if (code < 0x10000) {
+    utf8[0] = (char)(0xe0 | code >> 12);
+    utf8[1] = (char)(0x80 | (code >> 6 & 0x3f));
+    utf8[2] = (char)(0x80 | (code & 0x3f));
+    length = 3;
+  } else {
+    utf8[0] = (char)(0xf0 | code >> 18);
+    utf8[1] = (char)(0x80 | (code >> 12 & 0x3f));
+    utf8[2] = (char)(0x80 | (code >> 6 & 0x3f));
+    utf8[3] = (char)(0x80 | (code & 0x3f));
+    length = 4;
+  }
+  scratch_append(p, utf8, length);
+}
+
+static String *copy_string(Parser *p, const char *bytes, size_t length) {
+  String *str = carve(p, sizeof(String) + length + 1);
+  string_init(str, (char *)(str + 1), length);
+  memcpy(str->contents, bytes, length);
+  str->contents[length] = '\0';
+  return str;
+}
+
+// A string, p->at at its opening quote. Keys are looked up in the intern
+// table first, since the dict would intern them anyway.
+static String *parse_string(Parser *p, bool key) {
+  const char *start = ++p->at;
+  const char *run = string_run_end(start, p->end);
+  const char *bytes = start;
+  size_t length = (size_t)(run - start);
+  if (run < p->end && *run == '"') {
+    p->at = run + 1;
+  } else {
+    p->scratch_length = 0;
+    for (;;) {
+      scratch_append(p, p->at, (size_t)(run - p->at));
+      p->at = run;
+      if (p->at == p->end) {
+        parse_error(p, "unterminated string");
+      }
+      if (*p->at == '"') {
+        p->at++;
+        break;
+      }
+      if (*p->at != '\\') {
+        parse_error(p, "control character in string");
+      }
+      if (++p->at == p->end) {
+        parse_error(p, "unterminated string");
+      }
+      char escaped = *p->at++;
+      switch (escaped) {
+      case '"':
+      case '\\':
+      case '/':
+        scratch_append(p, &escaped, 1);
+        break;
+      case 'b':
+        scratch_append(p, "\b", 1);
+        break;
+      case 'f':
+        scratch_append(p, "\f", 1);
+        break;
+      case 'n':
+        scratch_append(p, "\n", 1);
+        break;
+      case 'r':
+        scratch_append(p, "\r", 1);
+        break;
+      case 't':
+        scratch_append(p, "\t", 1);
+        break;
+      case 'u':
+        parse_unicode_escape(p);
+        break;
+      default:
+        p->at--;
+        parse_error(p, "invalid escape");
+      }
+      run = string_run_end(p->at, p->end);
+    }
+    bytes = p->scratch;
+    length = p->scratch_length;
+  }
+  if (key) {
+    String view;
+    string_init(&view, (char *)bytes, length);
+    String *interned = str_intern_find(&view);
+    if (interned != NULL) {
+      return interned;
+    }
+    String *str = copy_string(p, bytes, length);
+    str->hash = view.hash;
+    return str;
+  }
+  return copy_string(p, bytes, length);
+}
+
+static void parse_literal(Parser *p, const char *word, size_t length) {
+  if ((size_t)(p->end - p->at) < length || memcmp(p->at, word, length) != 0) {
+    parse_error(p, "invalid value");
+  }
+  p->at += length;
+}
+
+static inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+// powers of ten that are exact as doubles
+static const double exact_powers[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/*
+ * A number. Up to 19 significant digits are gathered into an integer. An
+ * integer in range is the value; otherwise, when that integer and the power
+ * of ten are both exact as doubles, one multiplication or division gives the
+ * correctly rounded float. Anything else (long or extreme numbers) goes to
+ * strtod.
+ */
+static void parse_number(Parser *p, RuntimeObject *out) {
+  const char *start = p->at;
+  const char *at = p->at;
+  bool negative = *at == '-';
+  at += negative;
+  if (at == p->end || !is_digit(*at)) {
+    parse_error(p, "invalid value");
+  }
+
+  uint64_t mantissa = 0;
+  int digits = 0;       // significant digits in mantissa
+  int64_t exponent = 0; // of ten, applied to mantissa
+  bool truncated = false;
+  if (*at == '0') {
+    at++;
+  } else {
+    for (; at < p->end && is_digit(*at); ++at) {
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (uint64_t)(*at - '0');
+        digits++;
+      } else {
+        exponent++;
+        truncated = true;
+      }
+    }
+  }
+
+  bool integer = true;
+  if (at < p->end && *at == '.') {
+    integer = false;
+    if (++at == p->end || !is_digit(*at)) {
+      p->at = at;
+      parse_error(p, "invalid number");
+    }
+    for (; at < p->end && is_digit(*at); ++at) {
+      if (mantissa == 0 && *at == '0') {
+        exponent--; // leading zeros aren't significant
+      } else if (digits < 19) {
+        mantissa = mantissa * 10 + (uint64_t)(*at - '0');
+        digits++;
+        exponent--;
+      } else {
+        truncated = true;
+      }
+    }
+  }
+  if (at < p->end && (*at == 'e' || *at == 'E')) {
+    integer = false;
+    at++;
+    bool exponent_negative = false;
+    if (at < p->end && (*at == '+' || *at == '-')) {
+      exponent_negative = *at++ == '-';
+    }
+    if (at == p->end || !is_digit(*at)) {
+      p->at = at;
+      parse_error(p, "invalid number");
+    }
+    int64_t written = 0;
+    for (; at < p->end && is_digit(*at); ++at) {
+      if (written < 100000) {
+        written = written * 10 + (*at - '0');
+      }
+    }
+    exponent += exponent_negative ? -written : written;
+  }
+  p->at = at;
+
+  if (integer && !truncated &&
+      mantissa <= (uint64_t)INT64_MAX + (negative ? 1 : 0)) {
+    out->type = T_INT;
+    out->value.v_int = negative ? (int64_t)(0 - mantissa) : (int64_t)mantissa;
+    return;
+  }
+  double value;
+  if (!truncated && mantissa <= (1ull << 53) && exponent >= -22 &&
+      exponent <= 22) {
+    value = (double)mantissa;
+    value = exponent < 0 ? value / exact_powers[-exponent]
+                         : value * exact_powers[exponent];
+    value = negative ? -value : value;
+  } else {
+    char buffer[64];
+    size_t length = (size_t)(at - start);
+    char *copy = length < sizeof(buffer) ? buffer : malloc(length + 1);
+    memcpy(copy, start, length);
+    copy[length] = '\0';
+    value = strtod(copy, NULL);
+    if (copy != buffer) {
+      free(copy);
+    }
+  }
+  if (isinf(value)) {
+    p->at = start;
+    parse_error(p, "number out of range");
+  }
+  out->type = T_FLOAT;
+  out->value.v_float = value;
+}
+
+static void parse_value(Parser *p, RuntimeObject *out);
+
+// A vector of the count values on top of the stack, packed if they're all
+// ints or all floats.
+static Vector *make_array(Parser *p, RuntimeObject *elems, size_t count) {
+  // an empty vector is packed, like a new one
+  enum DataType packed = count == 0 ? T_INT : elems[0].type;
+  if (packed != T_INT && packed != T_FLOAT) {
+    packed = T_NOTHING;
+  }
+  for (size_t i = 1; i < count && packed != T_NOTHING; ++i) {
+    if (elems[i].type != packed) {
+      packed = T_NOTHING;
+    }
+  }
+  Vector *vec = carve(p, sizeof(Vector));
+  vec->size = count;
+  vec->internal_size = count;
+  vec->packed = packed;
+  vec->shared = false;
+  if (count == 0) {
+    vec->contents = NULL;
+  } else if (packed == T_INT) {
+    vec->ints = malloc(count * sizeof(int64_t));
+    for (size_t i = 0; i < count; ++i) {
+      vec->ints[i] = elems[i].value.v_int;
+    }
+  } else if (packed == T_FLOAT) {
+    vec->floats = malloc(count * sizeof(double));
+    for (size_t i = 0; i < count; ++i) {
+      vec->floats[i] = elems[i].value.v_float;
+    }
+  } else {
+    vec->contents = malloc(count * sizeof(RuntimeObject));
+    memcpy(vec->contents, elems, count * sizeof(RuntimeObject));
+  }
+  return vec;
+}
+
+static void enter(Parser *p) {
+  if (++p->depth > JSON_MAX_DEPTH) {
+    parse_error(p, "nesting too deep");
+  }
+  p->at++; // the opening bracket
+  skip_space(p);
+}
+
+static void parse_array(Parser *p, RuntimeObject *out) {
+  enter(p);
+  size_t base = p->stack_size;
+  if (p->at < p->end && *p->at == ']') {
+    p->at++;
+  } else {
+    for (;;) {
+      RuntimeObject value;
+      parse_value(p, &value);
+      push(p, &value);
+      skip_space(p);
+      if (p->at < p->end && *p->at == ',') {
+        p->at++;
+        continue;
+      }
+      expect(p, ']', "expected ',' or ']'");
+      break;
+    }
+  }
+  out->type = T_VECTOR;
+  out->value.v_vec = make_array(p, p->stack + base, p->stack_size - base);
+  p->stack_size = base;
+  p->depth--;
+}
+
+static void parse_object(Parser *p, RuntimeObject *out) {
+  enter(p);
+  size_t base = p->stack_size;
+  if (p->at < p->end && *p->at == '}') {
+    p->at++;
+  } else {
+    for (;;) {
+      if (p->at == p->end || *p->at != '"') {
+        parse_error(p, "expected a string key");
+      }
+      RuntimeObject key = {.type = T_STRING};
+      key.value.v_str = parse_string(p, true);
+      push(p, &key);
+      expect(p, ':', "expected ':'");
+      RuntimeObject value;
+      parse_value(p, &value);
+      push(p, &value);
+      skip_space(p);
+      if (p->at < p->end && *p->at == ',') {
+        p->at++;
+        skip_space(p);
+        continue;
+      }
+      expect(p, '}', "expected ',' or '}'");
+      break;
+    }
+  }
+  // a repeated key keeps its first position and its last value
+  size_t count = (p->stack_size - base) / 2;
+  Dict *dict = carve(p, sizeof(Dict));
+  dict_init(dict, count);
+  RuntimeObject *values = carve(p, count * sizeof(RuntimeObject));
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = p->stack[base + 2 * i + 1];
+    dict_set(dict, &p->stack[base + 2 * i], &values[i]);
+  }
+  out->type = T_DICT;
+  out->value.v_dict = dict;
+  p->stack_size = base;
+  p->depth--;
+}
+
+static void parse_value(Parser *p, RuntimeObject *out) {
+  skip_space(p);
+  if (p->at == p->end) {
+    parse_error(p, "unexpected end of input");
+  }
+  switch (*p->at) {
+  case '{':
+    parse_object(p, out);
+    return;
+  case '[':
+    parse_array(p, out);
+    return;
+  case '"':
+    out->type = T_STRING;
+    out->value.v_str = parse_string(p, false);
+    return;
+  case 't':
+    parse_literal(p, "true", 4);
+    out->type = T_BOOL;
+    out->value.v_bool = true;
+    return;
+  case 'f':
+    parse_literal(p, "false", 5);
+    out->type = T_BOOL;
+    out->value.v_bool = false;
+    return;
+  case 'n':
+    parse_literal(p, "null", 4);
+    out->type = T_NOTHING;
+    out->value.v_bool = false;
+    return;
+  default:
+    parse_number(p, out);
+  }
+}
+
+RuntimeObject *builtin_json_parse(RuntimeObject *text) {
+  if (text->type != T_STRING) {
+    runtime_error("json_parse() needs a string.");
+  }
+  String *str = text->value.v_str;
+  Parser p = {.text = str->contents,
+              .at = str->contents,
+              .end = str->contents + str->length};
+  RuntimeObject value;
+  parse_value(&p, &value);
+  skip_space(&p);
+  if (p.at != p.end) {
+    parse_error(&p, "unexpected text after the value");
+  }
+  free(p.stack);
+  free(p.scratch);
+  return make_object_copy(&value);
+}
+
+// json_dump's output as it's written
+typedef struct {
+  char *bytes;
+  size_t length, capacity;
+} JsonText;
+
+static void text_append(JsonText *text, const char *bytes, size_t length) {
+  // room for the bytes and the terminating '\0'
+  if (text->capacity - text->length <= length) {
+    size_t capacity = text->capacity == 0 ? 256 : text->capacity;
+    while (capacity - text->length <= length) {
+      capacity *= 2;
+    }
+    text->bytes = realloc(text->bytes, capacity);
+    text->capacity = capacity;
+  }
+  memcpy(text->bytes + text->length, bytes, length);
+  text->length += length;
+}
+
+static void dump_string(JsonText *text, const char *bytes, size_t length) {
+  const char *end = bytes + length;
+  text_append(text, "\"", 1);
+  for (;;) {
+    const char *run = string_run_end(bytes, end);
+    text_append(text, bytes, (size_t)(run - bytes));
+    if (run == end) {
+      break;
+    }
+    char c = *run;
+    char escape[8] = {'\\', c};
+    size_t escape_length = 2;
+    switch (c) {
+    case '"':
+    case '\\':
+      break;
+    case '\b':
+      escape[1] = 'b';
+      break;
+    case '\f':
+      escape[1] = 'f';
+      break;
+    case '\n':
+      escape[1] = 'n';
+      break;
+    case '\r':
+      escape[1] = 'r';
+      break;
+    case '\t':
+      escape[1] = 't';
+      break;
+    default:
+      escape_length = (size_t)snprintf(escape, sizeof(escape), "\\u%04x",
+                                       (unsigned)(unsigned char)c);
+    }
+    text_append(text, escape, escape_length);
+    bytes = run + 1;
+  }
+  text_append(text, "\"", 1);
+}
+
+static void dump_value(JsonText *text, RuntimeObject *value, size_t depth) {
+  char buffer[FORMAT_FLOAT_MAX];
+  switch (value->type) {
+  case T_NOTHING:
+    text_append(text, "null", 4);
+    return;
+  case T_BOOL:
+    if (value->value.v_bool) {
+      text_append(text, "true", 4);
+    } else {
+      text_append(text, "false", 5);
+    }
+    return;
+  case T_INT:
+    text_append(text, buffer, format_int(buffer, value->value.v_int));
+    return;
+  case T_FLOAT:
+    if (!isfinite(value->value.v_float)) {
+      runtime_error("json_dump() can't write nan or inf.");
+    }
+    text_append(text, buffer, format_float(buffer, value->value.v_float));
+    return;
+  case T_STRING:
+    dump_string(text, value->value.v_str->contents, value->value.v_str->length);
+    return;
+  default:
+    break;
+  }
+
+  // a dict can hold itself, so containers count towards a limit
+  if (depth == JSON_MAX_DEPTH) {
+    runtime_error("json_dump(): nesting too deep.");
+  }
+  if (value->type == T_VECTOR) {
+    Vector *vec = value->value.v_vec;
+    text_append(text, "[", 1);
+    for (size_t i = 0; i < vec->size; ++i) {
+      if (i > 0) {
+        text_append(text, ",", 1);
+      }
+      RuntimeObject elem;
+      vec_get(vec, i, &elem);
+      dump_value(text, &elem, depth + 1);
+    }
+    text_append(text, "]", 1);
+  } else if (value->type == T_DICT) {
+    Dict *dict = value->value.v_dict;
+    text_append(text, "{", 1);
+    bool first = true;
+    for (size_t i = 0; i < dict->used; ++i) {
+      DictEntry *entry = &dict->entries[i];
+      if (entry->value == NULL) {
+        continue; // removed
+      }
+      if (entry->key.type != T_STRING) {
+        runtime_error("json_dump() needs string dict keys.");
+      }
+      if (!first) {
+        text_append(text, ",", 1);
+      }
+      first = false;
+      String *key = entry->key.value.v_str;
+      dump_string(text, key->contents, key->length);
+      text_append(text, ":", 1);
+      dump_value(text, entry->value, depth + 1);
+    }
+    text_append(text, "}", 1);
+  } else {
+    runtime_error("json_dump() can't write functions, modules or bytes.");
+  }
+}
+
+RuntimeObject *builtin_json_dump(RuntimeObject *value) {
+  JsonText text = {NULL, 0, 0};
+  dump_value(&text, value, 0);
+  text.bytes[text.length] = '\0';
+  return make_string_from_raw(make_string_length_raw(text.bytes, text.length));
+}
@@ -0,0 +1,456 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "numfmt.h"
+
+/*
+ * Integers are written two digits at a time from a table of "00" to "99".
+ *
+ * Floats are written with Grisu2 (Loitsch, "Printing Floating-Point Numbers
+ * Quickly and Accurately with Integers", PLDI 2010): the double and the
+ * boundaries of the interval of reals that round to it are scaled by a cached
+ * power of ten into a 64-bit fixed point range, and digits are generated
+ * until the result is inside the interval. The digits always read back as the
+ * same double. For about one double in a thousand the scaling error hides
+ * digits one shorter; those cases are spotted while generating the digits
+ * and checked with the C library.
+ *
+ * The digits are laid out like Python's repr: positional notation for
+ * exponents from -4 up to 15, with ".0" after integral values, and scientific
+ * notation ("1e+16", "2.5e-07") outside that range.
+ */
+
+static const char digit_pairs[201] = "00010203040506070809"
+                                     "10111213141516171819"
+                                     "20212223242526272829"
+                                     "30313233343536373839"
+                                     "40414243444546474849"
+                                     "50515253545556575859"
+                                     "60616263646566676869"
+                                     "70717273747576777879"
+                                     "80818283848586878889"
+                                     "90919293949596979899";
+
+static size_t count_digits(uint64_t value) {
+  size_t digits = 1;
+  for (;;) {
+    if (value < 10) {
+      return digits;
+    }
+    if (value < 100) {
+      return digits + 1;
+    }
+    if (value < 1000) {
+      return digits + 2;
+    }
+    if (value < 10000) {
+      return digits + 3;
+    }
+    value /= 10000;
+    digits += 4;
+  }
+}
+
+// Write the digits of value ending just before end.
+static void write_digits(char *end, uint64_t value) {
+  while (value >= 100) {
+    const char *pair = &digit_pairs[2 * (value % 100)];
+    value /= 100;
+    *--end = pair[1];
+    *--end = pair[0];
+  }
+  if (value >= 10) {
+    *--end = digit_pairs[2 * value + 1];
+    *--end = digit_pairs[2 * value];
+  } else {
+    *--end = (char)('0' + value);
+  }
+}
+
+size_t format_int(char *out, int64_t value) {
+  size_t length = 0;
+  uint64_t magnitude = (uint64_t)value;
+  if (value < 0) {
+    out[length++] = '-';
+    magnitude = 0 - magnitude;
+  }
+  length += count_digits(magnitude);
+  write_digits(out + length, magnitude);
+  out[length] = '\0';
+  return length;
+}
+
+// f * 2^e
+typedef struct {
+  uint64_t f;
+  int e;
+} DiyFp;
+
+static DiyFp diy_sub(DiyFp x, DiyFp y) { return (DiyFp){x.f - y.f, x.e}; }
+
+// x * y, rounded to the upper 64 bits of the product
+static DiyFp diy_mul(DiyFp x, DiyFp y) {
+  unsigned __int128 product = (unsigned __int128)x.f * y.f;
+  uint64_t high = (uint64_t)(product >> 64);
+  uint64_t low = (uint64_t)product;
+  return (DiyFp){high + (low >> 63), x.e + y.e + 64};
+}
+
+static DiyFp diy_normalize(DiyFp x) {
+  int shift = __builtin_clzll(x.f);
+  return (DiyFp){x.f << shift, x.e - shift};
+}
+
+// The normalized double, and the normalized boundaries m- and m+ halfway to
+// its neighbours, with m- scaled to the exponent of m+.
+static void float_boundaries(double value, DiyFp *w, DiyFp *minus,
+                             DiyFp *plus) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint64_t hidden_bit = (uint64_t)1 << 52;
+  uint64_t fraction = bits & (hidden_bit - 1);
+  int biased_exponent = (int)(bits >> 52);
+  DiyFp v = biased_exponent == 0
+                ? (DiyFp){fraction, 1 - 1075}
+                : (DiyFp){fraction + hidden_bit, biased_exponent - 1075};
+
+  // at a power of two the next double down is half as far as the next up
+  bool lower_closer = fraction == 0 && biased_exponent > 1;
+  DiyFp upper = {2 * v.f + 1, v.e - 1};
+  DiyFp lower = lower_closer ? (DiyFp){4 * v.f - 1, v.e - 2}
+                             : (DiyFp){2 * v.f - 1, v.e - 1};
+  *plus = diy_normalize(upper);
+  *minus = (DiyFp){lower.f << (lower.e - plus->e), plus->e};
+  *w = diy_normalize(v);
+}
+
+typedef struct {
+  uint64_t f;
+  int e;
+  int k;
+} CachedPower;
+
+// 10^k for k = -300, -292, ..., 324, rounded to 64 bits: f * 2^e
+static const CachedPower cached_powers[] = {
+    {0xAB70FE17C79AC6CAULL, -1060, -300},
+    {0xFF77B1FCBEBCDC4FULL, -1034, -292},
+    {0xBE5691EF416BD60CULL, -1007, -284},
+    {0x8DD01FAD907FFC3CULL, -980, -276},
+    {0xD3515C2831559A83ULL, -954, -268},
+    {0x9D71AC8FADA6C9B5ULL, -927, -260},
+    {0xEA9C227723EE8BCBULL, -901, -252},
+    {0xAECC49914078536DULL, -874, -244},
+    {0x823C12795DB6CE57ULL, -847, -236},
+    {0xC21094364DFB5637ULL, -821, -228},
+    {0x9096EA6F3848984FULL, -794, -220},
+    {0xD77485CB25823AC7ULL, -768, -212},
+    {0xA086CFCD97BF97F4ULL, -741, -204},
+    {0xEF340A98172AACE5ULL, -715, -196},
+    {0xB23867FB2A35B28EULL, -688, -188},
+    {0x84C8D4DFD2C63F3BULL, -661, -180},
+    {0xC5DD44271AD3CDBAULL, -635, -172},
+    {0x936B9FCEBB25C996ULL, -608, -164},
+    {0xDBAC6C247D62A584ULL, -582, -156},
+    {0xA3AB66580D5FDAF6ULL, -555, -148},
+    {0xF3E2F893DEC3F126ULL, -529, -140},
+    {0xB5B5ADA8AAFF80B8ULL, -502, -132},
+    {0x87625F056C7C4A8BULL, -475, -124},
+    {0xC9BCFF6034C13053ULL, -449, -116},
+    {0x964E858C91BA2655ULL, -422, -108},
+    {0xDFF9772470297EBDULL, -396, -100},
+    {0xA6DFBD9FB8E5B88FULL, -369, -92},
+    {0xF8A95FCF88747D94ULL, -343, -84},
+    {0xB94470938FA89BCFULL, -316, -76},
+    {0x8A08F0F8BF0F156BULL, -289, -68},
+    {0xCDB02555653131B6ULL, -263, -60},
+    {0x993FE2C6D07B7FACULL, -236, -52},
+    {0xE45C10C42A2B3B06ULL, -210, -44},
+    {0xAA242499697392D3ULL, -183, -36},
+    {0xFD87B5F28300CA0EULL, -157, -28},
+    {0xBCE5086492111AEBULL, -130, -20},
+    {0x8CBCCC096F5088CCULL, -103, -12},
+    {0xD1B71758E219652CULL, -77, -4},
+    {0x9C40000000000000ULL, -50, 4},
+    {0xE8D4A51000000000ULL, -24, 12},
+    {0xAD78EBC5AC620000ULL, 3, 20},
+    {0x813F3978F8940984ULL, 30, 28},
+    {0xC097CE7BC90715B3ULL, 56, 36},
+    {0x8F7E32CE7BEA5C70ULL, 83, 44},
+    {0xD5D238A4ABE98068ULL, 109, 52},
+    {0x9F4F2726179A2245ULL, 136, 60},
+    {0xED63A231D4C4FB27ULL, 162, 68},
+    {0xB0DE65388CC8ADA8ULL, 189, 76},
+    {0x83C7088E1AAB65DBULL, 216, 84},
+    {0xC45D1DF942711D9AULL, 242, 92},
+    {0x924D692CA61BE758ULL, 269, 100},
+    {0xDA01EE641A708DEAULL, 295, 108},
+    {0xA26DA3999AEF774AULL, 322, 116},
+    {0xF209787BB47D6B85ULL, 348, 124},
+    {0xB454E4A179DD1877ULL, 375, 132},
+    {0x865B86925B9BC5C2ULL, 402, 140},
+    {0xC83553C5C8965D3DULL, 428, 148},
+    {0x952AB45CFA97A0B3ULL, 455, 156},
+    {0xDE469FBD99A05FE3ULL, 481, 164},
+    {0xA59BC234DB398C25ULL, 508, 172},
+    {0xF6C69A72A3989F5CULL, 534, 180},
+    {0xB7DCBF5354E9BECEULL, 561, 188},
+    {0x88FCF317F22241E2ULL, 588, 196},
+    {0xCC20CE9BD35C78A5ULL, 614, 204},
+    {0x98165AF37B2153DFULL, 641, 212},
+    {0xE2A0B5DC971F303AULL, 667, 220},
+    {0xA8D9D1535CE3B396ULL, 694, 228},
+    {0xFB9B7CD9A4A7443CULL, 720, 236},
+    {0xBB764C4CA7A44410ULL, 747, 244},
+    {0x8BAB8EEFB6409C1AULL, 774, 252},
+    {0xD01FEF10A657842CULL, 800, 260},
+    {0x9B10A4E5E9913129ULL, 827, 268},
+    {0xE7109BFBA19C0C9DULL, 853, 276},
+    {0xAC2820D9623BF429ULL, 880, 284},
+    {0x80444B5E7AA7CF85ULL, 907, 292},
+    {0xBF21E44003ACDD2DULL, 933, 300},
+    {0x8E679C2F5E44FF8FULL, 960, 308},
+    {0xD433179D9C8CB841ULL, 986, 316},
+    {0x9E19DB92B4E31BA9ULL, 1013, 324},
+};
+
+#define CACHED_POWERS_MIN_K -300
+#define CACHED_POWERS_STEP 8
+
+// The scaled products are kept with a binary exponent in [ALPHA, GAMMA], so
+// that their integral part fits in 32 bits.
+#define ALPHA -60
+#define GAMMA -32
+
+// A cached power c with ALPHA <= e + c.e + 64 <= GAMMA.
+static CachedPower cached_power_for(int e) {
+  // ceil((ALPHA - e - 1) * log10(2)), 78913 / 2^18 being about log10(2)
+  int f = ALPHA - e - 1;
+  int k = (f * 78913) / (1 << 18) + (f > 0);
+  int index = (-CACHED_POWERS_MIN_K + k + (CACHED_POWERS_STEP - 1)) /
+              CACHED_POWERS_STEP;
+  return cached_powers[index];
+}
+
+// The largest power of ten at most n (n > 0), and its number of digits.
+static int largest_pow10(uint32_t n, uint32_t *pow10) {
+  static const uint32_t powers[] = {1,         10,        100,     1000,
+                                    10000,     100000,    1000000, 10000000,
+                                    100000000, 1000000000};
+  int digits = 10;
+  while (digits > 1 && n < powers[digits - 1]) {
+    digits--;
+  }
+  *pow10 = powers[digits - 1];
+  return digits;
+}
+
+// Move the last digit towards w while it stays inside the interval and gets
+// closer to w. dist is the distance from the upper boundary to w, delta the
+// width of the interval, rest the distance from the upper boundary to the
+// digits, and ten_k the value of one unit in the last digit.
+static void round_towards(char *digits, int length, uint64_t dist,
+                          uint64_t delta, uint64_t rest, uint64_t ten_k) {
+  while (rest < dist && delta - rest >= ten_k &&
+         (rest + ten_k < dist || dist - rest > rest + ten_k - dist)) {
+    digits[length - 1]--;
+    rest += ten_k;
+  }
+}
+
+// The digits of the shortest decimal in [minus, plus], as close as possible
+// to w, and its exponent: the value is digits * 10^exponent. The three are
+// already scaled, with plus.e in [ALPHA, GAMMA].
+//
+// The scaling leaves each end of the interval off by up to one unit, so
+// minus and plus are taken one unit inside it, and *shorter is set to the
+// length of the first shorter digits that would be inside if they were taken
+// one unit outside it instead (or 0): those might read back as the double as
+// well.
+static int generate_digits(char *digits, int *exponent, int *shorter,
+                           DiyFp minus, DiyFp w, DiyFp plus) {
+  minus.f++;
+  plus.f--;
+  uint64_t delta = diy_sub(plus, minus).f;
+  uint64_t dist = diy_sub(plus, w).f;
+  DiyFp one = {(uint64_t)1 << -plus.e, plus.e};
+  uint32_t integral = (uint32_t)(plus.f >> -one.e);
+  uint64_t fractional = plus.f & (one.f - 1);
+  // two units, in the scale of rest and delta: moving both ends out by one
+  // unit moves plus out by two and widens the interval by four
+  uint64_t slack = 2;
+
+  *exponent = 0;
+  *shorter = 0;
+  int length = 0;
+  uint32_t pow10;
+  int n = largest_pow10(integral, &pow10);
+  while (n > 0) {
+    digits[length++] = (char)('0' + integral / pow10);
+    integral %= pow10;
+    n--;
+    uint64_t rest = ((uint64_t)integral << -one.e) + fractional;
+    uint64_t ten_k = (uint64_t)pow10 << -one.e;
+    if (rest <= delta) {
+      *exponent += n;
+      round_towards(digits, length, dist, delta, rest, ten_k);
+      return length;
+    }
+    if (*shorter == 0 && (rest - delta <= slack || ten_k - rest <= slack)) {
+      *shorter = length;
+    }
+    pow10 /= 10;
+  }
+
+  int m = 0;
+  for (;;) {
+    fractional *= 10;
+    digits[length++] = (char)('0' + (fractional >> -one.e));
+    fractional &= one.f - 1;
+    m++;
+    delta *= 10;
+    dist *= 10;
+    // past one.f every position counts as ambiguous, which is only slower
+    slack = slack < one.f ? slack * 10 : slack;
+    if (fractional <= delta) {
+      break;
+    }
+    if (*shorter == 0 &&
+        (fractional - delta <= slack || one.f - fractional <= slack)) {
+      *shorter = length;
+    }
+  }
+  *exponent -= m;
+  round_towards(digits, length, dist, delta, fractional, one.f);
+  return length;
+}
+
+// The digits of value rounded to length significant digits by the C
+// library, if they read back as value, or 0.
+static int exact_digits(double value, int length, char *digits,
+                        int *exponent) {
+  char buffer[FORMAT_FLOAT_MAX];
+  snprintf(buffer, sizeof(buffer), "%.*e", length - 1, value);
+  if (strtod(buffer, NULL) != value) {
+    return 0;
+  }
+  // d.ddde+xx
+  int n = 0;
+  const char *c = buffer;
+  for (; *c != 'e'; ++c) {
+    if (*c != '.') {
+      digits[n++] = *c;
+    }
+  }
+  while (n > 1 && digits[n - 1] == '0') {
+    n--;
+  }
+  *exponent = atoi(c + 1) - (n - 1);
+  return n;
+}
+
+// The shortest digits of value (positive and finite) and their exponent.
+static int shortest_digits(double value, char *digits, int *exponent) {
+  DiyFp w, minus, plus;
+  float_boundaries(value, &w, &minus, &plus);
+  CachedPower cached = cached_power_for(plus.e);
+  DiyFp c = {cached.f, cached.e};
+  w = diy_mul(w, c);
+  minus = diy_mul(minus, c);
+  plus = diy_mul(plus, c);
+
+  int shorter;
+  int length = generate_digits(digits, exponent, &shorter, minus, w, plus);
+  *exponent -= cached.k;
+  // rare enough to leave to exact arithmetic in the C library
+  if (shorter > 0) {
+    char exact[FORMAT_FLOAT_MAX];
+    int exact_exponent;
+    int exact_length = exact_digits(value, shorter, exact, &exact_exponent);
+    if (exact_length > 0) {
+      memcpy(digits, exact, exact_length);
+      *exponent = exact_exponent;
+      return exact_length;
+    }
+  }
+  return length;
+}
+
+// digits * 10^exponent, laid out like Python's repr
+static size_t layout(char *out, const char *digits, int length,
+                     int exponent) {
+  size_t n = 0;
+  // where the decimal point goes, counted from the first digit
+  int point = length + exponent;
+  if (point > -4 && point <= 16) {
+    if (point <= 0) {
+      out[n++] = '0';
+      out[n++] = '.';
+      for (int i = point; i < 0; ++i) {
+        out[n++] = '0';
+      }
+      memcpy(out + n, digits, length);
+      n += length;
+    } else if (point < length) {
+      memcpy(out + n, digits, point);
+      n += point;
+      out[n++] = '.';
+      memcpy(out + n, digits + point, length - point);
+      n += length - point;
+    } else {
+      memcpy(out + n, digits, length);
+      n += length;
+      for (int i = length; i < point; ++i) {
+        out[n++] = '0';
+      }
+      out[n++] = '.';
+      out[n++] = '0';
+    }
+  } else {
+    out[n++] = digits[0];
+    if (length > 1) {
+      out[n++] = '.';
+      memcpy(out + n, digits + 1, length - 1);
+      n += length - 1;
+    }
+    int scientific = point - 1;
+    out[n++] = 'e';
+    out[n++] = scientific < 0 ? '-' : '+';
+    scientific = scientific < 0 ? -scientific : scientific;
+    size_t width = scientific < 10 ? 2 : count_digits((uint64_t)scientific);
+    write_digits(out + n + width, (uint64_t)scientific);
+    if (scientific < 10) {
+      out[n] = '0';
+    }
+    n += width;
+  }
+  out[n] = '\0';
+  return n;
+}
+
+size_t format_float(char *out, double value) {
+  if (isnan(value)) {
+    memcpy(out, "nan", 4);
+    return 3;
+  }
+  size_t sign = 0;
+  if (signbit(value)) {
+    out[sign++] = '-';
+    value = -value;
+  }
+  if (isinf(value)) {
+    memcpy(out + sign, "inf", 4);
+    return sign + 3;
+  }
+  if (value == 0.0) {
+    memcpy(out + sign, "0.0", 4);
+    return sign + 3;
+  }
+  char digits[FORMAT_FLOAT_MAX];
+  int exponent;
+  int length = shortest_digits(value, digits, &exponent);
+  return sign + layout(out + sign, digits, length, exponent);
+}
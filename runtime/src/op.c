@@ -7,6 +7,7 @@
 
 #include "datatype.h"
 #include "dictionary.h"
+#include "numfmt.h"
 #include "rtutil.h"
 #include "runtime.h"
 
@@ -377,11 +378,15 @@ bool vector_equality_comparison(Vector *lhs, Vector *rhs) {
 
   // otherwise, do an equality comparison for every element, recursively
   // checking any sub-vectors in the same way
+  if (lhs->packed == T_INT && rhs->packed == T_INT) {
+    return memcmp(lhs->ints, rhs->ints, lhs->size * sizeof(int64_t)) == 0;
+  }
   for (size_t i = 0; i < lhs->size; ++i) {
-    RuntimeObject *lhs_elem = &lhs->contents[i];
-    RuntimeObject *rhs_elem = &rhs->contents[i];
+    RuntimeObject lhs_elem, rhs_elem;
+    vec_get(lhs, i, &lhs_elem);
+    vec_get(rhs, i, &rhs_elem);
 
-    if (!equality_comparison(lhs_elem, rhs_elem)) {
+    if (!equality_comparison(&lhs_elem, &rhs_elem)) {
       return false;
     }
   }
@@ -405,16 +410,13 @@ bool dict_equality_comparison(Dict *lhs, Dict *rhs) {
   // otherwise, check that each key-value pair in the left dict matches
   // the right dict. Since we checked the sizes, if we don't fail any
   // equality checks then they're equal.
-  Vector *lhs_keys = dict_keys_raw(lhs)->value.v_vec;
-
-  for (size_t i = 0; i < lhs_keys->size; ++i) {
-    RuntimeObject *key = &lhs_keys->contents[i];
-    String *key_hash = get_dict_key(key);
-
-    RuntimeObject *lhs_result = dict_get(lhs, key_hash->contents);
-    RuntimeObject *rhs_result = dict_get(rhs, key_hash->contents);
-
-    if (!equality_comparison(lhs_result, rhs_result)) {
+  for (size_t i = 0; i < lhs->used; ++i) {
+    DictEntry *entry = &lhs->entries[i];
+    if (entry->value == NULL) {
+      continue; // removed
+    }
+    RuntimeObject *rhs_result = dict_get(rhs, &entry->key);
+    if (rhs_result == NULL || !equality_comparison(entry->value, rhs_result)) {
       return false;
     }
   }
@@ -441,9 +443,7 @@ bool equality_comparison(RuntimeObject *lhs, RuntimeObject *rhs) {
     return lhs->value.v_bool == rhs->value.v_bool;
   }
   case T_STRING: {
-    char *lhs_str = lhs->value.v_str->contents;
-    char *rhs_str = rhs->value.v_str->contents;
-    return strcmp(lhs_str, rhs_str) == 0;
+    return str_equal(lhs->value.v_str, rhs->value.v_str);
   }
   case T_VECTOR: {
     return vector_equality_comparison(lhs->value.v_vec, rhs->value.v_vec);
@@ -451,6 +451,11 @@ bool equality_comparison(RuntimeObject *lhs, RuntimeObject *rhs) {
   case T_DICT: {
     return dict_equality_comparison(lhs->value.v_dict, rhs->value.v_dict);
   }
+  case T_BYTES: {
+    Bytes *lhs_bytes = lhs->value.v_bytes, *rhs_bytes = rhs->value.v_bytes;
+    return lhs_bytes->length == rhs_bytes->length &&
+           memcmp(lhs_bytes->data, rhs_bytes->data, lhs_bytes->length) == 0;
+  }
   case T_FUNCTION:
     runtime_error("Equality Comparison not supported for function type");
   case T_MODULE:
@@ -462,77 +467,21 @@ bool equality_comparison(RuntimeObject *lhs, RuntimeObject *rhs) {
 }
 
 RuntimeObject *_str_concat(String *lhs, RuntimeObject *rhs) {
-  char rhs_buffer[256] = "nothing";
-  char *rhs_string = rhs_buffer;
+  char buffer[FORMAT_FLOAT_MAX];
   switch (rhs->type) {
-  case T_NOTHING:
-    break;
-  case T_BOOL:
-    if (rhs->value.v_bool) {
-      strcpy(rhs_string, STRING_TRUE);
-    } else {
-      strcpy(rhs_string, STRING_FALSE);
-    }
-    break;
-  case T_FLOAT:
-    snprintf(rhs_buffer, sizeof(rhs_buffer), "%.1f", rhs->value.v_float);
-    break;
   case T_INT:
-    snprintf(rhs_buffer, sizeof(rhs_buffer), "%lld", rhs->value.v_int);
-    break;
-  case T_STRING:
-    rhs_string = rhs->value.v_str->contents;
-    break;
-  case T_VECTOR: {
-    // start a string accumulator, with an opening bracket
-    RuntimeObject *acc = _str_concat(lhs, make_string("["));
-
-    size_t length = rhs->value.v_vec->size;
-    RuntimeObject *vec = rhs->value.v_vec->contents;
-
-    for (size_t i = 0; i < length; ++i) {
-      RuntimeObject *elem = &vec[i];
-
-      // check if elem is a string
-      bool is_str = elem->type == T_STRING;
-
-      // add opening quote if string
-      if (is_str) {
-        acc = _str_concat(acc->value.v_str, make_string("\""));
-      }
-
-      acc = _str_concat(acc->value.v_str, elem);
-
-      // add closing quote if string
-      if (is_str) {
-        acc = _str_concat(acc->value.v_str, make_string("\""));
-      }
-
-      // add comma separator unless we're on the last element
-      if (i != length - 1) {
-        acc = _str_concat(acc->value.v_str, make_string(", "));
-      }
-    }
-
-    // add the closing bracket and then return
-    acc = _str_concat(acc->value.v_str, make_string("]"));
-    return acc;
-    break;
-  }
-  case T_DICT: {
-    String *rhs_string = to_string_raw(rhs);
-    String *acc = str_concat_raw(lhs, rhs_string);
-    return make_string_nocopy(acc->contents);
-    break;
-  }
+    return str_append(lhs, buffer, format_int(buffer, rhs->value.v_int));
+  case T_FLOAT:
+    return str_append(lhs, buffer, format_float(buffer, rhs->value.v_float));
   case T_MODULE:
   case T_FUNCTION:
-    strcpy(rhs_string, "NOT_IMPLEMENTED");
-    break;
+    return str_append(lhs, "NOT_IMPLEMENTED", strlen("NOT_IMPLEMENTED"));
+  default: {
+    // strings are appended as they are, without a copy
+    String *rhs_str = to_string_raw(rhs);
+    return str_append(lhs, rhs_str->contents, rhs_str->length);
+  }
   }
-
-  char *new_str = strdupcat(lhs->contents, rhs_string);
-  return make_string_nocopy(new_str);
 }
 
 RuntimeObject *op_add(RuntimeObject *lhs, RuntimeObject *rhs) {
@@ -0,0 +1,74 @@
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "rtutil.h"
+
+/*
+ * Buffered standard output. Everything print and write output goes into one
+ * large buffer, which is written out with a single system call when it fills
+ * up, when the program exits and when it calls flush(), rather than a few
+ * stdio calls per printed line or vector element. When stdout is a terminal
+ * every print and write is flushed, so that output still shows up as it
+ * happens, prompts included.
+ */
+
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+
+static struct {
+  char data[OUTPUT_BUFFER_SIZE];
+  size_t used;
+  bool ready;
+  bool interactive;
+} output;
+
+static void write_all(const char *bytes, size_t length) {
+  while (length > 0) {
+    ssize_t written = write(STDOUT_FILENO, bytes, length);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // nowhere to report it, like a failed printf
+      return;
+    }
+    bytes += written;
+    length -= (size_t)written;
+  }
+}
+
+void output_flush() {
+  write_all(output.data, output.used);
+  output.used = 0;
+}
+
+static void output_init() {
+  output.interactive = isatty(STDOUT_FILENO);
+  atexit(output_flush);
+  output.ready = true;
+}
+
+void output_write(const char *bytes, size_t length) {
+  if (!output.ready) {
+    output_init();
+  }
+  if (length > OUTPUT_BUFFER_SIZE - output.used) {
+    output_flush();
+    // no point copying what would fill the buffer by itself
+    if (length >= OUTPUT_BUFFER_SIZE) {
+      write_all(bytes, length);
+      return;
+    }
+  }
+  memcpy(output.data + output.used, bytes, length);
+  output.used += length;
+}
+
+// The end of a print or write: on a terminal it's shown right away.
+void output_end() {
+  if (output.interactive) {
+    output_flush();
+  }
+}
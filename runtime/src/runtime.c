@@ -2,37 +2,22 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 
 #include "datatype.h"
 #include "dictionary.h"
+#include "numfmt.h"
 #include "rtutil.h"
 #include "runtime.h"
 
 RuntimeSymbolTableEntry *runtime_st_lookup(RuntimeSymbolTable *st,
                                            char *identifier);
 
-String *get_dict_key(RuntimeObject *key) {
-  char *type_id = NULL;
-  switch (key->type) {
-  case T_BOOL:
-    type_id = "bool:";
-  case T_FLOAT:
-    type_id = "float:";
-    break;
-  case T_INT:
-    type_id = "int:";
-    break;
-  case T_STRING:
-    type_id = "string:";
-    break;
-  default: {
-    runtime_error("Unhashable type used for dictionary key");
-  }
-  }
-
-  return str_concat_raw(make_string_raw(type_id), to_string_raw(key));
-}
+// Result of reading a missing dict key. Shared: assignment rebinds a variable,
+// module member or element to the new object rather than writing into the old
+// one (see field_access_lvalue), so nothing can change it.
+static RuntimeObject missing_key_value = {.type = T_NOTHING};
 
 RuntimeObject *dynamic_function_call(RuntimeObject *dynamic_fn, size_t argc,
                                      RuntimeObject *argv[]) {
@@ -40,52 +25,261 @@ RuntimeObject *dynamic_function_call(RuntimeObject *dynamic_fn, size_t argc,
     runtime_error("Invalid type for dynamic function call.");
   }
 
-  Function fn = dynamic_fn->value.v_func;
-  return fn.fn_ptr(argc, argv);
+  Function *fn = dynamic_fn->value.v_func;
+  return fn->fn_ptr(argc, argv);
 }
 
+/*
+ * Implements x.y(...) when x is only known at runtime. argv[0] is the
+ * receiver, which builtin type methods take as their first parameter. Module
+ * members are plain functions, so it is dropped for those.
+ */
+RuntimeObject *dynamic_method_call(RuntimeObject *self, char *identifier,
+                                   size_t argc, RuntimeObject *argv[]) {
+  RuntimeObject *method = field_access(self, identifier);
+  if (self->type == T_MODULE) {
+    return dynamic_function_call(method, argc - 1, argv + 1);
+  }
+  return dynamic_function_call(method, argc, argv);
+}
+
+/*
+ * Methods of the built-in data types. These are static so that looking one up
+ * doesn't allocate; the code generator calls the non-dynamic versions directly
+ * whenever it can, so this is only the fallback.
+ */
+#define BUILTIN_METHOD(ID, FN)                                                 \
+  static Function ID##_fn = {FN, NULL};                                        \
+  static RuntimeObject ID##_obj = {.type = T_FUNCTION, .value.v_func = &ID##_fn}
+
+BUILTIN_METHOD(vec_length, vec_length_dynamic);
+BUILTIN_METHOD(vec_append, vec_append_dynamic);
+BUILTIN_METHOD(vec_reserve, vec_reserve_dynamic);
+BUILTIN_METHOD(vec_extend, vec_extend_dynamic);
+BUILTIN_METHOD(vec_pop, vec_pop_dynamic);
+BUILTIN_METHOD(vec_insert, vec_insert_dynamic);
+BUILTIN_METHOD(vec_remove, vec_remove_dynamic);
+BUILTIN_METHOD(vec_clear, vec_clear_dynamic);
+BUILTIN_METHOD(vec_shrink_to_fit, vec_shrink_to_fit_dynamic);
+BUILTIN_METHOD(vec_sum, vec_sum_dynamic);
+BUILTIN_METHOD(vec_min, vec_min_dynamic);
+BUILTIN_METHOD(vec_max, vec_max_dynamic);
+BUILTIN_METHOD(vec_dot, vec_dot_dynamic);
+BUILTIN_METHOD(vec_count, vec_count_dynamic);
+BUILTIN_METHOD(vec_fill, vec_fill_dynamic);
+BUILTIN_METHOD(vec_sort, vec_sort_dynamic);
+BUILTIN_METHOD(vec_sort_by, vec_sort_by_dynamic);
+BUILTIN_METHOD(str_length, str_length_dynamic);
+BUILTIN_METHOD(str_substr, str_substr_dynamic);
+BUILTIN_METHOD(str_find, str_find_dynamic);
+BUILTIN_METHOD(str_contains, str_contains_dynamic);
+BUILTIN_METHOD(str_starts_with, str_starts_with_dynamic);
+BUILTIN_METHOD(str_ends_with, str_ends_with_dynamic);
+BUILTIN_METHOD(str_split, str_split_dynamic);
+BUILTIN_METHOD(str_join, str_join_dynamic);
+BUILTIN_METHOD(str_replace, str_replace_dynamic);
+BUILTIN_METHOD(str_trim, str_trim_dynamic);
+BUILTIN_METHOD(str_next_line, str_next_line_dynamic);
+BUILTIN_METHOD(bytes_length, bytes_length_dynamic);
+BUILTIN_METHOD(bytes_slice, bytes_slice_dynamic);
+BUILTIN_METHOD(bytes_copy_from, bytes_copy_from_dynamic);
+BUILTIN_METHOD(bytes_to_string, bytes_to_string_dynamic);
+BUILTIN_METHOD(dict_length, dict_length_dynamic);
+BUILTIN_METHOD(dict_contains, dict_contains_dynamic);
+BUILTIN_METHOD(dict_keys, dict_keys_dynamic);
+BUILTIN_METHOD(dict_remove, dict_remove_dynamic);
+BUILTIN_METHOD(dict_clear, dict_clear_dynamic);
+
+static const struct {
+  enum DataType type;
+  const char *name;
+  RuntimeObject *method;
+} builtin_methods[] = {
+    {T_VECTOR, "length", &vec_length_obj},
+    {T_VECTOR, "append", &vec_append_obj},
+    {T_VECTOR, "reserve", &vec_reserve_obj},
+    {T_VECTOR, "extend", &vec_extend_obj},
+    {T_VECTOR, "pop", &vec_pop_obj},
+    {T_VECTOR, "insert", &vec_insert_obj},
+    {T_VECTOR, "remove", &vec_remove_obj},
+    {T_VECTOR, "clear", &vec_clear_obj},
+    {T_VECTOR, "shrink_to_fit", &vec_shrink_to_fit_obj},
+    {T_VECTOR, "sum", &vec_sum_obj},
+    {T_VECTOR, "min", &vec_min_obj},
+    {T_VECTOR, "max", &vec_max_obj},
+    {T_VECTOR, "dot", &vec_dot_obj},
+    {T_VECTOR, "count", &vec_count_obj},
+    {T_VECTOR, "fill", &vec_fill_obj},
+    {T_VECTOR, "sort", &vec_sort_obj},
+    {T_VECTOR, "sort_by", &vec_sort_by_obj},
+    {T_STRING, "length", &str_length_obj},
+    {T_STRING, "substr", &str_substr_obj},
+    {T_STRING, "find", &str_find_obj},
+    {T_STRING, "contains", &str_contains_obj},
+    {T_STRING, "starts_with", &str_starts_with_obj},
+    {T_STRING, "ends_with", &str_ends_with_obj},
+    {T_STRING, "split", &str_split_obj},
+    {T_STRING, "join", &str_join_obj},
+    {T_STRING, "replace", &str_replace_obj},
+    {T_STRING, "trim", &str_trim_obj},
+    {T_STRING, "next_line", &str_next_line_obj},
+    {T_BYTES, "length", &bytes_length_obj},
+    {T_BYTES, "slice", &bytes_slice_obj},
+    {T_BYTES, "copy_from", &bytes_copy_from_obj},
+    {T_BYTES, "to_string", &bytes_to_string_obj},
+    {T_DICT, "length", &dict_length_obj},
+    {T_DICT, "contains", &dict_contains_obj},
+    {T_DICT, "keys", &dict_keys_obj},
+    {T_DICT, "remove", &dict_remove_obj},
+    {T_DICT, "clear", &dict_clear_obj},
+};
+
 RuntimeObject *field_access(RuntimeObject *lhs, char *identifier) {
-  // For built-in data types we have known hard-coded function names
+  if (lhs->type == T_MODULE) {
+    return *runtime_st_lookup(&lhs->value.v_mod->table, identifier)->slot;
+  }
 
-  if (lhs->type == T_VECTOR) {
-    if (strcmp(identifier, "length") == 0) {
-      return make_function(vec_length_dynamic);
-    } else if (strcmp(identifier, "append") == 0) {
-      return make_function(vec_append_dynamic);
+  // For built-in data types we have known hard-coded function names
+  size_t num_methods = sizeof(builtin_methods) / sizeof(builtin_methods[0]);
+  for (size_t i = 0; i < num_methods; ++i) {
+    if (builtin_methods[i].type == lhs->type &&
+        strcmp(builtin_methods[i].name, identifier) == 0) {
+      return builtin_methods[i].method;
     }
   }
 
-  if (lhs->type == T_STRING) {
-    if (strcmp(identifier, "length") == 0) {
-      return make_function(str_length_dynamic);
-    }
+  runtime_error("invalid or unimplemented field access");
+  return make_nothing();
+}
+
+/*
+ * Field access as an assignment target (x.y = z). Only module members can be
+ * assigned to, built-in methods are shared and read-only. This is the slot
+ * holding the member, which the assignment points at the new value: writing
+ * through the member's object instead would change every other reference to
+ * it, and objects are shared (constants, template elements, dict and string
+ * elements handed out by get_index).
+ */
+RuntimeObject **field_access_lvalue(RuntimeObject *lhs, char *identifier) {
+  if (lhs->type != T_MODULE) {
+    runtime_error("Assignment is not supported on constants or functions.");
+  }
+  RuntimeSymbolTableEntry *member =
+      runtime_st_lookup(&lhs->value.v_mod->table, identifier);
+  if (!member->assignable) {
+    runtime_error("Assignment is not supported on constants or functions.");
   }
+  return member->slot;
+}
 
-  if (lhs->type == T_DICT) {
-    if (strcmp(identifier, "length") == 0) {
-      return make_function(dict_length_dynamic);
-    } else if (strcmp(identifier, "contains") == 0) {
-      return make_function(dict_contains_dynamic);
-    } else if (strcmp(identifier, "keys") == 0) {
-      return make_function(dict_keys_dynamic);
-    }
+static size_t vec_elem_size(Vector *vec) {
+  return vec->packed == T_NOTHING ? sizeof(RuntimeObject) : sizeof(int64_t);
+}
+
+/*
+ * Copies element `index` of vec into out, boxing it if the vector is packed.
+ */
+void vec_get(Vector *vec, size_t index, RuntimeObject *out) {
+  switch (vec->packed) {
+  case T_INT:
+    out->type = T_INT;
+    out->value.v_int = vec->ints[index];
+    break;
+  case T_FLOAT:
+    out->type = T_FLOAT;
+    out->value.v_float = vec->floats[index];
+    break;
+  default:
+    *out = vec->contents[index];
   }
+}
 
-  if (lhs->type == T_MODULE) {
-    return runtime_st_lookup(&lhs->value.v_mod->table, identifier)->value;
+/*
+ * Element `index` of vec as an object: the element itself if the vector is
+ * boxed. Otherwise its value is boxed into out, or if out is NULL into a
+ * shared small int or a new object.
+ */
+static RuntimeObject *vec_element(Vector *vec, size_t index,
+                                  RuntimeObject *out) {
+  if (vec->packed == T_NOTHING) {
+    return &vec->contents[index];
+  }
+  if (out != NULL) {
+    vec_get(vec, index, out);
+    return out;
   }
+  if (vec->packed == T_INT) {
+    return small_int(vec->ints[index]);
+  }
+  return make_float(vec->floats[index]);
+}
 
-  runtime_error("invalid or unimplemented field access");
+// Converts an unshared packed vector to boxed storage in place. The buffer
+// grows to the boxed size and the elements are spread out back to front, so
+// none is overwritten before it's been moved.
+static void vec_box(Vector *vec) {
+  enum DataType type = vec->packed;
+  if (type == T_NOTHING) {
+    return;
+  }
+  if (vec->internal_size > 0) {
+    vec->contents =
+        realloc(vec->contents, vec->internal_size * sizeof(RuntimeObject));
+  }
+  for (size_t i = vec->size; i-- > 0;) {
+    RuntimeObject elem = {.type = type};
+    if (type == T_INT) {
+      elem.value.v_int = vec->ints[i];
+    } else {
+      elem.value.v_float = vec->floats[i];
+    }
+    vec->contents[i] = elem;
+  }
+  vec->packed = T_NOTHING;
+}
 
-  // For modules (and later, classes) there will be a symbol table
-  // injected in the runtime.
-  return make_nothing();
+// Makes sure elem can be stored in an unshared vec, changing its
+// representation if need be.
+static void vec_fit(Vector *vec, RuntimeObject *elem) {
+  if (vec->packed == T_NOTHING || vec->packed == elem->type) {
+    return;
+  }
+  if (vec->size == 0 && (elem->type == T_INT || elem->type == T_FLOAT)) {
+    // ints and floats take the same space, nothing to convert
+    vec->packed = elem->type;
+    return;
+  }
+  vec_box(vec);
+}
+
+// Stores elem at index of a vector that vec_fit has been called for.
+static void vec_put(Vector *vec, size_t index, RuntimeObject *elem) {
+  switch (vec->packed) {
+  case T_INT:
+    vec->ints[index] = elem->value.v_int;
+    break;
+  case T_FLOAT:
+    vec->floats[index] = elem->value.v_float;
+    break;
+  default:
+    vec->contents[index] = *elem;
+  }
 }
 
 /*
  * Implements index access (x[y]) at runtime.
  */
 RuntimeObject *get_index(RuntimeObject *lhs, RuntimeObject *rhs) {
+  return get_index_into(lhs, rhs, NULL);
+}
+
+/*
+ * Index access whose result is only read before out is reused, e.g. an
+ * operand: an element of a packed vector is boxed into out rather than into
+ * a new object. The compiler gives each such access a temporary of its own.
+ */
+RuntimeObject *get_index_into(RuntimeObject *lhs, RuntimeObject *rhs,
+                              RuntimeObject *out) {
   if (lhs->type == T_VECTOR) {
     if (rhs->type != T_INT) {
       runtime_error("Vector index value must be int.");
@@ -96,7 +290,7 @@ RuntimeObject *get_index(RuntimeObject *lhs, RuntimeObject *rhs) {
       runtime_error("Vector index out of bounds.");
     }
 
-    return &(lhs->value.v_vec->contents[index]);
+    return vec_element(lhs->value.v_vec, index, out);
   }
 
   if (lhs->type == T_STRING) {
@@ -108,24 +302,20 @@ RuntimeObject *get_index(RuntimeObject *lhs, RuntimeObject *rhs) {
       runtime_error("String index out of bounds.");
     }
 
-    char string_value[2] = " ";
-    string_value[0] = lhs->value.v_str->contents[index];
-    return make_string(string_value);
+    return single_char_string(lhs->value.v_str->contents[index]);
   }
 
-  if (lhs->type == T_DICT) {
-    String *key_hash = get_dict_key(rhs);
-    RuntimeObject *maybe_result =
-        dict_get(lhs->value.v_dict, key_hash->contents);
-
-    if (maybe_result != NULL) {
-      return maybe_result;
+  if (lhs->type == T_BYTES) {
+    if (rhs->type != T_INT) {
+      runtime_error("Bytes index value must be int.");
     }
+    return bytes_get(lhs->value.v_bytes, rhs->value.v_int);
+  }
 
-    dict_set(lhs->value.v_dict, *key_hash, rhs, make_nothing());
-    maybe_result = dict_get(lhs->value.v_dict, key_hash->contents);
-
-    return maybe_result;
+  if (lhs->type == T_DICT) {
+    // reading a missing key gives nothing, without inserting it
+    RuntimeObject *maybe_result = dict_get(lhs->value.v_dict, rhs);
+    return maybe_result != NULL ? maybe_result : &missing_key_value;
   }
 
   printf("LHS type: %d\n", lhs->type);
@@ -133,6 +323,47 @@ RuntimeObject *get_index(RuntimeObject *lhs, RuntimeObject *rhs) {
   return make_nothing();
 }
 
+/*
+ * Implements index assignment (x[y] = z) at runtime.
+ */
+void set_index(RuntimeObject *lhs, RuntimeObject *rhs, RuntimeObject *value) {
+  if (lhs->type == T_VECTOR) {
+    if (rhs->type != T_INT) {
+      runtime_error("Vector index value must be int.");
+    }
+    int64_t index = rhs->value.v_int;
+
+    Vector *vec = lhs->value.v_vec;
+    if (index >= vec->size) {
+      runtime_error("Vector index out of bounds.");
+    }
+
+    vec_unshare(vec);
+    vec_fit(vec, value);
+    vec_put(vec, index, value);
+    return;
+  }
+
+  if (lhs->type == T_DICT) {
+    _dict_put(lhs, rhs, value);
+    return;
+  }
+
+  if (lhs->type == T_BYTES) {
+    if (rhs->type != T_INT) {
+      runtime_error("Bytes index value must be int.");
+    }
+    bytes_set(lhs->value.v_bytes, rhs->value.v_int, value);
+    return;
+  }
+
+  if (lhs->type == T_STRING) {
+    runtime_error("Assignment is not supported on string indexes.");
+  }
+
+  runtime_error("Not impemented (set_index)");
+}
+
 RuntimeObject *make_argv(int argc, char *argv[]) {
   RuntimeObject *rt_argv = make_vector_known_size(argc - 1);
   Vector *vec = rt_argv->value.v_vec;
@@ -145,6 +376,7 @@ RuntimeObject *make_argv(int argc, char *argv[]) {
 void runtime_error(char *msg) {
   // very barebones for now, could report more debug info like
   // line number later on.
+  output_flush();
   printf("Runtime error: %s\n", msg);
   exit(1);
 }
@@ -167,70 +399,108 @@ bool get_conditional_result(RuntimeObject *obj) {
 }
 
 void _print_vector(Vector *vec);
+void _print_dict(Dict *dict);
+
+/*
+ * print writes into the output buffer (see output.c) as it goes, vector and
+ * dict contents included, without building the text as a string first.
+ */
+
+static void _print_text(const char *text) { output_write(text, strlen(text)); }
 
 void _print_helper(RuntimeObject *obj) {
   // prints object with no newline
+  char buffer[FORMAT_FLOAT_MAX];
   switch (obj->type) {
   case T_NOTHING:
-    printf(STRING_NOTHING);
+    _print_text(STRING_NOTHING);
     return;
   case T_BOOL:
-    printf(obj->value.v_bool ? STRING_TRUE : STRING_FALSE);
+    _print_text(obj->value.v_bool ? STRING_TRUE : STRING_FALSE);
     return;
   case T_INT:
-    printf("%lld", obj->value.v_int);
+    output_write(buffer, format_int(buffer, obj->value.v_int));
     return;
   case T_FLOAT:
-    printf("%.1f", obj->value.v_float);
+    output_write(buffer, format_float(buffer, obj->value.v_float));
     return;
   case T_STRING:
-    printf("%s", obj->value.v_str->contents);
+    output_write(obj->value.v_str->contents, obj->value.v_str->length);
+    return;
+  case T_BYTES:
+    // as they are, so a program can write binary output
+    output_write((const char *)obj->value.v_bytes->data,
+                 obj->value.v_bytes->length);
     return;
   case T_VECTOR:
     _print_vector(obj->value.v_vec);
     return;
   case T_DICT:
-    printf("%s", to_string_raw(obj)->contents);
+    _print_dict(obj->value.v_dict);
     return;
   case T_FUNCTION: {
-    char *signature = obj->value.v_func.signature;
+    char *signature = obj->value.v_func->signature;
     signature = signature == NULL ? "(Signature Unknown)" : signature;
-    printf("function:%s", signature);
+    _print_text("function:");
+    _print_text(signature);
     return;
   }
   case T_MODULE: {
-    const char *name = obj->value.v_mod->name;
-    printf("module:%s", name);
+    _print_text("module:");
+    _print_text(obj->value.v_mod->name);
     return;
   }
   default:
     break;
   }
-  printf("NOT IMPLEMENTED");
+  _print_text("NOT IMPLEMENTED");
   exit(1);
 }
 
+// An element of a vector or dict, where strings and bytes are quoted.
+static void _print_element(RuntimeObject *obj) {
+  bool is_str = obj->type == T_STRING || obj->type == T_BYTES;
+  if (is_str) {
+    output_write("\"", 1);
+  }
+  _print_helper(obj);
+  if (is_str) {
+    output_write("\"", 1);
+  }
+}
+
 void _print_vector(Vector *vec) {
-  printf("[");
+  output_write("[", 1);
   int i = 0;
   int length = vec->size;
   while (i < length) {
-    RuntimeObject *elem = &(vec->contents[i]);
-    bool is_str = elem->type == T_STRING;
-    if (is_str) {
-      printf("\"");
-    }
-    _print_helper(elem);
-    if (is_str) {
-      printf("\"");
-    }
+    RuntimeObject elem;
+    vec_get(vec, i, &elem);
+    _print_element(&elem);
     if (i != length - 1) {
-      printf(", ");
+      output_write(", ", 2);
     }
     ++i;
   }
+  output_write("]", 1);
+}
 
-  printf("]");
+void _print_dict(Dict *dict) {
+  output_write("{", 1);
+  size_t printed = 0;
+  for (size_t i = 0; i < dict->used; ++i) {
+    RuntimeObject *value = dict->entries[i].value;
+    if (value == NULL) {
+      continue; // removed
+    }
+    _print_element(&dict->entries[i].key);
+    output_write(": ", 2);
+    _print_element(value);
+    if (++printed != dict->size) {
+      output_write(", ", 2);
+    }
+  }
+  output_write("}", 1);
 }
 
 void _dict_put(RuntimeObject *dict, RuntimeObject *key, RuntimeObject *value) {
@@ -239,45 +509,379 @@ void _dict_put(RuntimeObject *dict, RuntimeObject *key, RuntimeObject *value) {
     runtime_error("_dict_put called on a non-dictionary object.");
   }
 
-  // Check if hashable, and get hash
-  String *key_hash = get_dict_key(key);
-
-  // create and insert dictionary entry
-  dict_set(dict->value.v_dict, *key_hash, key, value);
+  // create and insert dictionary entry. Values are stored by copy, like vector
+  // elements, so that assigning through the dict never writes into the
+  // caller's object (which may be a shared constant).
+  dict_set(dict->value.v_dict, key, make_object_copy(value));
 }
 
 void builtin_print(RuntimeObject *arg) {
   _print_helper(arg);
-  printf("\n");
+  output_write("\n", 1);
+  output_end();
+}
+
+// print without the newline
+void builtin_write(RuntimeObject *arg) {
+  _print_helper(arg);
+  output_end();
 }
 
+void builtin_flush() { output_flush(); }
+
 // VECTOR methods
+
+/*
+ * Give a copy-on-write vector its own contents before it's mutated.
+ */
+void vec_unshare(Vector *vec) {
+  if (!vec->shared) {
+    return;
+  }
+  RuntimeObject *contents = calloc(vec->internal_size, vec_elem_size(vec));
+  memcpy(contents, vec->contents, vec->size * vec_elem_size(vec));
+  vec->contents = contents;
+  vec->shared = false;
+}
+
 RuntimeObject *vec_length(RuntimeObject *self) {
   return make_int(self->value.v_vec->size);
 }
 
+/*
+ * Resizes the storage of an unshared vector to exactly `capacity` elements.
+ * This goes through realloc, which extends the buffer in place when it can;
+ * glibc serves large buffers with mmap and grows those with mremap, which
+ * remaps the pages instead of copying the elements.
+ */
+static void vec_set_capacity(Vector *vec, size_t capacity) {
+  if (capacity == 0) {
+    free(vec->contents);
+    vec->contents = NULL;
+  } else {
+    vec->contents = realloc(vec->contents, capacity * vec_elem_size(vec));
+  }
+  vec->internal_size = capacity;
+}
+
+// Makes room for at least `needed` elements, at least doubling the storage
+// so that a run of appends only grows it O(log n) times.
+static void vec_grow(Vector *vec, size_t needed) {
+  if (needed <= vec->internal_size) {
+    return;
+  }
+  size_t capacity = vec->internal_size * 2;
+  if (capacity < VEC_INITIAL_SIZE) {
+    capacity = VEC_INITIAL_SIZE;
+  }
+  vec_set_capacity(vec, capacity < needed ? needed : capacity);
+}
+
+static size_t vec_index_arg(Vector *vec, RuntimeObject *index, size_t limit) {
+  if (index->type != T_INT) {
+    runtime_error("Vector index value must be int.");
+  }
+  if (index->value.v_int < 0 || (size_t)index->value.v_int >= limit) {
+    runtime_error("Vector index out of bounds.");
+  }
+  return (size_t)index->value.v_int;
+}
+
 RuntimeObject *vec_append(RuntimeObject *self, RuntimeObject *obj) {
   Vector *vec = self->value.v_vec;
-  size_t new_size = vec->size + 1;
-
-  if (new_size > vec->internal_size) {
-    // double internal cap
-    size_t new_internal_size = vec->internal_size * 2;
-    // allocate new internal storage
-    RuntimeObject *new_contents =
-        calloc(new_internal_size, sizeof(RuntimeObject));
-    // copy existing elements over
-    for (size_t i = 0; i < vec->internal_size; i++) {
-      RuntimeObject *elem = &(vec->contents[i]);
-      new_contents[i] = *elem;
+  // obj may live inside this vector's storage, which is about to move
+  RuntimeObject elem = *obj;
+  vec_unshare(vec);
+  vec_fit(vec, &elem);
+  vec_grow(vec, vec->size + 1);
+  vec_put(vec, vec->size++, &elem);
+  return make_nothing();
+}
+
+RuntimeObject *vec_reserve(RuntimeObject *self, RuntimeObject *capacity) {
+  Vector *vec = self->value.v_vec;
+  if (capacity->type != T_INT || capacity->value.v_int < 0) {
+    runtime_error("Vector capacity must be a non-negative int.");
+  }
+  vec_unshare(vec);
+  if ((size_t)capacity->value.v_int > vec->internal_size) {
+    vec_set_capacity(vec, (size_t)capacity->value.v_int);
+  }
+  return make_nothing();
+}
+
+RuntimeObject *vec_extend(RuntimeObject *self, RuntimeObject *other) {
+  if (other->type != T_VECTOR) {
+    runtime_error("Vector can only be extended by another vector.");
+  }
+  Vector *vec = self->value.v_vec;
+  Vector *src = other->value.v_vec;
+  // read the count first, other may be this same vector
+  size_t count = src->size;
+  vec_unshare(vec);
+  if (vec->size == 0 && vec->packed != T_NOTHING) {
+    vec->packed = src->packed;
+    if (src->packed == T_NOTHING) {
+      vec_set_capacity(vec, vec->internal_size);
+    }
+  } else if (vec->packed != src->packed && count > 0) {
+    vec_box(vec);
+  }
+  vec_grow(vec, vec->size + count);
+  if (vec->packed == src->packed) {
+    memcpy((char *)vec->contents + vec->size * vec_elem_size(vec),
+           src->contents, count * vec_elem_size(vec));
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      vec_get(src, i, &vec->contents[vec->size + i]);
     }
-    // free old array, assign new array to contents
-    free(vec->contents);
-    vec->contents = new_contents;
-    vec->internal_size = new_internal_size;
   }
-  vec->size = new_size;
-  vec->contents[vec->size - 1] = *obj;
+  vec->size += count;
+  return make_nothing();
+}
+
+RuntimeObject *vec_pop(RuntimeObject *self) {
+  Vector *vec = self->value.v_vec;
+  if (vec->size == 0) {
+    runtime_error("Cannot pop from an empty vector.");
+  }
+  // the element is copied out since its slot gets reused by the next append
+  RuntimeObject *elem = malloc(sizeof(RuntimeObject));
+  vec_get(vec, vec->size - 1, elem);
+  vec_unshare(vec);
+  vec->size--;
+  return elem;
+}
+
+RuntimeObject *vec_insert(RuntimeObject *self, RuntimeObject *index,
+                          RuntimeObject *obj) {
+  Vector *vec = self->value.v_vec;
+  size_t i = vec_index_arg(vec, index, vec->size + 1);
+  // obj may live inside this vector's storage, which is about to move
+  RuntimeObject elem = *obj;
+  vec_unshare(vec);
+  vec_fit(vec, &elem);
+  vec_grow(vec, vec->size + 1);
+  size_t elem_size = vec_elem_size(vec);
+  char *at = (char *)vec->contents + i * elem_size;
+  memmove(at + elem_size, at, (vec->size - i) * elem_size);
+  vec_put(vec, i, &elem);
+  vec->size++;
+  return make_nothing();
+}
+
+RuntimeObject *vec_remove(RuntimeObject *self, RuntimeObject *index) {
+  Vector *vec = self->value.v_vec;
+  size_t i = vec_index_arg(vec, index, vec->size);
+  RuntimeObject *elem = malloc(sizeof(RuntimeObject));
+  vec_get(vec, i, elem);
+  vec_unshare(vec);
+  size_t elem_size = vec_elem_size(vec);
+  char *at = (char *)vec->contents + i * elem_size;
+  memmove(at, at + elem_size, (vec->size - i - 1) * elem_size);
+  vec->size--;
+  return elem;
+}
+
+RuntimeObject *vec_clear(RuntimeObject *self) {
+  Vector *vec = self->value.v_vec;
+  vec_unshare(vec);
+  vec->size = 0;
+  return make_nothing();
+}
+
+RuntimeObject *vec_shrink_to_fit(RuntimeObject *self) {
+  Vector *vec = self->value.v_vec;
+  vec_unshare(vec);
+  vec_set_capacity(vec, vec->size);
+  return make_nothing();
+}
+
+/*
+ * The elements of a vector as numbers, for the numeric methods: ints if they
+ * are all ints, floats if at least one of them is a float (the ints are then
+ * converted). Packed storage is used as it is, boxed elements are copied out
+ * into `owned`, which the caller frees.
+ */
+typedef struct {
+  enum DataType type;
+  union {
+    const int64_t *ints;
+    const double *floats;
+  };
+  void *owned;
+} Numbers;
+
+static Numbers vec_numbers(Vector *vec, char *error) {
+  Numbers nums = {.type = vec->packed, .ints = vec->ints, .owned = NULL};
+  if (vec->packed != T_NOTHING) {
+    return nums;
+  }
+  nums.type = T_INT;
+  for (size_t i = 0; i < vec->size; ++i) {
+    if (vec->contents[i].type == T_FLOAT) {
+      nums.type = T_FLOAT;
+    } else if (vec->contents[i].type != T_INT) {
+      runtime_error(error);
+    }
+  }
+  if (nums.type == T_INT) {
+    int64_t *ints = malloc(vec->size * sizeof(int64_t));
+    for (size_t i = 0; i < vec->size; ++i) {
+      ints[i] = vec->contents[i].value.v_int;
+    }
+    nums.ints = nums.owned = ints;
+  } else {
+    double *floats = malloc(vec->size * sizeof(double));
+    for (size_t i = 0; i < vec->size; ++i) {
+      RuntimeObject *elem = &vec->contents[i];
+      floats[i] = elem->type == T_INT ? (double)elem->value.v_int
+                                      : elem->value.v_float;
+    }
+    nums.floats = nums.owned = floats;
+  }
+  return nums;
+}
+
+static void numbers_to_floats(Numbers *nums, size_t n) {
+  if (nums->type == T_FLOAT) {
+    return;
+  }
+  double *floats = malloc(n * sizeof(double));
+  for (size_t i = 0; i < n; ++i) {
+    floats[i] = (double)nums->ints[i];
+  }
+  free(nums->owned);
+  nums->type = T_FLOAT;
+  nums->floats = nums->owned = floats;
+}
+
+RuntimeObject *vec_sum(RuntimeObject *self) {
+  Vector *vec = self->value.v_vec;
+  // whatever an empty vector was packed for, its sum is the int 0
+  if (vec->size == 0) {
+    return make_int(0);
+  }
+  Numbers nums = vec_numbers(vec, "sum() needs a vector of numbers.");
+  RuntimeObject *result = nums.type == T_INT
+                              ? make_int(ints_sum(nums.ints, vec->size))
+                              : make_float(floats_sum(nums.floats, vec->size));
+  free(nums.owned);
+  return result;
+}
+
+RuntimeObject *vec_min(RuntimeObject *self) {
+  Vector *vec = self->value.v_vec;
+  if (vec->size == 0) {
+    runtime_error("min() of an empty vector.");
+  }
+  Numbers nums = vec_numbers(vec, "min() needs a vector of numbers.");
+  RuntimeObject *result = nums.type == T_INT
+                              ? make_int(ints_min(nums.ints, vec->size))
+                              : make_float(floats_min(nums.floats, vec->size));
+  free(nums.owned);
+  return result;
+}
+
+RuntimeObject *vec_max(RuntimeObject *self) {
+  Vector *vec = self->value.v_vec;
+  if (vec->size == 0) {
+    runtime_error("max() of an empty vector.");
+  }
+  Numbers nums = vec_numbers(vec, "max() needs a vector of numbers.");
+  RuntimeObject *result = nums.type == T_INT
+                              ? make_int(ints_max(nums.ints, vec->size))
+                              : make_float(floats_max(nums.floats, vec->size));
+  free(nums.owned);
+  return result;
+}
+
+RuntimeObject *vec_dot(RuntimeObject *self, RuntimeObject *other) {
+  if (other->type != T_VECTOR) {
+    runtime_error("dot() needs another vector.");
+  }
+  Vector *lhs = self->value.v_vec;
+  Vector *rhs = other->value.v_vec;
+  if (lhs->size != rhs->size) {
+    runtime_error("dot() needs vectors of the same length.");
+  }
+  if (lhs->size == 0) {
+    return make_int(0);
+  }
+  Numbers lhs_nums = vec_numbers(lhs, "dot() needs vectors of numbers.");
+  Numbers rhs_nums = vec_numbers(rhs, "dot() needs vectors of numbers.");
+  RuntimeObject *result;
+  if (lhs_nums.type == T_INT && rhs_nums.type == T_INT) {
+    result = make_int(ints_dot(lhs_nums.ints, rhs_nums.ints, lhs->size));
+  } else {
+    numbers_to_floats(&lhs_nums, lhs->size);
+    numbers_to_floats(&rhs_nums, rhs->size);
+    result = make_float(floats_dot(lhs_nums.floats, rhs_nums.floats, lhs->size));
+  }
+  free(lhs_nums.owned);
+  free(rhs_nums.owned);
+  return result;
+}
+
+RuntimeObject *vec_count(RuntimeObject *self, RuntimeObject *value) {
+  Vector *vec = self->value.v_vec;
+  // values of another type never compare equal, see equality_comparison
+  switch (vec->packed) {
+  case T_INT:
+    return make_int(value->type == T_INT
+                        ? ints_count(vec->ints, vec->size, value->value.v_int)
+                        : 0);
+  case T_FLOAT:
+    return make_int(
+        value->type == T_FLOAT
+            ? floats_count(vec->floats, vec->size, value->value.v_float)
+            : 0);
+  default: {
+    size_t count = 0;
+    for (size_t i = 0; i < vec->size; ++i) {
+      count += equality_comparison(&vec->contents[i], value);
+    }
+    return make_int(count);
+  }
+  }
+}
+
+/*
+ * Replaces the contents of the vector with `count` copies of value. A vector
+ * filled with ints or floats is packed again, even if it was boxed before.
+ */
+RuntimeObject *vec_fill(RuntimeObject *self, RuntimeObject *value,
+                        RuntimeObject *count) {
+  Vector *vec = self->value.v_vec;
+  if (count->type != T_INT || count->value.v_int < 0) {
+    runtime_error("Fill count must be a non-negative int.");
+  }
+  size_t n = (size_t)count->value.v_int;
+  // value may live inside this vector's storage, which is about to move
+  RuntimeObject elem = *value;
+  vec_unshare(vec);
+  vec->size = 0;
+  if (vec->packed == T_NOTHING && (elem.type == T_INT || elem.type == T_FLOAT)) {
+    // the boxed buffer has room for at least as many packed elements
+    vec->packed = elem.type;
+  }
+  vec_fit(vec, &elem);
+  if (n > vec->internal_size) {
+    vec_set_capacity(vec, n);
+  }
+  switch (vec->packed) {
+  case T_INT:
+    ints_fill(vec->ints, n, elem.value.v_int);
+    break;
+  case T_FLOAT:
+    floats_fill(vec->floats, n, elem.value.v_float);
+    break;
+  default:
+    for (size_t i = 0; i < n; ++i) {
+      vec->contents[i] = elem;
+    }
+  }
+  vec->size = n;
   return make_nothing();
 }
 
@@ -295,6 +899,111 @@ RuntimeObject *vec_append_dynamic(size_t argc, RuntimeObject *argv[]) {
   return vec_append(argv[0], argv[1]);
 }
 
+RuntimeObject *vec_reserve_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for vec reserve.");
+  }
+  return vec_reserve(argv[0], argv[1]);
+}
+
+RuntimeObject *vec_extend_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for vec extend.");
+  }
+  return vec_extend(argv[0], argv[1]);
+}
+
+RuntimeObject *vec_pop_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 1) {
+    runtime_error("Argument number mismatch for vec pop.");
+  }
+  return vec_pop(argv[0]);
+}
+
+RuntimeObject *vec_insert_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 3) {
+    runtime_error("Argument number mismatch for vec insert.");
+  }
+  return vec_insert(argv[0], argv[1], argv[2]);
+}
+
+RuntimeObject *vec_remove_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for vec remove.");
+  }
+  return vec_remove(argv[0], argv[1]);
+}
+
+RuntimeObject *vec_clear_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 1) {
+    runtime_error("Argument number mismatch for vec clear.");
+  }
+  return vec_clear(argv[0]);
+}
+
+RuntimeObject *vec_shrink_to_fit_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 1) {
+    runtime_error("Argument number mismatch for vec shrink_to_fit.");
+  }
+  return vec_shrink_to_fit(argv[0]);
+}
+
+RuntimeObject *vec_sum_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 1) {
+    runtime_error("Argument number mismatch for vec sum.");
+  }
+  return vec_sum(argv[0]);
+}
+
+RuntimeObject *vec_min_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 1) {
+    runtime_error("Argument number mismatch for vec min.");
+  }
+  return vec_min(argv[0]);
+}
+
+RuntimeObject *vec_max_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 1) {
+    runtime_error("Argument number mismatch for vec max.");
+  }
+  return vec_max(argv[0]);
+}
+
+RuntimeObject *vec_dot_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for vec dot.");
+  }
+  return vec_dot(argv[0], argv[1]);
+}
+
+RuntimeObject *vec_count_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for vec count.");
+  }
+  return vec_count(argv[0], argv[1]);
+}
+
+RuntimeObject *vec_fill_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 3) {
+    runtime_error("Argument number mismatch for vec fill.");
+  }
+  return vec_fill(argv[0], argv[1], argv[2]);
+}
+
+RuntimeObject *vec_sort_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 1) {
+    runtime_error("Argument number mismatch for vec sort.");
+  }
+  return vec_sort(argv[0]);
+}
+
+RuntimeObject *vec_sort_by_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for vec sort_by.");
+  }
+  return vec_sort_by(argv[0], argv[1]);
+}
+
 RuntimeObject *str_length(RuntimeObject *self) {
   return make_int(self->value.v_str->length);
 }
@@ -306,16 +1015,87 @@ RuntimeObject *str_length_dynamic(size_t argc, RuntimeObject *argv[]) {
   return str_length(argv[0]);
 }
 
+RuntimeObject *str_substr_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 3) {
+    runtime_error("Argument number mismatch for string substr.");
+  }
+  return str_substr(argv[0], argv[1], argv[2]);
+}
+
+RuntimeObject *str_find_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for string find.");
+  }
+  return str_find(argv[0], argv[1]);
+}
+
+RuntimeObject *str_contains_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for string contains.");
+  }
+  return str_contains(argv[0], argv[1]);
+}
+
+RuntimeObject *str_starts_with_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for string starts_with.");
+  }
+  return str_starts_with(argv[0], argv[1]);
+}
+
+RuntimeObject *str_ends_with_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for string ends_with.");
+  }
+  return str_ends_with(argv[0], argv[1]);
+}
+
+RuntimeObject *str_split_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for string split.");
+  }
+  return str_split(argv[0], argv[1]);
+}
+
+RuntimeObject *str_join_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for string join.");
+  }
+  return str_join(argv[0], argv[1]);
+}
+
+RuntimeObject *str_replace_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 3) {
+    runtime_error("Argument number mismatch for string replace.");
+  }
+  return str_replace(argv[0], argv[1], argv[2]);
+}
+
+RuntimeObject *str_trim_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 1) {
+    runtime_error("Argument number mismatch for string trim.");
+  }
+  return str_trim(argv[0]);
+}
+
+RuntimeObject *str_next_line_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for string next_line.");
+  }
+  return str_next_line(argv[0], argv[1]);
+}
+
 RuntimeObject *dict_length(RuntimeObject *self) {
   return make_int(self->value.v_dict->size);
 }
 
 RuntimeObject *dict_keys_raw(Dict *dict) {
-  RuntimeObject *result_vec = make_vector();
-  for (size_t i = 0; i < dict->capacity; ++i) {
-    if (dict->entries[i].key_hash.contents != NULL) {
-      DictEntry *entry = &dict->entries[i];
-      vec_append(result_vec, entry->key);
+  RuntimeObject *result_vec = make_vector_known_size(dict->size);
+  RuntimeObject *contents = result_vec->value.v_vec->contents;
+  size_t count = 0;
+  for (size_t i = 0; i < dict->used; ++i) {
+    if (dict->entries[i].value != NULL) {
+      contents[count++] = dict->entries[i].key;
     }
   }
   return result_vec;
@@ -328,9 +1108,16 @@ RuntimeObject *dict_keys(RuntimeObject *self) {
 
 RuntimeObject *dict_contains(RuntimeObject *self, RuntimeObject *key) {
   Dict *dict = self->value.v_dict;
-  String *hash_key = get_dict_key(key);
-  RuntimeObject *result = dict_get(dict, hash_key->contents);
-  return make_bool(result != NULL);
+  return make_bool(dict_get(dict, key) != NULL);
+}
+
+RuntimeObject *dict_remove(RuntimeObject *self, RuntimeObject *key) {
+  return make_bool(dict_delete(self->value.v_dict, key));
+}
+
+RuntimeObject *dict_clear(RuntimeObject *self) {
+  dict_reset(self->value.v_dict);
+  return make_nothing();
 }
 
 RuntimeObject *dict_length_dynamic(size_t argc, RuntimeObject *argv[]) {
@@ -354,14 +1141,61 @@ RuntimeObject *dict_contains_dynamic(size_t argc, RuntimeObject *argv[]) {
   return dict_contains(argv[0], argv[1]);
 }
 
+RuntimeObject *dict_remove_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 2) {
+    runtime_error("Argument number mismatch for dict remove");
+  }
+  return dict_remove(argv[0], argv[1]);
+}
+
+RuntimeObject *dict_clear_dynamic(size_t argc, RuntimeObject *argv[]) {
+  if (argc != 1) {
+    runtime_error("Argument number mismatch for dict clear");
+  }
+  return dict_clear(argv[0]);
+}
+
+static uint64_t runtime_st_hash(const char *identifier) {
+  uint64_t hash = FNV_OFFSET;
+  for (const char *p = identifier; *p; p++) {
+    hash ^= (uint64_t)(unsigned char)(*p);
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+static void runtime_st_build_index(RuntimeSymbolTable *st) {
+  // keep the index at most half full so probe sequences stay short
+  size_t capacity = 8;
+  while (capacity < st->size * 2) {
+    capacity *= 2;
+  }
+  st->index = calloc(capacity, sizeof(uint32_t));
+  st->index_capacity = capacity;
+
+  for (size_t i = 0; i < st->size; ++i) {
+    size_t slot = runtime_st_hash(st->entries[i].name) & (capacity - 1);
+    while (st->index[slot] != 0) {
+      slot = (slot + 1) & (capacity - 1);
+    }
+    st->index[slot] = i + 1;
+  }
+}
+
 RuntimeSymbolTableEntry *runtime_st_lookup(RuntimeSymbolTable *st,
                                            char *identifier) {
-  // dead simple linear lookup
-  for (size_t i = 0; i < st->size; ++i) {
-    RuntimeSymbolTableEntry *p = &st->entries[i];
+  if (st->index == NULL) {
+    runtime_st_build_index(st);
+  }
+
+  size_t mask = st->index_capacity - 1;
+  size_t slot = runtime_st_hash(identifier) & mask;
+  while (st->index[slot] != 0) {
+    RuntimeSymbolTableEntry *p = &st->entries[st->index[slot] - 1];
     if (strcmp(p->name, identifier) == 0) {
       return p;
     }
+    slot = (slot + 1) & mask;
   }
 
   runtime_error("Bad module lookup, identifier not found.");
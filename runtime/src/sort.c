@@ -0,0 +1,277 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "datatype.h"
+#include "rtutil.h"
+#include "runtime.h"
+
+/*
+ * Sorting for vectors: v.sort() orders numbers (ints and floats compare by
+ * value, NaNs go last) or strings (bytewise), and v.sort_by(less) orders any
+ * elements by a function telling whether its first argument goes before its
+ * second.
+ *
+ * Every sort is stable. That makes the result unique whenever the ordering is
+ * consistent, so it doesn't depend on the algorithm, and the interpreter
+ * (which uses std::stable_sort) gives the same result: -0.0 and 0.0 keep their
+ * order, and so do elements sort_by considers equivalent.
+ *
+ * Packed vectors are radix sorted on their 64 bits, which takes a handful of
+ * linear passes instead of O(n log n) comparisons. Everything else goes
+ * through a merge sort over pointers to the elements.
+ */
+
+// Below this size, insertion sort beats setting up the other algorithms.
+#define SORT_INSERTION_MAX 32
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES (64 / RADIX_BITS)
+
+/*
+ * Maps the bits of an int or float to a key that orders the same way as
+ * unsigned integers. For ints that's flipping the sign bit; for floats also
+ * flipping every other bit of negative numbers. -0.0 maps to the key of 0.0
+ * and every NaN to the largest key, so those stay in their original order.
+ */
+static inline uint64_t radix_key(uint64_t bits, bool floats) {
+  const uint64_t sign = (uint64_t)1 << 63;
+  if (!floats) {
+    return bits ^ sign;
+  }
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  if (isnan(value)) {
+    return UINT64_MAX;
+  }
+  if (value == 0) {
+    return sign;
+  }
+  return bits & sign ? ~bits : bits | sign;
+}
+
+static void insertion_sort_keys(uint64_t *elems, size_t n, bool floats) {
+  for (size_t i = 1; i < n; ++i) {
+    uint64_t elem = elems[i];
+    uint64_t key = radix_key(elem, floats);
+    size_t j = i;
+    for (; j > 0 && key < radix_key(elems[j - 1], floats); --j) {
+      elems[j] = elems[j - 1];
+    }
+    elems[j] = elem;
+  }
+}
+
+/*
+ * LSD radix sort, one byte of the key per pass. The histograms for all
+ * passes are counted up front in a single read of the elements, and a pass
+ * where every element has the same byte is skipped, so vectors of small
+ * non-negative ints only take a couple of passes.
+ */
+static void radix_sort(uint64_t *elems, size_t n, bool floats) {
+  if (n <= SORT_INSERTION_MAX) {
+    insertion_sort_keys(elems, n, floats);
+    return;
+  }
+  size_t(*counts)[RADIX_BUCKETS] =
+      calloc(RADIX_PASSES, sizeof(size_t[RADIX_BUCKETS]));
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t key = radix_key(elems[i], floats);
+    for (size_t pass = 0; pass < RADIX_PASSES; ++pass) {
+      counts[pass][(key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+    }
+  }
+
+  uint64_t *buffer = malloc(n * sizeof(uint64_t));
+  uint64_t *from = elems, *to = buffer;
+  for (size_t pass = 0; pass < RADIX_PASSES; ++pass) {
+    size_t shift = pass * RADIX_BITS;
+    size_t offsets[RADIX_BUCKETS];
+    size_t offset = 0;
+    bool trivial = false;
+    for (size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+      trivial = trivial || counts[pass][bucket] == n;
+      offsets[bucket] = offset;
+      offset += counts[pass][bucket];
+    }
+    if (trivial) {
+      continue;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      uint64_t key = radix_key(from[i], floats);
+      to[offsets[(key >> shift) & (RADIX_BUCKETS - 1)]++] = from[i];
+    }
+    uint64_t *swap = from;
+    from = to;
+    to = swap;
+  }
+  if (from != elems) {
+    memcpy(elems, from, n * sizeof(uint64_t));
+  }
+  free(buffer);
+  free(counts);
+}
+
+typedef bool (*ObjectLess)(RuntimeObject *lhs, RuntimeObject *rhs, void *ctx);
+
+/*
+ * Stable merge sort of n element pointers, with a buffer of at least n / 2
+ * pointers. Runs that are already in order cost a single comparison to
+ * merge.
+ */
+static void merge_sort(RuntimeObject **items, RuntimeObject **buffer,
+                       size_t n, ObjectLess less, void *ctx) {
+  if (n <= SORT_INSERTION_MAX) {
+    for (size_t i = 1; i < n; ++i) {
+      RuntimeObject *item = items[i];
+      size_t j = i;
+      for (; j > 0 && less(item, items[j - 1], ctx); --j) {
+        items[j] = items[j - 1];
+      }
+      items[j] = item;
+    }
+    return;
+  }
+  size_t mid = n / 2;
+  merge_sort(items, buffer, mid, less, ctx);
+  merge_sort(items + mid, buffer, n - mid, less, ctx);
+  if (!less(items[mid], items[mid - 1], ctx)) {
+    return;
+  }
+  // merge the left half, moved out of the way, with the right half in place
+  memcpy(buffer, items, mid * sizeof(RuntimeObject *));
+  size_t left = 0, right = mid, out = 0;
+  while (left < mid && right < n) {
+    // on ties the left element goes first, which keeps the sort stable
+    if (less(items[right], buffer[left], ctx)) {
+      items[out++] = items[right++];
+    } else {
+      items[out++] = buffer[left++];
+    }
+  }
+  memcpy(&items[out], &buffer[left], (mid - left) * sizeof(RuntimeObject *));
+}
+
+// Sorts the elements of a boxed vector by reordering them.
+static void sort_boxed(Vector *vec, ObjectLess less, void *ctx) {
+  size_t n = vec->size;
+  RuntimeObject **items = malloc(n * sizeof(RuntimeObject *));
+  RuntimeObject **buffer = malloc((n / 2 + 1) * sizeof(RuntimeObject *));
+  for (size_t i = 0; i < n; ++i) {
+    items[i] = &vec->contents[i];
+  }
+  merge_sort(items, buffer, n, less, ctx);
+  RuntimeObject *sorted = malloc(vec->internal_size * sizeof(RuntimeObject));
+  for (size_t i = 0; i < n; ++i) {
+    sorted[i] = *items[i];
+  }
+  free(vec->contents);
+  vec->contents = sorted;
+  free(buffer);
+  free(items);
+}
+
+static bool number_less(RuntimeObject *lhs, RuntimeObject *rhs, void *ctx) {
+  if (lhs->type == T_INT && rhs->type == T_INT) {
+    return lhs->value.v_int < rhs->value.v_int;
+  }
+  double lhs_value = lhs->type == T_INT ? (double)lhs->value.v_int
+                                        : lhs->value.v_float;
+  double rhs_value = rhs->type == T_INT ? (double)rhs->value.v_int
+                                        : rhs->value.v_float;
+  // NaNs compare greater than every number and equal to each other
+  if (isnan(lhs_value)) {
+    return false;
+  }
+  return isnan(rhs_value) || lhs_value < rhs_value;
+}
+
+static bool string_less(RuntimeObject *lhs, RuntimeObject *rhs, void *ctx) {
+  String *lhs_str = lhs->value.v_str;
+  String *rhs_str = rhs->value.v_str;
+  size_t length =
+      lhs_str->length < rhs_str->length ? lhs_str->length : rhs_str->length;
+  int cmp = memcmp(lhs_str->contents, rhs_str->contents, length);
+  return cmp < 0 || (cmp == 0 && lhs_str->length < rhs_str->length);
+}
+
+// sort_by's function, and what the vector it sorts looked like when the sort
+// started: the function is a program's own code, which can change the vector.
+typedef struct {
+  RuntimeObject *less;
+  Vector *vec;
+  size_t size;
+  size_t internal_size;
+  int64_t *storage;
+  enum DataType packed;
+} SortBy;
+
+static bool function_less(RuntimeObject *lhs, RuntimeObject *rhs, void *ctx) {
+  SortBy *sort = ctx;
+  RuntimeObject *argv[] = {lhs, rhs};
+  bool result =
+      get_conditional_result(dynamic_function_call(sort->less, 2, argv));
+  Vector *vec = sort->vec;
+  if (vec->size != sort->size || vec->internal_size != sort->internal_size ||
+      vec->ints != sort->storage || vec->packed != sort->packed) {
+    runtime_error("sort_by(): vector changed during sort.");
+  }
+  return result;
+}
+
+RuntimeObject *vec_sort(RuntimeObject *self) {
+  Vector *vec = self->value.v_vec;
+  vec_unshare(vec);
+  if (vec->packed != T_NOTHING) {
+    radix_sort((uint64_t *)vec->ints, vec->size, vec->packed == T_FLOAT);
+    return make_nothing();
+  }
+  bool numbers = true, strings = true;
+  for (size_t i = 0; i < vec->size; ++i) {
+    enum DataType type = vec->contents[i].type;
+    numbers = numbers && (type == T_INT || type == T_FLOAT);
+    strings = strings && type == T_STRING;
+  }
+  if (!numbers && !strings) {
+    runtime_error("sort() needs a vector of numbers or of strings.");
+  }
+  sort_boxed(vec, numbers ? number_less : string_less, NULL);
+  return make_nothing();
+}
+
+RuntimeObject *vec_sort_by(RuntimeObject *self, RuntimeObject *less) {
+  if (less->type != T_FUNCTION) {
+    runtime_error("sort_by() needs a function.");
+  }
+  Vector *vec = self->value.v_vec;
+  vec_unshare(vec);
+  // The elements are sorted as a copy, so that the function changing the
+  // vector can't pull the storage out from under the sort; that is caught
+  // after each call and the copy is only put back if nothing changed. The
+  // copy is left allocated, since the function may hold on to the elements,
+  // like any other value handed to a program.
+  size_t n = vec->size;
+  SortBy sort = {less, vec, n, vec->internal_size, vec->ints, vec->packed};
+  RuntimeObject *boxed = malloc(n * sizeof(RuntimeObject));
+  RuntimeObject **items = malloc(n * sizeof(RuntimeObject *));
+  RuntimeObject **buffer = malloc((n / 2 + 1) * sizeof(RuntimeObject *));
+  for (size_t i = 0; i < n; ++i) {
+    vec_get(vec, i, &boxed[i]);
+    items[i] = &boxed[i];
+  }
+  merge_sort(items, buffer, n, function_less, &sort);
+  for (size_t i = 0; i < n; ++i) {
+    if (vec->packed == T_NOTHING) {
+      vec->contents[i] = *items[i];
+    } else {
+      // the int and float members share their bits
+      vec->ints[i] = items[i]->value.v_int;
+    }
+  }
+  free(buffer);
+  free(items);
+  return make_nothing();
+}
@@ -1,5 +1,6 @@
 #include "datatype.h"
 #include "dictionary.h"
+#include "numfmt.h"
 #include "rtutil.h"
 #include "runtime.h"
 
@@ -7,6 +8,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Longest result of a concatenation that's stored with its string object
+// rather than in a StringBuffer, see str_append.
+#define SHORT_STRING_MAX 15
+
 /*
  * Take two C strings, allocate heap space for their combined length,
  * then concatenate them.
@@ -22,26 +27,142 @@ char *strdupcat(const char *str1, const char *str2) {
 }
 
 String *make_string_raw(char *value) {
-  String *str = malloc(sizeof(String));
-  str->length = strlen(value);
-  str->contents = strdup(value);
+  // the contents go right after the header, in the same allocation
+  size_t length = strlen(value);
+  String *str = malloc(sizeof(String) + length + 1);
+  string_init(str, (char *)(str + 1), length);
+  memcpy(str->contents, value, length + 1);
   return str;
 }
 
 String *make_string_nocopy_raw(char *value) {
+  return make_string_length_raw(value, strlen(value));
+}
+
+String *make_string_length_raw(char *value, size_t length) {
   String *str = malloc(sizeof(String));
-  str->length = strlen(value);
-  str->contents = value;
+  string_init(str, value, length);
+  return str;
+}
+
+void string_init(String *str, char *contents, size_t length) {
+  str->length = length;
+  str->contents = contents;
+  str->buffer = NULL;
+  str->hash = 0;
+  str->interned = false;
+}
+
+/*
+ * A string of `length` bytes at `contents`, which lie within parent's. The
+ * bytes are shared rather than copied: strings are never modified, and
+ * nothing is ever freed. The view keeps parent's buffer, so appending to a
+ * view that ends where the buffer's used bytes end is done in place like for
+ * any other string.
+ */
+String *str_view_raw(String *parent, char *contents, size_t length) {
+  String *str = make_string_length_raw(contents, length);
+  str->buffer = parent->buffer;
   return str;
 }
 
+// Whether `length` more bytes can go right after lhs in its buffer.
+static bool fits_in_place(String *lhs, size_t length) {
+  StringBuffer *buffer = lhs->buffer;
+  return buffer != NULL &&
+         lhs->contents + lhs->length == buffer->data + buffer->used &&
+         buffer->used + length < buffer->capacity;
+}
+
+/*
+ * Makes str lhs followed by `length` bytes, leaving lhs as it is.
+ *
+ * The result lives in a StringBuffer. When lhs is itself the longest string
+ * in its buffer (it ends where the buffer's used bytes end) the bytes are
+ * appended in place and the result shares lhs's contents: no other string can
+ * be looking at the bytes after lhs. Only when the buffer is full are the
+ * contents copied, to a new buffer with as much room again, so a loop of
+ * `s = s + x` takes linear time overall rather than quadratic. Old buffers
+ * stay alive since earlier strings still point into them.
+ */
+static void append_to_buffer(String *str, String *lhs, const char *bytes,
+                             size_t length) {
+  StringBuffer *buffer = lhs->buffer;
+  size_t total = lhs->length + length;
+  str->length = total;
+
+  if (fits_in_place(lhs, length)) {
+    // bytes may be part of lhs itself, which stays where it is
+    memcpy(buffer->data + buffer->used, bytes, length);
+    buffer->used += length;
+    buffer->data[buffer->used] = '\0';
+    str->contents = lhs->contents;
+    str->buffer = buffer;
+    return;
+  }
+
+  // a string that has been appended to once is likely to be appended to
+  // again, one that never has gets an exact fit
+  size_t capacity = (buffer != NULL ? 2 * total : total) + 1;
+  StringBuffer *grown = malloc(sizeof(StringBuffer) + capacity);
+  memcpy(grown->data, lhs->contents, lhs->length);
+  memcpy(grown->data + lhs->length, bytes, length);
+  grown->data[total] = '\0';
+  grown->used = total;
+  grown->capacity = capacity;
+  str->contents = grown->data;
+  str->buffer = grown;
+}
+
+String *str_append_raw(String *lhs, const char *bytes, size_t length) {
+  String *str = make_string_length_raw(NULL, 0);
+  append_to_buffer(str, lhs, bytes, length);
+  return str;
+}
+
+/*
+ * Like str_append_raw, but makes the string object too. A result of up to
+ * SHORT_STRING_MAX bytes that can't be appended in place is copied into the
+ * object's own allocation (see make_string_block) rather than into a new
+ * StringBuffer, so concatenating short strings, like building a token a
+ * character at a time, costs one allocation per step.
+ */
+RuntimeObject *str_append(String *lhs, const char *bytes, size_t length) {
+  size_t total = lhs->length + length;
+  if (total > SHORT_STRING_MAX || fits_in_place(lhs, length)) {
+    RuntimeObject *obj = make_string_block(0);
+    append_to_buffer(obj->value.v_str, lhs, bytes, length);
+    return obj;
+  }
+  RuntimeObject *obj = make_string_block(total + 1);
+  String *str = obj->value.v_str;
+  memcpy(str->contents, lhs->contents, lhs->length);
+  memcpy(str->contents + lhs->length, bytes, length);
+  str->contents[total] = '\0';
+  str->length = total;
+  return obj;
+}
+
 String *str_concat_raw(String *lhs, String *rhs) {
-  char *new_str = strdupcat(lhs->contents, rhs->contents);
-  return make_string_nocopy_raw(new_str);
+  return str_append_raw(lhs, rhs->contents, rhs->length);
+}
+
+// Append the text of obj to acc, formatting numbers straight into it.
+static String *append_text(String *acc, RuntimeObject *obj) {
+  char buffer[FORMAT_FLOAT_MAX];
+  switch (obj->type) {
+  case T_INT:
+    return str_append_raw(acc, buffer, format_int(buffer, obj->value.v_int));
+  case T_FLOAT:
+    return str_append_raw(acc, buffer,
+                          format_float(buffer, obj->value.v_float));
+  default:
+    return str_concat_raw(acc, to_string_raw(obj));
+  }
 }
 
 String *to_string_raw(RuntimeObject *obj) {
-  char buffer[256];
+  char buffer[FORMAT_FLOAT_MAX];
   switch (obj->type) {
   case T_NOTHING: {
     return make_string_raw(STRING_NOTHING);
@@ -51,91 +172,100 @@ String *to_string_raw(RuntimeObject *obj) {
                              : make_string_raw(STRING_FALSE);
   } break;
   case T_FLOAT: {
-    snprintf(buffer, sizeof(buffer), "%.1f", obj->value.v_float);
+    format_float(buffer, obj->value.v_float);
     return make_string_raw(buffer);
     break;
   } break;
   case T_INT: {
-    snprintf(buffer, sizeof(buffer), "%lld", obj->value.v_int);
+    format_int(buffer, obj->value.v_int);
     return make_string_raw(buffer);
   } break;
   case T_STRING: {
     return obj->value.v_str;
   } break;
+  case T_BYTES: {
+    // a copy, since the bytes can change and the string can't
+    return bytes_to_string_raw(obj->value.v_bytes);
+  } break;
   case T_VECTOR: {
     // start a string accumulator, with an opening bracket
     String *acc = make_string_raw("[");
 
-    size_t length = obj->value.v_vec->size;
-    RuntimeObject *vec = obj->value.v_vec->contents;
+    Vector *vec = obj->value.v_vec;
+    size_t length = vec->size;
 
     for (size_t i = 0; i < length; ++i) {
-      RuntimeObject *elem = &vec[i];
+      RuntimeObject elem_value;
+      vec_get(vec, i, &elem_value);
+      RuntimeObject *elem = &elem_value;
 
       // check if elem is a string
-      bool is_str = elem->type == T_STRING;
+      bool is_str = elem->type == T_STRING || elem->type == T_BYTES;
 
       // add opening quote if string
       if (is_str) {
-        acc = str_concat_raw(acc, make_string_raw("\""));
+        acc = str_append_raw(acc, "\"", 1);
       }
 
-      acc = str_concat_raw(acc, to_string_raw(elem));
+      acc = append_text(acc, elem);
 
       // add closing quote if string
       if (is_str) {
-        acc = str_concat_raw(acc, make_string_raw("\""));
+        acc = str_append_raw(acc, "\"", 1);
       }
 
       // add comma separator unless we're on the last element
       if (i != length - 1) {
-        acc = str_concat_raw(acc, make_string_raw(", "));
+        acc = str_append_raw(acc, ", ", 2);
       }
     }
 
     // add the closing bracket and then return
-    acc = str_concat_raw(acc, make_string_raw("]"));
+    acc = str_append_raw(acc, "]", 1);
     return acc;
     break;
   } break;
   case T_DICT: {
     // start a string accumulator, with an opening bracket
     String *acc = make_string_raw("{");
-    Vector *keys = dict_keys(obj)->value.v_vec;
+    Dict *dict = obj->value.v_dict;
 
-    for (size_t i = 0; i < keys->size; ++i) {
-      RuntimeObject *key_obj = &keys->contents[i];
-      String *key_hash = get_dict_key(key_obj);
-      RuntimeObject *value_obj =
-          dict_get(obj->value.v_dict, key_hash->contents);
+    size_t printed = 0;
+    for (size_t i = 0; i < dict->used; ++i) {
+      RuntimeObject *key_obj = &dict->entries[i].key;
+      RuntimeObject *value_obj = dict->entries[i].value;
+      if (value_obj == NULL) {
+        continue; // removed
+      }
 
       bool key_is_str = key_obj->type == T_STRING;
-      bool value_is_str = value_obj->type == T_STRING;
+      bool value_is_str =
+          value_obj->type == T_STRING || value_obj->type == T_BYTES;
 
       if (key_is_str) {
-        acc = str_concat_raw(acc, make_string_raw("\""));
+        acc = str_append_raw(acc, "\"", 1);
       }
-      acc = str_concat_raw(acc, to_string_raw(key_obj));
+      acc = append_text(acc, key_obj);
       if (key_is_str) {
-        acc = str_concat_raw(acc, make_string_raw("\""));
+        acc = str_append_raw(acc, "\"", 1);
       }
-      acc = str_concat_raw(acc, make_string_raw(": "));
+      acc = str_append_raw(acc, ": ", 2);
 
       if (value_is_str) {
-        acc = str_concat_raw(acc, make_string_raw("\""));
+        acc = str_append_raw(acc, "\"", 1);
       }
-      acc = str_concat_raw(acc, to_string_raw(value_obj));
+      acc = append_text(acc, value_obj);
       if (value_is_str) {
-        acc = str_concat_raw(acc, make_string_raw("\""));
+        acc = str_append_raw(acc, "\"", 1);
       }
 
       // add comma separator unless we're on the last element
-      if (i != keys->size - 1) {
-        acc = str_concat_raw(acc, make_string_raw(", "));
+      if (++printed != dict->size) {
+        acc = str_append_raw(acc, ", ", 2);
       }
     }
     // add the closing bracket and then return
-    acc = str_concat_raw(acc, make_string_raw("}"));
+    acc = str_append_raw(acc, "}", 1);
     return acc;
   } break;
   case T_MODULE: {
@@ -143,10 +273,212 @@ String *to_string_raw(RuntimeObject *obj) {
     return make_string_raw(strdupcat("module:", name));
   } break;
   case T_FUNCTION: {
-    char *signature = obj->value.v_func.signature;
+    char *signature = obj->value.v_func->signature;
     signature = signature == NULL ? "(Signature Unknown)" : signature;
     return make_string_raw(strdupcat("function:", signature));
   } break;
   }
   return make_string_raw("NOT_IMPLEMENTED");
 }
+
+/*
+ * String methods. Results that are part of the receiver (substr, split, trim)
+ * are views of it, see str_view_raw; searching goes through bytes_find.
+ */
+
+// The string argument of a method, or a runtime error naming the method.
+static String *string_arg(RuntimeObject *arg, char *error) {
+  if (arg->type != T_STRING) {
+    runtime_error(error);
+  }
+  return arg->value.v_str;
+}
+
+static RuntimeObject *make_view(String *parent, char *contents, size_t length) {
+  RuntimeObject *obj = make_string_block(0);
+  string_init(obj->value.v_str, contents, length);
+  obj->value.v_str->buffer = parent->buffer;
+  return obj;
+}
+
+RuntimeObject *str_substr(RuntimeObject *self, RuntimeObject *start,
+                          RuntimeObject *count) {
+  String *str = self->value.v_str;
+  if (start->type != T_INT || count->type != T_INT) {
+    runtime_error("substr() needs an int start and count.");
+  }
+  if (start->value.v_int < 0 || (size_t)start->value.v_int > str->length) {
+    runtime_error("substr() start out of bounds.");
+  }
+  if (count->value.v_int < 0) {
+    runtime_error("substr() count must not be negative.");
+  }
+  // like std::string::substr, a count past the end takes the rest
+  size_t from = (size_t)start->value.v_int;
+  size_t rest = str->length - from;
+  size_t length =
+      (size_t)count->value.v_int < rest ? (size_t)count->value.v_int : rest;
+  return make_view(str, str->contents + from, length);
+}
+
+RuntimeObject *str_find(RuntimeObject *self, RuntimeObject *needle) {
+  String *str = self->value.v_str;
+  String *sub = string_arg(needle, "find() needs a string.");
+  const char *at = bytes_find(str->contents, str->length, sub->contents,
+                              sub->length);
+  return make_int(at != NULL ? at - str->contents : -1);
+}
+
+RuntimeObject *str_contains(RuntimeObject *self, RuntimeObject *needle) {
+  String *str = self->value.v_str;
+  String *sub = string_arg(needle, "contains() needs a string.");
+  return make_bool(bytes_find(str->contents, str->length, sub->contents,
+                              sub->length) != NULL);
+}
+
+RuntimeObject *str_starts_with(RuntimeObject *self, RuntimeObject *prefix) {
+  String *str = self->value.v_str;
+  String *sub = string_arg(prefix, "starts_with() needs a string.");
+  return make_bool(sub->length <= str->length &&
+                   memcmp(str->contents, sub->contents, sub->length) == 0);
+}
+
+RuntimeObject *str_ends_with(RuntimeObject *self, RuntimeObject *suffix) {
+  String *str = self->value.v_str;
+  String *sub = string_arg(suffix, "ends_with() needs a string.");
+  return make_bool(sub->length <= str->length &&
+                   memcmp(str->contents + str->length - sub->length,
+                          sub->contents, sub->length) == 0);
+}
+
+RuntimeObject *str_split(RuntimeObject *self, RuntimeObject *separator) {
+  String *str = self->value.v_str;
+  String *sep = string_arg(separator, "split() needs a string.");
+  if (sep->length == 0) {
+    runtime_error("split() needs a non-empty separator.");
+  }
+  RuntimeObject *parts = make_vector();
+  RuntimeObject part = {.type = T_STRING};
+  char *from = str->contents;
+  char *end = str->contents + str->length;
+  const char *at;
+  while ((at = bytes_find(from, end - from, sep->contents, sep->length))) {
+    part.value.v_str = str_view_raw(str, from, at - from);
+    vec_append(parts, &part);
+    from = (char *)at + sep->length;
+  }
+  part.value.v_str = str_view_raw(str, from, end - from);
+  vec_append(parts, &part);
+  return parts;
+}
+
+RuntimeObject *str_join(RuntimeObject *self, RuntimeObject *parts) {
+  String *sep = self->value.v_str;
+  if (parts->type != T_VECTOR) {
+    runtime_error("join() needs a vector of strings.");
+  }
+  Vector *vec = parts->value.v_vec;
+  if (vec->size == 0) {
+    return make_string("");
+  }
+  // packed vectors hold numbers, which aren't strings either
+  size_t total = sep->length * (vec->size - 1);
+  for (size_t i = 0; i < vec->size; ++i) {
+    if (vec->packed != T_NOTHING || vec->contents[i].type != T_STRING) {
+      runtime_error("join() needs a vector of strings.");
+    }
+    total += vec->contents[i].value.v_str->length;
+  }
+
+  RuntimeObject *joined = make_string_block(total + 1);
+  char *out = joined->value.v_str->contents;
+  for (size_t i = 0; i < vec->size; ++i) {
+    String *part = vec->contents[i].value.v_str;
+    if (i != 0) {
+      memcpy(out, sep->contents, sep->length);
+      out += sep->length;
+    }
+    memcpy(out, part->contents, part->length);
+    out += part->length;
+  }
+  *out = '\0';
+  joined->value.v_str->length = total;
+  return joined;
+}
+
+RuntimeObject *str_replace(RuntimeObject *self, RuntimeObject *from,
+                           RuntimeObject *to) {
+  String *str = self->value.v_str;
+  String *target = string_arg(from, "replace() needs two strings.");
+  String *replacement = string_arg(to, "replace() needs two strings.");
+  if (target->length == 0) {
+    runtime_error("replace() needs a non-empty string to replace.");
+  }
+
+  // count the matches first so the result is allocated once
+  char *end = str->contents + str->length;
+  size_t matches = 0;
+  for (const char *at = str->contents;
+       (at = bytes_find(at, end - at, target->contents, target->length));
+       at += target->length) {
+    ++matches;
+  }
+  if (matches == 0) {
+    return make_view(str, str->contents, str->length);
+  }
+
+  size_t total =
+      str->length - matches * target->length + matches * replacement->length;
+  RuntimeObject *replaced = make_string_block(total + 1);
+  char *out = replaced->value.v_str->contents;
+  const char *from_at = str->contents;
+  const char *at;
+  while ((at = bytes_find(from_at, end - from_at, target->contents,
+                          target->length))) {
+    memcpy(out, from_at, at - from_at);
+    out += at - from_at;
+    memcpy(out, replacement->contents, replacement->length);
+    out += replacement->length;
+    from_at = at + target->length;
+  }
+  memcpy(out, from_at, end - from_at);
+  out[end - from_at] = '\0';
+  replaced->value.v_str->length = total;
+  return replaced;
+}
+
+// The whitespace trim() removes, the same as C's isspace in the "C" locale.
+static inline bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+RuntimeObject *str_trim(RuntimeObject *self) {
+  String *str = self->value.v_str;
+  char *start = str->contents;
+  char *end = str->contents + str->length;
+  while (start < end && is_space(*start)) {
+    ++start;
+  }
+  while (end > start && is_space(end[-1])) {
+    --end;
+  }
+  return make_view(str, start, end - start);
+}
+
+// The line that starts at byte `start`, up to but not including its "\n".
+// Moving start past the line and its newline walks a string a line at a
+// time without splitting it up front.
+RuntimeObject *str_next_line(RuntimeObject *self, RuntimeObject *start) {
+  String *str = self->value.v_str;
+  if (start->type != T_INT) {
+    runtime_error("next_line() needs an int start.");
+  }
+  if (start->value.v_int < 0 || (size_t)start->value.v_int > str->length) {
+    runtime_error("next_line() start out of bounds.");
+  }
+  char *from = str->contents + start->value.v_int;
+  char *end = str->contents + str->length;
+  char *at = memchr(from, '\n', end - from);
+  return make_view(str, from, (at != NULL ? at : end) - from);
+}
@@ -0,0 +1,91 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rtutil.h"
+
+/*
+ * Substring search behind the string methods (find, contains, split and
+ * replace).
+ *
+ * Single bytes go to memchr, which the C library already vectorizes. Longer
+ * needles are matched a block of haystack positions at a time: the block is
+ * compared against the needle's first byte and, shifted by the needle's
+ * length, against its last byte, and only the positions where both match are
+ * checked in full. Text rarely matches both, so most blocks cost two vector
+ * compares; the scalar fallback does the same filtering with memchr on the
+ * first byte.
+ */
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SCAN_BLOCK 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SCAN_BLOCK 16
+#endif
+
+// Is the needle at the position? Its first and last bytes already matched.
+static inline int middle_matches(const char *at, const char *needle,
+                                 size_t length) {
+  return memcmp(at + 1, needle + 1, length - 2) == 0;
+}
+
+const char *bytes_find(const char *haystack, size_t n, const char *needle,
+                       size_t length) {
+  if (length == 0) {
+    return haystack;
+  }
+  if (length > n) {
+    return NULL;
+  }
+  if (length == 1) {
+    return memchr(haystack, needle[0], n);
+  }
+
+  // the needle can start at positions 0 to last
+  size_t last = n - length;
+  size_t i = 0;
+#if defined(SCAN_BLOCK)
+#if defined(__AVX2__)
+  const __m256i first = _mm256_set1_epi8(needle[0]);
+  const __m256i final = _mm256_set1_epi8(needle[length - 1]);
+  for (; i + SCAN_BLOCK - 1 <= last; i += SCAN_BLOCK) {
+    __m256i starts = _mm256_loadu_si256((const __m256i *)(haystack + i));
+    __m256i ends =
+        _mm256_loadu_si256((const __m256i *)(haystack + i + length - 1));
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(
+        _mm256_cmpeq_epi8(starts, first), _mm256_cmpeq_epi8(ends, final)));
+#else
+  const __m128i first = _mm_set1_epi8(needle[0]);
+  const __m128i final = _mm_set1_epi8(needle[length - 1]);
+  for (; i + SCAN_BLOCK - 1 <= last; i += SCAN_BLOCK) {
+    __m128i starts = _mm_loadu_si128((const __m128i *)(haystack + i));
+    __m128i ends =
+        _mm_loadu_si128((const __m128i *)(haystack + i + length - 1));
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(
+        _mm_cmpeq_epi8(starts, first), _mm_cmpeq_epi8(ends, final)));
+#endif
+    // candidates in order, lowest position first
+    while (mask != 0) {
+      size_t at = i + (size_t)__builtin_ctz(mask);
+      if (middle_matches(haystack + at, needle, length)) {
+        return haystack + at;
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+  while (i <= last) {
+    const char *at = memchr(haystack + i, needle[0], last - i + 1);
+    if (at == NULL) {
+      return NULL;
+    }
+    if (at[length - 1] == needle[length - 1] &&
+        middle_matches(at, needle, length)) {
+      return at;
+    }
+    i = (size_t)(at - haystack) + 1;
+  }
+  return NULL;
+}
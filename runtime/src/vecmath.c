@@ -0,0 +1,319 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtutil.h"
+
+/*
+ * Kernels behind the numeric vector methods (sum, min, max, dot, count and
+ * fill), working directly on packed vector storage.
+ *
+ * Float reductions are done in VEC_LANES interleaved partial results: lane k
+ * takes elements k, k + VEC_LANES, k + 2 * VEC_LANES, ... and the lanes are
+ * combined pairwise at the end, (l0 . l1) . (l2 . l3). That is the order one
+ * AVX2 register (or a pair of SSE2 registers) computes in, and the scalar
+ * fallback and the interpreter follow it as well, so a float result doesn't
+ * depend on the instruction set the runtime was built for, or on the backend.
+ * Integer results don't depend on the order at all; they wrap on overflow
+ * like op_add does.
+ */
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// min keeps x if x < acc and max if x > acc, acc otherwise (so NaNs in x are
+// skipped), exactly like the MINPD/MAXPD instructions with x first.
+static inline double pick_min(double x, double acc) { return x < acc ? x : acc; }
+static inline double pick_max(double x, double acc) { return x > acc ? x : acc; }
+
+// Folds the elements from `from` on into lanes, element i into lane
+// i % VEC_LANES. `from` is a multiple of VEC_LANES.
+#define FOLD_TAIL(lanes, elems, from, n, FOLD)                                 \
+  for (size_t i = (from); i < (n); ++i) {                                      \
+    (lanes)[i % VEC_LANES] = FOLD((lanes)[i % VEC_LANES], (elems)[i]);         \
+  }
+
+#define FOLD_ADD(acc, x) ((acc) + (x))
+#define FOLD_MIN(acc, x) pick_min((x), (acc))
+#define FOLD_MAX(acc, x) pick_max((x), (acc))
+
+// How many elements the vector loops handle, the rest go through FOLD_TAIL.
+static inline size_t whole_blocks(size_t n) { return n - n % VEC_LANES; }
+
+int64_t ints_sum(const int64_t *elems, size_t n) {
+  uint64_t sum = 0;
+  size_t i = 0;
+#if defined(__AVX2__)
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 4 <= n; i += 4) {
+    acc = _mm256_add_epi64(acc, _mm256_loadu_si256((const __m256i *)&elems[i]));
+  }
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+  sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__SSE2__)
+  __m128i acc = _mm_setzero_si128();
+  for (; i + 2 <= n; i += 2) {
+    acc = _mm_add_epi64(acc, _mm_loadu_si128((const __m128i *)&elems[i]));
+  }
+  uint64_t lanes[2];
+  _mm_storeu_si128((__m128i *)lanes, acc);
+  sum = lanes[0] + lanes[1];
+#endif
+  for (; i < n; ++i) {
+    sum += (uint64_t)elems[i];
+  }
+  return (int64_t)sum;
+}
+
+double floats_sum(const double *elems, size_t n) {
+  double lanes[VEC_LANES] = {0.0, 0.0, 0.0, 0.0};
+  size_t blocks = whole_blocks(n);
+#if defined(__AVX2__)
+  __m256d acc = _mm256_setzero_pd();
+  for (size_t i = 0; i < blocks; i += 4) {
+    acc = _mm256_add_pd(acc, _mm256_loadu_pd(&elems[i]));
+  }
+  _mm256_storeu_pd(lanes, acc);
+#elif defined(__SSE2__)
+  __m128d lo = _mm_setzero_pd(), hi = _mm_setzero_pd();
+  for (size_t i = 0; i < blocks; i += 4) {
+    lo = _mm_add_pd(lo, _mm_loadu_pd(&elems[i]));
+    hi = _mm_add_pd(hi, _mm_loadu_pd(&elems[i + 2]));
+  }
+  _mm_storeu_pd(&lanes[0], lo);
+  _mm_storeu_pd(&lanes[2], hi);
+#else
+  blocks = 0;
+#endif
+  FOLD_TAIL(lanes, elems, blocks, n, FOLD_ADD);
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+int64_t ints_min(const int64_t *elems, size_t n) {
+  int64_t min = elems[0];
+  size_t i = 0;
+#if defined(__AVX2__)
+  __m256i acc = _mm256_set1_epi64x(min);
+  for (; i + 4 <= n; i += 4) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)&elems[i]);
+    acc = _mm256_blendv_epi8(acc, x, _mm256_cmpgt_epi64(acc, x));
+  }
+  int64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+  for (size_t k = 0; k < 4; ++k) {
+    min = lanes[k] < min ? lanes[k] : min;
+  }
+#endif
+  // SSE2 has no 64-bit integer compare, so there this is all scalar
+  for (; i < n; ++i) {
+    min = elems[i] < min ? elems[i] : min;
+  }
+  return min;
+}
+
+int64_t ints_max(const int64_t *elems, size_t n) {
+  int64_t max = elems[0];
+  size_t i = 0;
+#if defined(__AVX2__)
+  __m256i acc = _mm256_set1_epi64x(max);
+  for (; i + 4 <= n; i += 4) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)&elems[i]);
+    acc = _mm256_blendv_epi8(acc, x, _mm256_cmpgt_epi64(x, acc));
+  }
+  int64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+  for (size_t k = 0; k < 4; ++k) {
+    max = lanes[k] > max ? lanes[k] : max;
+  }
+#endif
+  for (; i < n; ++i) {
+    max = elems[i] > max ? elems[i] : max;
+  }
+  return max;
+}
+
+double floats_min(const double *elems, size_t n) {
+  double lanes[VEC_LANES] = {elems[0], elems[0], elems[0], elems[0]};
+  size_t blocks = whole_blocks(n);
+#if defined(__AVX2__)
+  __m256d acc = _mm256_set1_pd(elems[0]);
+  for (size_t i = 0; i < blocks; i += 4) {
+    acc = _mm256_min_pd(_mm256_loadu_pd(&elems[i]), acc);
+  }
+  _mm256_storeu_pd(lanes, acc);
+#elif defined(__SSE2__)
+  __m128d lo = _mm_set1_pd(elems[0]), hi = lo;
+  for (size_t i = 0; i < blocks; i += 4) {
+    lo = _mm_min_pd(_mm_loadu_pd(&elems[i]), lo);
+    hi = _mm_min_pd(_mm_loadu_pd(&elems[i + 2]), hi);
+  }
+  _mm_storeu_pd(&lanes[0], lo);
+  _mm_storeu_pd(&lanes[2], hi);
+#else
+  blocks = 0;
+#endif
+  FOLD_TAIL(lanes, elems, blocks, n, FOLD_MIN);
+  return pick_min(pick_min(lanes[3], lanes[2]), pick_min(lanes[1], lanes[0]));
+}
+
+double floats_max(const double *elems, size_t n) {
+  double lanes[VEC_LANES] = {elems[0], elems[0], elems[0], elems[0]};
+  size_t blocks = whole_blocks(n);
+#if defined(__AVX2__)
+  __m256d acc = _mm256_set1_pd(elems[0]);
+  for (size_t i = 0; i < blocks; i += 4) {
+    acc = _mm256_max_pd(_mm256_loadu_pd(&elems[i]), acc);
+  }
+  _mm256_storeu_pd(lanes, acc);
+#elif defined(__SSE2__)
+  __m128d lo = _mm_set1_pd(elems[0]), hi = lo;
+  for (size_t i = 0; i < blocks; i += 4) {
+    lo = _mm_max_pd(_mm_loadu_pd(&elems[i]), lo);
+    hi = _mm_max_pd(_mm_loadu_pd(&elems[i + 2]), hi);
+  }
+  _mm_storeu_pd(&lanes[0], lo);
+  _mm_storeu_pd(&lanes[2], hi);
+#else
+  blocks = 0;
+#endif
+  FOLD_TAIL(lanes, elems, blocks, n, FOLD_MAX);
+  return pick_max(pick_max(lanes[3], lanes[2]), pick_max(lanes[1], lanes[0]));
+}
+
+int64_t ints_dot(const int64_t *lhs, const int64_t *rhs, size_t n) {
+  // there's no 64-bit multiply below AVX-512, leave this one to the compiler
+  uint64_t dot = 0;
+  for (size_t i = 0; i < n; ++i) {
+    dot += (uint64_t)lhs[i] * (uint64_t)rhs[i];
+  }
+  return (int64_t)dot;
+}
+
+double floats_dot(const double *lhs, const double *rhs, size_t n) {
+  double lanes[VEC_LANES] = {0.0, 0.0, 0.0, 0.0};
+  size_t blocks = whole_blocks(n);
+#if defined(__AVX2__)
+  // a separate multiply and add rather than FMA, to round like the fallback
+  __m256d acc = _mm256_setzero_pd();
+  for (size_t i = 0; i < blocks; i += 4) {
+    __m256d product =
+        _mm256_mul_pd(_mm256_loadu_pd(&lhs[i]), _mm256_loadu_pd(&rhs[i]));
+    acc = _mm256_add_pd(acc, product);
+  }
+  _mm256_storeu_pd(lanes, acc);
+#elif defined(__SSE2__)
+  __m128d lo = _mm_setzero_pd(), hi = _mm_setzero_pd();
+  for (size_t i = 0; i < blocks; i += 4) {
+    lo = _mm_add_pd(lo, _mm_mul_pd(_mm_loadu_pd(&lhs[i]), _mm_loadu_pd(&rhs[i])));
+    hi = _mm_add_pd(
+        hi, _mm_mul_pd(_mm_loadu_pd(&lhs[i + 2]), _mm_loadu_pd(&rhs[i + 2])));
+  }
+  _mm_storeu_pd(&lanes[0], lo);
+  _mm_storeu_pd(&lanes[2], hi);
+#else
+  blocks = 0;
+#endif
+  for (size_t i = blocks; i < n; ++i) {
+    double product = lhs[i] * rhs[i];
+    lanes[i % VEC_LANES] += product;
+  }
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+size_t ints_count(const int64_t *elems, size_t n, int64_t value) {
+  size_t count = 0;
+  size_t i = 0;
+#if defined(__AVX2__)
+  // matching lanes compare to -1, so subtracting counts them
+  __m256i needle = _mm256_set1_epi64x(value);
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 4 <= n; i += 4) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)&elems[i]);
+    acc = _mm256_sub_epi64(acc, _mm256_cmpeq_epi64(x, needle));
+  }
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+  count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__SSE2__)
+  // SSE2 only compares 32 bits at a time: a 64-bit lane matches if both its
+  // halves do, so AND the comparison with itself halves swapped
+  __m128i needle = _mm_set1_epi64x(value);
+  __m128i acc = _mm_setzero_si128();
+  for (; i + 2 <= n; i += 2) {
+    __m128i eq32 =
+        _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)&elems[i]), needle);
+    __m128i eq64 =
+        _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1)));
+    acc = _mm_sub_epi64(acc, eq64);
+  }
+  uint64_t lanes[2];
+  _mm_storeu_si128((__m128i *)lanes, acc);
+  count = lanes[0] + lanes[1];
+#endif
+  for (; i < n; ++i) {
+    count += elems[i] == value;
+  }
+  return count;
+}
+
+size_t floats_count(const double *elems, size_t n, double value) {
+  size_t count = 0;
+  size_t i = 0;
+#if defined(__AVX2__)
+  __m256d needle = _mm256_set1_pd(value);
+  for (; i + 4 <= n; i += 4) {
+    int mask = _mm256_movemask_pd(
+        _mm256_cmp_pd(_mm256_loadu_pd(&elems[i]), needle, _CMP_EQ_OQ));
+    count += __builtin_popcount(mask);
+  }
+#elif defined(__SSE2__)
+  __m128d needle = _mm_set1_pd(value);
+  for (; i + 2 <= n; i += 2) {
+    int mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(&elems[i]), needle));
+    count += __builtin_popcount(mask);
+  }
+#endif
+  for (; i < n; ++i) {
+    count += elems[i] == value;
+  }
+  return count;
+}
+
+void ints_fill(int64_t *elems, size_t n, int64_t value) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  __m256i x = _mm256_set1_epi64x(value);
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_si256((__m256i *)&elems[i], x);
+  }
+#elif defined(__SSE2__)
+  __m128i x = _mm_set1_epi64x(value);
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_si128((__m128i *)&elems[i], x);
+  }
+#endif
+  for (; i < n; ++i) {
+    elems[i] = value;
+  }
+}
+
+void floats_fill(double *elems, size_t n, double value) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  __m256d x = _mm256_set1_pd(value);
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(&elems[i], x);
+  }
+#elif defined(__SSE2__)
+  __m128d x = _mm_set1_pd(value);
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(&elems[i], x);
+  }
+#endif
+  for (; i < n; ++i) {
+    elems[i] = value;
+  }
+}
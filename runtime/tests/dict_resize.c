@@ -0,0 +1,74 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "datatype.h"
+#include "dictionary.h"
+#include "runtime.h"
+
+/*
+ * Grows a dict through incremental resizes, including one where the new index
+ * fills up while entries are still waiting to be migrated into it, and checks
+ * that every key can still be found. Inserts never outpace the migration with
+ * the default step, so the test sets dict_migrate_step to hold it back.
+ */
+
+static Dict dict;
+static size_t inserted = 0;
+
+static void insert() {
+  RuntimeObject key = {.type = T_INT, .value.v_int = (int64_t)inserted};
+  dict_set(&dict, &key, make_int((int64_t)inserted * 10));
+  inserted++;
+}
+
+static bool all_found(const char *when) {
+  for (size_t i = 0; i < inserted; ++i) {
+    RuntimeObject key = {.type = T_INT, .value.v_int = (int64_t)i};
+    RuntimeObject *value = dict_get(&dict, &key);
+    if (value == NULL || value->value.v_int != (int64_t)i * 10) {
+      fprintf(stderr, "%s: key %zu of %zu not found\n", when, i, inserted);
+      return false;
+    }
+  }
+  return dict.size == inserted;
+}
+
+int main() {
+  dict_incremental_resize_min = 0;
+  dict_init(&dict, 0);
+
+  // start a resize, and migrate a few entries but not all of them
+  dict_migrate_step = 0;
+  while (dict.old_ctrl == NULL) {
+    insert();
+  }
+  dict_migrate_step = 1;
+  for (size_t i = 0; i < 3; ++i) {
+    insert();
+  }
+  dict_migrate_step = 0;
+  if (dict.migrated == 0 || dict.migrated == dict.migrate_end ||
+      !all_found("mid-migration")) {
+    return 1;
+  }
+
+  // fill the new index before the migration is done
+  size_t capacity = dict.capacity;
+  while (dict.capacity == capacity) {
+    insert();
+  }
+  if (!all_found("expanded mid-migration")) {
+    return 1;
+  }
+
+  dict_migrate_step = DICT_MIGRATE_STEP;
+  while (inserted < 10000) {
+    insert();
+  }
+  if (!all_found("after the migrations catch up")) {
+    return 1;
+  }
+  dict_reset(&dict);
+  return 0;
+}
@@ -24,6 +24,14 @@ def report_fail(event: str, msg: str = ""):
     printred(f"- Failed {event}{fmt_msg(msg)}")
 
 
+def test_input(directory: str, file: str):
+    """Standard input for a test: data/<test>.stdin next to it, if there is one."""
+    path = f"{directory}/data/{file.removesuffix('.src')}.stdin"
+    if os.path.exists(path):
+        return open(path, "rb")
+    return subprocess.DEVNULL
+
+
 def run_e2e_test_compiled(directory: str, file: str, root_dir: str):
     global ANY_FAILED
     no_failures = True
@@ -71,10 +79,13 @@ def run_e2e_test_compiled(directory: str, file: str, root_dir: str):
                 print(f"COMPILER STDERR:\n{stderr}\n#\nEND OF STDERR\n#")
             no_failures = False
     else:
+        # tests run in their directory, so they can name data files relative to it
         res = subprocess.run(
             [outfile_path],
+            stdin=test_input(directory, file),
             stdout=subprocess.PIPE,
             stderr=subprocess.PIPE,
+            cwd=directory,
         )
 
         stdout = res.stdout.decode("utf-8")
@@ -116,8 +127,10 @@ def run_e2e_test(directory: str, file: str):
     print(f"Running {file}")
     res = subprocess.run(
         [EXECUTABLE_PATH, "--exec", f"--input={directory}/{file}"],
+        stdin=test_input(directory, file),
         stdout=subprocess.PIPE,
         stderr=subprocess.PIPE,
+        cwd=directory,
     )
 
     stdout = res.stdout.decode("utf-8")
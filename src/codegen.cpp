@@ -1,6 +1,8 @@
 #include <cassert>
 #include <cstddef>
+#include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -28,6 +30,21 @@ static string WORKING_DIRECTORY = std::getenv("PWD");
 static vector<std::pair<string, ASTNode>> toplevel_decls;
 static vector<string> pre_main_init_methods;
 
+// Literal values and named function values are emitted once as static
+// objects at the top of the generated file and referenced by address, so
+// evaluating a constant never allocates. Keyed by a type-prefixed rendering of
+// the value so identical literals share a single object.
+static unordered_map<string, string> constant_pool_ids;
+static unordered_map<string, string> constant_pool_initializers;
+// type tag and C literal of pooled ints and floats, by address
+static unordered_map<string, std::pair<string, string>> constant_pool_scalars;
+static vector<string> constant_pool_decls;
+
+// Dict literals made only of constants are built once at startup (the table
+// layout is the runtime's business, so it can't be written out as static
+// data) and copied-on-write from there.
+static vector<string> constant_init_stmts;
+
 std::string replace_prefix(const std::string &str,
                            const std::string &old_prefix,
                            const std::string &new_prefix) {
@@ -37,6 +54,16 @@ std::string replace_prefix(const std::string &str,
   return str; // unchanged if prefix doesn't match
 }
 
+std::string replace_all(std::string str, const std::string &from,
+                        const std::string &to) {
+  size_t pos = 0;
+  while ((pos = str.find(from, pos)) != std::string::npos) {
+    str.replace(pos, from.length(), to);
+    pos += to.length();
+  }
+  return str;
+}
+
 std::string make_fn_signature_string(const string name,
                                      const vector<string> args) {
   std::stringstream sig;
@@ -77,6 +104,111 @@ bool CompSymbolTable::is_toplevel() {
 CompNodeResult gen_node(ASTNode &node, CompSymbolTable &st);
 CompNodeResult gen_var_lookup(ASTNode &node, CompSymbolTable &st);
 
+void emit(string &s) { (*EMIT_TARGET) << s; }
+
+void emit(const char *s) { (*EMIT_TARGET) << s; }
+
+std::string c_string_literal(const string &value) {
+  std::stringstream literal;
+  literal << '"';
+  for (char c : value) {
+    switch (c) {
+    case '"':
+      literal << "\\\"";
+      break;
+    case '\\':
+      literal << "\\\\";
+      break;
+    case '\n':
+      literal << "\\n";
+      break;
+    case '\t':
+      literal << "\\t";
+      break;
+    default:
+      literal << c;
+    }
+  }
+  literal << '"';
+  return literal.str();
+}
+
+/*
+ * Returns the address of the pooled static object for a constant, declaring
+ * it on first use. `initializer` is the designated initializer for the
+ * RuntimeObject, `support_decls` are any declarations it depends on (e.g. the
+ * String header of a string constant), with $ID substituted for the pooled
+ * object's identifier.
+ */
+string pool_constant(const string &key, const string &initializer,
+                     const string &support_decls = "") {
+  if (constant_pool_ids.contains(key)) {
+    return "&" + constant_pool_ids.at(key);
+  }
+
+  std::stringstream id_ss;
+  id_ss << "L528_CONST" << constant_pool_ids.size();
+  auto id = id_ss.str();
+
+  std::stringstream decl;
+  decl << replace_all(support_decls, "$ID", id);
+  auto resolved_initializer = replace_all(initializer, "$ID", id);
+  decl << "static RuntimeObject " << id << " = " << resolved_initializer
+       << ";\n";
+  constant_pool_decls.push_back(decl.str());
+  constant_pool_ids[key] = id;
+  constant_pool_initializers[id] = resolved_initializer;
+  return "&" + id;
+}
+
+// Initializer of a pooled constant, given the address pool_constant returned.
+string pooled_initializer(const string &address) {
+  return constant_pool_initializers.at(address.substr(1));
+}
+
+string pool_int_constant(int value) {
+  std::stringstream ss;
+  ss << "{.type = T_INT, .value.v_int = " << value << "}";
+  auto address = pool_constant("int:" + std::to_string(value), ss.str());
+  constant_pool_scalars[address] = {"T_INT", std::to_string(value)};
+  return address;
+}
+
+string pool_float_constant(double value) {
+  std::stringstream ss;
+  ss << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+  auto value_str = ss.str();
+  auto address =
+      pool_constant("float:" + value_str,
+                    "{.type = T_FLOAT, .value.v_float = " + value_str + "}");
+  constant_pool_scalars[address] = {"T_FLOAT", value_str};
+  return address;
+}
+
+string pool_function_constant(const string &fn_name, const string &signature) {
+  auto dynamic_fn_name = replace_prefix(fn_name, "L528_", "DL528_");
+  std::stringstream support;
+  support << "RuntimeObject *" << dynamic_fn_name
+          << "(size_t _argc, RuntimeObject *argv[]);\n"
+          << "static Function $ID_fn = {&" << dynamic_fn_name << ", "
+          << c_string_literal(signature) << "};\n";
+  return pool_constant("function:" + fn_name,
+                       "{.type = T_FUNCTION, .value.v_func = &$ID_fn}",
+                       support.str());
+}
+
+void emit_constant_pool() {
+  for (auto &decl : constant_pool_decls) {
+    emit(decl);
+  }
+
+  emit("static void INIT_L528_CONSTANTS() {\n");
+  for (auto &stmt : constant_init_stmts) {
+    emit(stmt);
+  }
+  emit("}\n");
+}
+
 string get_new_label() {
   std::stringstream label;
   label << "L528LAB";
@@ -92,10 +224,6 @@ string get_new_local() {
   return local_id.str();
 }
 
-void emit(string &s) { (*EMIT_TARGET) << s; }
-
-void emit(const char *s) { (*EMIT_TARGET) << s; }
-
 void gen_module_init(string identifier, int module_num, string module_name,
                      CompSymbolTable &t) {
   std::stringstream name;
@@ -105,10 +233,11 @@ void gen_module_init(string identifier, int module_num, string module_name,
   emit(module_init_method_name);
   emit("() {\n");
 
-  // init module and assign to global variable
+  // init module and assign to global variable (main isn't exported)
+  auto num_entries = t.entries.size() - t.entries.contains("main");
   std::stringstream ss;
   ss << identifier << " = make_module(\"" << module_name << "\", "
-     << t.entries.size() << ");\n";
+     << num_entries << ");\n";
   auto init_stmt = ss.str();
   emit(init_stmt);
 
@@ -121,26 +250,35 @@ void gen_module_init(string identifier, int module_num, string module_name,
       continue;
     }
 
-    // handle dynamic functions
-    auto location = entry.location;
-    if (entry.type == CompTableEntryType::FUNC) {
-      auto fn_name = location;
-      auto dynamic_fn_name = replace_prefix(fn_name, "L528_", "DL528_");
-      auto signature = entry.metadata.value();
-      std::stringstream df_init;
-      df_init << "make_function_with_metadata(&" << dynamic_fn_name << ", \""
-              << signature << "\")";
-      location = df_init.str();
+    std::stringstream args;
+    args << "&" << identifier << "->value.v_mod->table.entries[" << i
+         << "], \"" << id << "\", ";
+
+    // variables and constants are looked up in their global, which is also
+    // what static accesses (mod.x) use
+    if (entry.type == CompTableEntryType::VAR ||
+        entry.type == CompTableEntryType::CONST) {
+      auto assignable =
+          entry.type == CompTableEntryType::VAR ? "true" : "false";
+      auto init_stmt = "make_rtste_global(" + args.str() + "&" +
+                       entry.location + ", " + assignable + ");\n";
+      emit(init_stmt);
+    } else {
+      // handle dynamic functions
+      auto location = entry.location;
+      if (entry.type == CompTableEntryType::FUNC) {
+        auto fn_name = location;
+        auto dynamic_fn_name = replace_prefix(fn_name, "L528_", "DL528_");
+        auto signature = entry.metadata.value();
+        std::stringstream df_init;
+        df_init << "make_function_with_metadata(&" << dynamic_fn_name
+                << ", \"" << signature << "\")";
+        location = df_init.str();
+      }
+      auto init_stmt = "make_rtste(" + args.str() + location + ");\n";
+      emit(init_stmt);
     }
 
-    std::stringstream ss;
-    ss << "make_rtste(&" << identifier << "->value.v_mod->table.entries[" << i
-       << "], "
-       << "\"" << id << "\", " << location << ");\n";
-
-    auto entry_init_stmt = ss.str();
-    emit(entry_init_stmt);
-
     // increment location pointer
     i++;
   }
@@ -195,7 +333,11 @@ string get_binary_op_method(TokenType op) {
 }
 
 CompNodeResult gen_top_level(ASTNode &node, CompSymbolTable &st) {
-  emit("#include \"runtime.h\"\n");
+  // The program body is generated into a buffer first so that the constant
+  // pool it populates can be emitted ahead of it.
+  auto emit_target_old = EMIT_TARGET;
+  std::stringstream program_body;
+  EMIT_TARGET = &program_body;
 
   for (auto &child : node.children) {
     gen_node(child, st);
@@ -203,13 +345,15 @@ CompNodeResult gen_top_level(ASTNode &node, CompSymbolTable &st) {
 
   // encode main entrypoint that goes from C main to program main.
   emit("int main(int argc, char **argv) { \n");
+  emit("INIT_L528_CONSTANTS();\n");
 
   // global declarations go here
   for (auto &entry : toplevel_decls) {
     auto rhs = entry.second;
     auto rhs_result = gen_node(rhs, st);
+    auto rhs_loc = rhs_result.result_loc.value();
     std::stringstream stmt;
-    stmt << entry.first << " = " << rhs_result.result_loc.value() << ";\n";
+    stmt << entry.first << " = " << rhs_loc << ";\n";
     auto s = stmt.str();
     emit(s);
   }
@@ -230,6 +374,12 @@ CompNodeResult gen_top_level(ASTNode &node, CompSymbolTable &st) {
   emit("return 0;\n");
   emit("}\n");
 
+  EMIT_TARGET = emit_target_old;
+  emit("#include \"runtime.h\"\n");
+  emit_constant_pool();
+  auto body = program_body.str();
+  emit(body);
+
   return CompNodeResult{};
 }
 
@@ -262,8 +412,8 @@ CompNodeResult gen_function_declare(ASTNode &node, CompSymbolTable &st) {
   auto internal_fn_name = fn_name_ss.str();
   // Add symbol table entry
   auto signature = make_fn_signature_string(name, args);
-  st.entries[name] =
-      CompTableEntry{internal_fn_name, CompTableEntryType::FUNC, signature};
+  st.entries[name] = CompTableEntry{internal_fn_name, CompTableEntryType::FUNC,
+                                    signature, args.size()};
 
   emit("RuntimeObject* ");
   emit(internal_fn_name);
@@ -351,9 +501,13 @@ CompNodeResult gen_module_import(ASTNode &node, CompSymbolTable &st) {
     */
 
     // generate global variable for module, add to symbol table
+    // the module's members are kept so that accesses through the module name
+    // can be resolved at compile time.
     string local_id_str = get_new_local();
-    st.entries[module_name] =
-        CompTableEntry{local_id_str, CompTableEntryType::CONST};
+    auto module_table = std::make_shared<CompSymbolTable>(t);
+    module_table->parent = nullptr;
+    st.entries[module_name] = CompTableEntry{
+        local_id_str, CompTableEntryType::MODULE, {}, {}, module_table};
     std::stringstream declare_stmt;
     declare_stmt << "RuntimeObject* " << local_id_str;
     declare_stmt << ";\n";
@@ -403,9 +557,52 @@ CompNodeResult gen_block(ASTNode &node, CompSymbolTable &st) {
   return CompNodeResult{{}, {}, most_recent_node == NodeType::RETURN};
 }
 
+/*
+ * Resolves a field access into a named import (mod.x, or a.b.x for modules
+ * importing modules) to the member's symbol table entry at compile time.
+ * Returns nothing if the accessee isn't a module known at compile time.
+ */
+std::optional<CompTableEntry> resolve_module_member(ASTNode &node,
+                                                    CompSymbolTable &st) {
+  const size_t LHS = 0, RHS = 1;
+  if (node.type != NodeType::FIELD_ACESS) {
+    return {};
+  }
+
+  auto &lhs = node.children[LHS];
+  std::optional<CompTableEntry> container;
+  if (lhs.type == NodeType::VAR_LOOKUP) {
+    container = st.lookup_symbol(lhs.data.at("identifier").get<string>());
+  } else {
+    container = resolve_module_member(lhs, st);
+  }
+  if (!container.has_value() ||
+      container->type != CompTableEntryType::MODULE) {
+    return {};
+  }
+
+  auto identifier = node.children[RHS].data.at("identifier").get<string>();
+  auto &members = container->module_table->entries;
+  // main is never exported from a module
+  if (identifier == "main" || !members.contains(identifier)) {
+    auto msg = "Bad module lookup, identifier not found: " + identifier;
+    throw std::runtime_error(msg);
+  }
+  return members.at(identifier);
+}
+
+void check_arity(const CompTableEntry &fn, size_t argc) {
+  if (fn.arity.has_value() && fn.arity.value() != argc) {
+    std::stringstream msg;
+    msg << "Wrong number of arguments in call to " << fn.metadata.value()
+        << ": expected " << fn.arity.value() << ", got " << argc;
+    throw std::runtime_error(msg.str());
+  }
+}
+
 CompNodeResult gen_node_lvalue(ASTNode &node, CompSymbolTable &st) {
-  // Lvalue can be either a variable, an index access into a data type (e.g.
-  // x[y]) or a field access into a module (or class later)
+  // Lvalue can be either a variable or a field access into a module (or class
+  // later). Index access lvalues (e.g. x[y]) are handled by gen_index_assign.
   const size_t LHS = 0, RHS = 1;
 
   if (node.type == NodeType::VAR_LOOKUP) {
@@ -424,39 +621,99 @@ CompNodeResult gen_node_lvalue(ASTNode &node, CompSymbolTable &st) {
     return CompNodeResult{var};
   }
 
-  if (node.type == NodeType::INDEX_ACCESS) {
-    auto lhs = gen_node(node.children[LHS], st).result_loc.value();
-    auto rhs = gen_node(node.children[RHS], st).result_loc.value();
-    auto intmdt_id = st.new_intmdt();
-    std::stringstream lvalue;
-    lvalue << "RuntimeObject * " << intmdt_id << " = get_index(" << lhs << ","
-           << rhs << ");\n";
-    auto lvalue_str = lvalue.str();
-    emit(lvalue_str);
-    return CompNodeResult{intmdt_id, {}, 0, false, true};
-  }
-
   if (node.type == NodeType::FIELD_ACESS) {
+    auto member = resolve_module_member(node, st);
+    if (member.has_value() && member->type != CompTableEntryType::VAR) {
+      throw std::runtime_error(
+          "Assignment is not supported on constants or functions.");
+    }
+    if (member.has_value()) {
+      return CompNodeResult{member->location};
+    }
     auto lhs = gen_node(node.children[LHS], st).result_loc.value();
     auto rhs = node.children[RHS].data.at("identifier").get<string>();
+    // the member's slot in the module, which the assignment rebinds
     auto intmdt_id = st.new_intmdt();
     std::stringstream lvalue;
-    lvalue << "RuntimeObject * " << intmdt_id << " = field_access(" << lhs
-           << ", \"" << rhs << "\");\n";
+    lvalue << "RuntimeObject ** " << intmdt_id << " = field_access_lvalue("
+           << lhs << ", \"" << rhs << "\");\n";
     auto lvalue_str = lvalue.str();
     emit(lvalue_str);
-    return CompNodeResult{intmdt_id, {}, 0, false, true};
+    return CompNodeResult{"(*" + intmdt_id + ")"};
   }
 
   throw std::runtime_error("Invalid nodetype for lvalue, must be var lookup, "
                            "index access, or field access.");
 }
 
+// Generates an expression whose value is only read, then dropped, such as an
+// operand or a condition. Index accesses box an element of a packed vector
+// into a temporary of their own instead of a new object, which is safe since
+// the value can't outlive the temporary's next use.
+CompNodeResult gen_operand(ASTNode &node, CompSymbolTable &st) {
+  if (node.type != NodeType::INDEX_ACCESS) {
+    return gen_node(node, st);
+  }
+  const size_t LHS = 0, RHS = 1;
+  auto lhs = gen_node(node.children[LHS], st).result_loc.value();
+  auto rhs = gen_operand(node.children[RHS], st).result_loc.value();
+  auto temp_id = st.new_intmdt();
+  auto decl = "RuntimeObject " + temp_id + ";\n";
+  emit(decl);
+  std::stringstream result;
+  result << "get_index_into(" << lhs << "," << rhs << ",&" << temp_id << ")";
+  auto result_str = result.str();
+  return CompNodeResult{result_str};
+}
+
+CompNodeResult gen_index_assign(ASTNode &node, CompSymbolTable &st) {
+  // x[y] = z goes through set_index rather than writing through a pointer
+  // returned by get_index, so the runtime can see (and act on) every mutation,
+  // e.g. to copy a copy-on-write vector or dict first.
+  const size_t LHS = 0, RHS = 1;
+  const string op_key = "op";
+  auto op = int_to_token_type(node.data.at(op_key).get<int>());
+  auto lhs_node = node.children[LHS];
+
+  // evaluate the container and index once, since a compound assignment reads
+  // and writes the same slot
+  auto container = gen_node(lhs_node.children[LHS], st).result_loc.value();
+  auto index = gen_operand(lhs_node.children[RHS], st).result_loc.value();
+  auto container_id = st.new_intmdt();
+  auto index_id = st.new_intmdt();
+  std::stringstream decls;
+  decls << "RuntimeObject * " << container_id << " = " << container << ";\n"
+        << "RuntimeObject * " << index_id << " = " << index << ";\n";
+  auto decls_str = decls.str();
+  emit(decls_str);
+
+  auto new_value = gen_node(node.children[RHS], st).result_loc.value();
+
+  if (op != TokenType::EQUALS) {
+    auto bin_op = assign_op_to_binary_op(op);
+    auto op_method = get_binary_op_method(bin_op);
+    auto temp_id = st.new_intmdt();
+    auto decl = "RuntimeObject " + temp_id + ";\n";
+    emit(decl);
+    std::stringstream new_value_ss;
+    new_value_ss << op_method << "(get_index_into(" << container_id << ","
+                 << index_id << ",&" << temp_id << ")," << new_value << ")";
+    new_value = new_value_ss.str();
+  }
+
+  std::stringstream assign_statement_ss;
+  assign_statement_ss << "set_index(" << container_id << "," << index_id << ","
+                      << new_value << ");\n";
+  auto assign_statement = assign_statement_ss.str();
+  emit(assign_statement);
+  return CompNodeResult{};
+}
+
 CompNodeResult gen_index_access(ASTNode &node, CompSymbolTable &st) {
   const size_t LHS = 0, RHS = 1;
 
   auto lhs = gen_node(node.children[LHS], st).result_loc.value();
-  auto rhs = gen_node(node.children[RHS], st).result_loc.value();
+  auto rhs = gen_operand(node.children[RHS], st).result_loc.value();
   std::stringstream result;
   result << "get_index(" << lhs << "," << rhs << ")";
   auto result_str = result.str();
@@ -471,6 +728,17 @@ CompNodeResult gen_field_access(ASTNode &node, CompSymbolTable &st) {
   assert(rhs_node.type == NodeType::VAR_LOOKUP);
   string identifier = rhs_node.data.at("identifier").get<string>();
 
+  // members of a named import are known at compile time, so there is no
+  // need to look them up in the module
+  auto member = resolve_module_member(node, st);
+  if (member.has_value() && member->type == CompTableEntryType::FUNC) {
+    auto fn = pool_function_constant(member->location, member->metadata.value());
+    return CompNodeResult{fn, {}, 0, false, true};
+  }
+  if (member.has_value() && member->type != CompTableEntryType::BUILTIN) {
+    return CompNodeResult{member->location};
+  }
+
   std::stringstream result;
   result << "field_access(" << lhs << ", \"" << identifier << "\")";
   auto result_str = result.str();
@@ -481,6 +749,9 @@ CompNodeResult gen_assign_op(ASTNode &node, CompSymbolTable &st) {
   const size_t LHS = 0, RHS = 1;
   const string op_key = "op";
   auto op = int_to_token_type(node.data.at(op_key).get<int>());
+  if (node.children[LHS].type == NodeType::INDEX_ACCESS) {
+    return gen_index_assign(node, st);
+  }
   auto lhs_result = gen_node_lvalue(node.children[LHS], st);
   auto lhs = lhs_result.result_loc.value();
   auto rhs = gen_node(node.children[RHS], st).result_loc.value();
@@ -496,15 +767,7 @@ CompNodeResult gen_assign_op(ASTNode &node, CompSymbolTable &st) {
   }
 
   std::stringstream assign_statement_ss;
-  if (lhs_result.ptr_result) {
-    assign_statement_ss << "*";
-  }
-  assign_statement_ss << lhs << "=";
-  // assign ptr to new address in this case
-  if (lhs_result.ptr_result) {
-    assign_statement_ss << "*";
-  }
-  assign_statement_ss << new_value << ";\n";
+  assign_statement_ss << lhs << "=" << new_value << ";\n";
   auto assign_statement = assign_statement_ss.str();
   emit(assign_statement);
   return CompNodeResult{};
@@ -548,43 +811,161 @@ CompNodeResult gen_var_declare(ASTNode &node, CompSymbolTable &st) {
 CompNodeResult gen_bool_literal(ASTNode &node, CompSymbolTable &st) {
   auto value = node.data.at("value").get<bool>();
   std::stringstream ss;
-  ss << "make_bool(" << value << ")";
-  auto s = ss.str();
-  return CompNodeResult{s};
+  ss << "{.type = T_BOOL, .value.v_bool = " << value << "}";
+  auto s = pool_constant(value ? "bool:true" : "bool:false", ss.str());
+  return CompNodeResult{s, {}, 0, false, true};
 }
 
 CompNodeResult gen_int_literal(ASTNode &node, CompSymbolTable &st) {
   auto value = node.data.at("value").get<int>();
-  std::stringstream ss;
-  ss << "make_int(" << value << ")";
-  auto s = ss.str();
-  return CompNodeResult{s};
+  auto s = pool_int_constant(value);
+  return CompNodeResult{s, {}, 0, false, true};
 }
 
 CompNodeResult gen_float_literal(ASTNode &node, CompSymbolTable &st) {
   auto value = node.data.at("value").get<double>();
-  std::stringstream ss;
-  ss << "make_float(" << value << ")";
-  auto s = ss.str();
-  return CompNodeResult{s};
+  auto s = pool_float_constant(value);
+  return CompNodeResult{s, {}, 0, false, true};
 }
 
 CompNodeResult gen_string_literal(ASTNode &node, CompSymbolTable &st) {
   auto value = node.data.at("value").get<string>();
-  std::stringstream ss;
-  ss << "make_string(\"" << value << "\")";
-  auto s = ss.str();
-  return CompNodeResult{s};
+  auto literal = c_string_literal(value);
+  std::stringstream support;
+  support << "static String $ID_str = {sizeof(" << literal << ") - 1, "
+          << literal << "};\n";
+  bool pooled = constant_pool_ids.contains("string:" + value);
+  auto s = pool_constant("string:" + value,
+                         "{.type = T_STRING, .value.v_str = &$ID_str}",
+                         support.str());
+  // literals are interned before anything can compare or hash them
+  if (!pooled) {
+    auto id = s.substr(1);
+    constant_init_stmts.push_back(id + ".value.v_str = str_intern(" + id +
+                                  ".value.v_str);\n");
+  }
+  return CompNodeResult{s, {}, 0, false, true};
 }
 
 CompNodeResult gen_nothing_literal(ASTNode &node, CompSymbolTable &st) {
-  return CompNodeResult{"make_nothing()"};
+  auto s = pool_constant("nothing", "{.type = T_NOTHING}");
+  return CompNodeResult{s, {}, 0, false, true};
+}
+
+/*
+ * Methods of the built-in data types that generated code calls directly,
+ * keyed by name. The C functions take the receiver as their first parameter.
+ */
+struct BuiltinMethod {
+  string type_tag;
+  string fn_name;
+  size_t argc; // not counting the receiver
+};
+
+static const unordered_map<string, vector<BuiltinMethod>> builtin_methods = {
+    {"length",
+     {{"T_VECTOR", "vec_length", 0},
+      {"T_STRING", "str_length", 0},
+      {"T_BYTES", "bytes_length", 0},
+      {"T_DICT", "dict_length", 0}}},
+    {"append", {{"T_VECTOR", "vec_append", 1}}},
+    {"reserve", {{"T_VECTOR", "vec_reserve", 1}}},
+    {"extend", {{"T_VECTOR", "vec_extend", 1}}},
+    {"pop", {{"T_VECTOR", "vec_pop", 0}}},
+    {"insert", {{"T_VECTOR", "vec_insert", 2}}},
+    {"shrink_to_fit", {{"T_VECTOR", "vec_shrink_to_fit", 0}}},
+    {"sum", {{"T_VECTOR", "vec_sum", 0}}},
+    {"min", {{"T_VECTOR", "vec_min", 0}}},
+    {"max", {{"T_VECTOR", "vec_max", 0}}},
+    {"dot", {{"T_VECTOR", "vec_dot", 1}}},
+    {"count", {{"T_VECTOR", "vec_count", 1}}},
+    {"fill", {{"T_VECTOR", "vec_fill", 2}}},
+    {"sort", {{"T_VECTOR", "vec_sort", 0}}},
+    {"sort_by", {{"T_VECTOR", "vec_sort_by", 1}}},
+    {"contains",
+     {{"T_DICT", "dict_contains", 1}, {"T_STRING", "str_contains", 1}}},
+    {"substr", {{"T_STRING", "str_substr", 2}}},
+    {"find", {{"T_STRING", "str_find", 1}}},
+    {"starts_with", {{"T_STRING", "str_starts_with", 1}}},
+    {"ends_with", {{"T_STRING", "str_ends_with", 1}}},
+    {"split", {{"T_STRING", "str_split", 1}}},
+    {"join", {{"T_STRING", "str_join", 1}}},
+    {"replace", {{"T_STRING", "str_replace", 2}}},
+    {"trim", {{"T_STRING", "str_trim", 0}}},
+    {"next_line", {{"T_STRING", "str_next_line", 1}}},
+    {"slice", {{"T_BYTES", "bytes_slice", 2}}},
+    {"copy_from", {{"T_BYTES", "bytes_copy_from", 2}}},
+    {"to_string", {{"T_BYTES", "bytes_to_string", 0}}},
+    {"keys", {{"T_DICT", "dict_keys", 0}}},
+    {"remove",
+     {{"T_VECTOR", "vec_remove", 1}, {"T_DICT", "dict_remove", 1}}},
+    {"clear", {{"T_VECTOR", "vec_clear", 0}, {"T_DICT", "dict_clear", 0}}},
+};
+
+CompNodeResult gen_method_call(ASTNode &node, CompSymbolTable &st) {
+  // The receiver and arguments are evaluated once, up front. If the method
+  // name belongs to a built-in type, the call is dispatched on the receiver's
+  // type to the C function directly. Otherwise (or for any other type) the
+  // method is looked up at run-time, with the receiver passed as an implicit
+  // first parameter, which the runtime drops again for module members.
+  const size_t FUNCTION = 0, ARGS = 1;
+  const size_t LHS = 0, RHS = 1;
+  auto &lhs = node.children[FUNCTION];
+  auto identifier = lhs.children[RHS].data.at("identifier").get<string>();
+
+  auto receiver = gen_node(lhs.children[LHS], st).result_loc.value();
+  auto receiver_intmdt = st.new_intmdt();
+  std::stringstream decls;
+  decls << "RuntimeObject* " << receiver_intmdt << " = " << receiver << ";\n";
+  vector<string> args;
+  for (auto &arg_node : node.children[ARGS].children) {
+    auto arg = gen_node(arg_node, st).result_loc.value();
+    auto arg_intmdt = st.new_intmdt();
+    decls << "RuntimeObject* " << arg_intmdt << " = " << arg << ";\n";
+    args.push_back(arg_intmdt);
+  }
+
+  auto result_intmdt = st.new_intmdt();
+  decls << "RuntimeObject* " << result_intmdt << ";\n";
+  auto decls_str = decls.str();
+  emit(decls_str);
+
+  std::stringstream call;
+  if (builtin_methods.contains(identifier)) {
+    for (auto &method : builtin_methods.at(identifier)) {
+      // a wrong number of arguments is left for the dynamic path to report
+      if (method.argc != args.size()) {
+        continue;
+      }
+      call << "if (" << receiver_intmdt << "->type == " << method.type_tag
+           << ") " << result_intmdt << " = " << method.fn_name << "("
+           << receiver_intmdt;
+      for (auto &arg : args) {
+        call << ", " << arg;
+      }
+      call << ");\nelse ";
+    }
+  }
+
+  auto argv_intmdt = st.new_intmdt();
+  call << "{\nRuntimeObject* " << argv_intmdt << "[] = {" << receiver_intmdt;
+  for (auto &arg : args) {
+    call << ", " << arg;
+  }
+  call << "};\n"
+       << result_intmdt << " = dynamic_method_call(" << receiver_intmdt
+       << ", \"" << identifier << "\", " << args.size() + 1 << ", "
+       << argv_intmdt << ");\n}\n";
+  auto call_str = call.str();
+  emit(call_str);
+  return CompNodeResult{result_intmdt};
 }
 
 CompNodeResult gen_function_call(ASTNode &node, CompSymbolTable &st) {
   const size_t FUNCTION = 0, ARGS = 1;
   auto lhs = node.children[FUNCTION];
   auto rhs = node.children[ARGS];
+  auto member = resolve_module_member(lhs, st);
   //
   // I guess we'd call this a "known" function call.
   // These are function calls referred to by the name
@@ -610,11 +991,28 @@ CompNodeResult gen_function_call(ASTNode &node, CompSymbolTable &st) {
     }
     auto fn_name = lookup_value.location;
 
-    // TODO: some kind of arg matching?
     auto rhs_result = gen_node(rhs, st);
+    check_arity(lookup_value, rhs_result.argc);
     auto result = fn_name + "(" + rhs_result.result_loc.value() + ")";
     return CompNodeResult{result};
   }
+  //
+  // Calls to functions of a named import (mod.fn()) are also known, and are
+  // made directly rather than through the module's runtime symbol table.
+  //
+  else if (member.has_value() && member->type == CompTableEntryType::FUNC) {
+    auto rhs_result = gen_node(rhs, st);
+    check_arity(member.value(), rhs_result.argc);
+    auto result =
+        member->location + "(" + rhs_result.result_loc.value() + ")";
+    return CompNodeResult{result};
+  }
+  //
+  // Method calls (x.y()) on values only known at run-time.
+  //
+  else if (lhs.type == NodeType::FIELD_ACESS && !member.has_value()) {
+    return gen_method_call(node, st);
+  }
   // Dynamic function call where the function value itself is known only
   // at run-time.
   else {
@@ -631,17 +1029,6 @@ CompNodeResult gen_function_call(ASTNode &node, CompSymbolTable &st) {
     auto argv_intmdt = st.new_intmdt();
     auto argv_arglist = rhs_result.result_loc.value();
 
-    // for x.y(), need to pass x as an implicit first parameter
-    if (lhs.type == NodeType::FIELD_ACESS) {
-      auto new_argv = lhs_result.accessee_loc.value();
-      if (argc == 0) {
-        argv_arglist = new_argv;
-      } else {
-        argv_arglist = new_argv + "," + argv_arglist;
-      }
-      argc++;
-    }
-
     std::stringstream argv;
     argv << "RuntimeObject* " << argv_intmdt << "[] = {" << argv_arglist
          << "};\n";
@@ -666,12 +1053,8 @@ CompNodeResult gen_var_lookup(ASTNode &node, CompSymbolTable &st) {
 
   // TODO: implement this for builtin as well. Will need runtime support
   if (lookup_result->type == CompTableEntryType::FUNC) {
-    auto dynamic_fn_name = replace_prefix(var, "L528_", "DL528_");
-    auto signature = lookup_result->metadata.value();
-    std::stringstream df_init;
-    df_init << "make_function_with_metadata(&" << dynamic_fn_name << ", \""
-            << signature << "\")";
-    var = df_init.str();
+    var = pool_function_constant(var, lookup_result->metadata.value());
+    return CompNodeResult{var, {}, 0, false, true};
   }
   return CompNodeResult{var};
 }
@@ -700,13 +1083,63 @@ CompNodeResult gen_expr_list(ASTNode &node, CompSymbolTable &st) {
 
 CompNodeResult gen_vec_literal(ASTNode &node, CompSymbolTable &st) {
   vector<string> results;
+  bool all_constant = !node.children.empty();
   for (auto &node : node.children) {
     auto result = gen_node(node, st);
     results.push_back(result.result_loc.value());
+    all_constant = all_constant && result.constant;
   }
 
   auto intmdt_id = st.new_intmdt();
 
+  // A literal made only of constants is laid out once as static data, and
+  // each evaluation gets a copy-on-write vector that borrows it. All-int and
+  // all-float literals are laid out packed.
+  if (all_constant) {
+    string packed = "T_NOTHING";
+    if (constant_pool_scalars.contains(results[0])) {
+      packed = constant_pool_scalars.at(results[0]).first;
+      for (auto &result : results) {
+        if (!constant_pool_scalars.contains(result) ||
+            constant_pool_scalars.at(result).first != packed) {
+          packed = "T_NOTHING";
+          break;
+        }
+      }
+    }
+    std::stringstream key, data;
+    key << "vector:";
+    if (packed == "T_INT") {
+      data << "static int64_t $ID_data[] = {";
+    } else if (packed == "T_FLOAT") {
+      data << "static double $ID_data[] = {";
+    } else {
+      data << "static RuntimeObject $ID_data[] = {";
+    }
+    for (auto &result : results) {
+      key << result << ",";
+      if (packed == "T_NOTHING") {
+        data << pooled_initializer(result) << ", ";
+      } else {
+        data << constant_pool_scalars.at(result).second << ", ";
+      }
+    }
+    data << "};\n"
+         << "static Vector $ID_vec = {.size = " << results.size()
+         << ", .internal_size = " << results.size()
+         << ", .contents = (RuntimeObject *)$ID_data, .packed = " << packed
+         << "};\n";
+    auto tmpl = pool_constant(key.str(),
+                              "{.type = T_VECTOR, .value.v_vec = &$ID_vec}",
+                              data.str());
+    std::stringstream decl;
+    decl << "RuntimeObject * " << intmdt_id << " = make_vector_cow(" << tmpl
+         << ");\n";
+    auto decl_str = decl.str();
+    emit(decl_str);
+    return CompNodeResult{intmdt_id};
+  }
+
   std::stringstream decl;
   decl << "RuntimeObject * " << intmdt_id << " = "
        << "make_vector_known_size(" << results.size() << ");\n";
@@ -739,15 +1172,53 @@ CompNodeResult gen_dict_literal(ASTNode &node, CompSymbolTable &st) {
   // iterate two at a time to simulate pairs
   // {a: b, c: d} -> [a, b, c, d]
   vector<std::pair<string, string>> entries;
+  bool all_constant = !child_nodes.empty();
   for (size_t v_index = 1; v_index < child_nodes.size(); v_index += 2) {
     size_t k_index = v_index - 1;
-    auto key = gen_node(child_nodes[k_index], st).result_loc.value();
-    auto value = gen_node(child_nodes[v_index], st).result_loc.value();
-    entries.push_back(std::make_pair(key, value));
+    auto key = gen_node(child_nodes[k_index], st);
+    auto value = gen_node(child_nodes[v_index], st);
+    all_constant = all_constant && key.constant && value.constant;
+    entries.push_back(
+        std::make_pair(key.result_loc.value(), value.result_loc.value()));
   }
 
   // Generate the declaration statement for the actual runtime object.
   auto intmdt_id = st.new_intmdt();
+
+  // Like vectors, all-constant literals copy-on-write from a shared template,
+  // which is built (presized) by INIT_L528_CONSTANTS before main runs.
+  if (all_constant) {
+    std::stringstream key;
+    key << "dict:";
+    for (auto &pair : entries) {
+      key << pair.first << ":" << pair.second << ",";
+    }
+    auto key_str = key.str();
+    string tmpl;
+    if (constant_pool_ids.contains(key_str)) {
+      tmpl = constant_pool_ids.at(key_str);
+    } else {
+      std::stringstream id_ss;
+      id_ss << "L528_CONST" << constant_pool_ids.size();
+      tmpl = id_ss.str();
+      constant_pool_ids[key_str] = tmpl;
+      constant_pool_decls.push_back("static RuntimeObject *" + tmpl + ";\n");
+
+      std::stringstream init;
+      init << tmpl << " = make_dict_known_size(" << entries.size() << ");\n";
+      for (auto &pair : entries) {
+        init << "_dict_put(" << tmpl << ',' << pair.first << ','
+             << pair.second << ");\n";
+      }
+      constant_init_stmts.push_back(init.str());
+    }
+    std::stringstream decl;
+    decl << "RuntimeObject * " << intmdt_id << " = make_dict_cow(" << tmpl
+         << ");\n";
+    auto decl_str = decl.str();
+    emit(decl_str);
+    return CompNodeResult{intmdt_id};
+  }
   std::stringstream decl;
   decl << "RuntimeObject * " << intmdt_id << " = "
        << "make_dict();"
@@ -776,8 +1247,8 @@ CompNodeResult gen_binary_op(ASTNode &node, CompSymbolTable &st) {
   std::stringstream intmdt;
   intmdt << "_intmdt" << st.intermediates;
   st.intermediates++;
-  auto lhs = gen_node(node.children[LHS], st);
-  auto rhs = gen_node(node.children[RHS], st);
+  auto lhs = gen_operand(node.children[LHS], st);
+  auto rhs = gen_operand(node.children[RHS], st);
 
   auto op_method = get_binary_op_method(op);
   auto intmdt_str = intmdt.str();
@@ -797,7 +1268,22 @@ CompNodeResult gen_unary_op(ASTNode &node, CompSymbolTable &st) {
   const size_t RHS = 0;
   const string op_key = "op";
   auto op = int_to_token_type(node.data.at(op_key).get<int>());
-  auto rhs = gen_node(node.children[RHS], st);
+
+  // fold negative numeric literals into constants, so e.g. [-1, 1] is still a
+  // constant vector literal. (-0.0 is left to the runtime, since it doesn't
+  // survive being written out as a C literal.)
+  auto &rhs_node = node.children[RHS];
+  if (op == TokenType::MINUS && rhs_node.type == NodeType::INT_LITERAL) {
+    auto s = pool_int_constant(-rhs_node.data.at("value").get<int>());
+    return CompNodeResult{s, {}, 0, false, true};
+  }
+  if (op == TokenType::MINUS && rhs_node.type == NodeType::FLOAT_LITERAL &&
+      rhs_node.data.at("value").get<double>() != 0.0) {
+    auto s = pool_float_constant(-rhs_node.data.at("value").get<double>());
+    return CompNodeResult{s, {}, 0, false, true};
+  }
+
+  auto rhs = gen_operand(node.children[RHS], st);
   auto op_method = get_unary_op_method(op);
 
   // NOTE intermediates are probably unneccesary, but are the right pattern to
@@ -827,7 +1313,7 @@ CompNodeResult gen_if(ASTNode &node, CompSymbolTable &st) {
   const size_t CONDITION = 0, IF_BODY = 1, ELSE_BODY = 2, SIZE_IF_ELSE = 3;
 
   // need test method runtime result?
-  auto condition_result = gen_node(node.children[CONDITION], st);
+  auto condition_result = gen_operand(node.children[CONDITION], st);
   emit("if (get_conditional_result(");
   emit(condition_result.result_loc.value());
   emit(")) {\n");
@@ -857,7 +1343,7 @@ CompNodeResult gen_while(ASTNode &node, CompSymbolTable &st) {
   emit(condition_label);
   emit(":;\n"); // semicolon due to compiler error
                 // https://github.com/llvm/llvm-project/issues/77057
-  auto condition_result = gen_node(node.children[CONDITION], st);
+  auto condition_result = gen_operand(node.children[CONDITION], st);
   emit("if (get_conditional_result(");
   emit(condition_result.result_loc.value());
   emit(")) {\n");
@@ -953,6 +1439,20 @@ CompNodeResult gen_node(ASTNode &node, CompSymbolTable &st) {
 CompNodeResult gen_node_root(ASTNode &node, string module_wd) {
   WORKING_DIRECTORY = module_wd;
   CompSymbolTable root_symbol_table{
-      nullptr, {{"print", {"builtin_print", CompTableEntryType::BUILTIN}}}};
+      nullptr,
+      {{"print", {"builtin_print", CompTableEntryType::BUILTIN}},
+       {"write", {"builtin_write", CompTableEntryType::BUILTIN}},
+       {"flush", {"builtin_flush", CompTableEntryType::BUILTIN}},
+       {"read_file", {"builtin_read_file", CompTableEntryType::BUILTIN}},
+       {"lines", {"builtin_lines", CompTableEntryType::BUILTIN}},
+       {"read_line", {"builtin_read_line", CompTableEntryType::BUILTIN}},
+       {"read_all", {"builtin_read_all", CompTableEntryType::BUILTIN}},
+       {"read_chunk", {"builtin_read_chunk", CompTableEntryType::BUILTIN}},
+       {"read_into", {"builtin_read_into", CompTableEntryType::BUILTIN}},
+       {"bytes", {"builtin_bytes", CompTableEntryType::BUILTIN}},
+       {"read_bytes", {"builtin_read_bytes", CompTableEntryType::BUILTIN}},
+       {"write_bytes", {"builtin_write_bytes", CompTableEntryType::BUILTIN}},
+       {"json_parse", {"builtin_json_parse", CompTableEntryType::BUILTIN}},
+       {"json_dump", {"builtin_json_dump", CompTableEntryType::BUILTIN}}}};
   return gen_node(node, root_symbol_table);
 }
@@ -3,6 +3,7 @@
 #include "interpreter.h"
 #include "lexer.h"
 #include "parser.h"
+#include "runtime.h"
 #include "unittests.h"
 #include "util.h"
 #include <filesystem>
@@ -11,6 +12,7 @@
 #include <nlohmann/json.hpp>
 #include <ostream>
 #include <string>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <vector>
 
@@ -67,6 +69,7 @@ int interpret(string input_file_path, string program_args) {
     program_argv = UTIL::split_argv(program_args);
   }
 
+  init_output();
   eval_top_level(ast, module_wd, program_argv);
   return 0;
 }
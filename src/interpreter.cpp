@@ -45,7 +45,142 @@ static unordered_map<DataType, SymbolTable> builtin_type_methods{
                 Function{
                     "append",
                     {"elem"},
-                    ASTNode{NodeType::BUILTIN_VECTOR_APPEND, {}, {}, {}}})}}}}},
+                    ASTNode{NodeType::BUILTIN_VECTOR_APPEND, {}, {}, {}}})}},
+       {"reserve",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "reserve",
+                    {"capacity"},
+                    ASTNode{NodeType::BUILTIN_VECTOR_RESERVE, {}, {}, {}}})}},
+       {"extend",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "extend",
+                    {"other"},
+                    ASTNode{NodeType::BUILTIN_VECTOR_EXTEND, {}, {}, {}}})}},
+       {"pop",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "pop",
+                    {},
+                    ASTNode{NodeType::BUILTIN_VECTOR_POP, {}, {}, {}}})}},
+       {"insert",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "insert",
+                    {"index", "elem"},
+                    ASTNode{NodeType::BUILTIN_VECTOR_INSERT, {}, {}, {}}})}},
+       {"remove",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "remove",
+                    {"index"},
+                    ASTNode{NodeType::BUILTIN_VECTOR_REMOVE, {}, {}, {}}})}},
+       {"clear",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "clear",
+                    {},
+                    ASTNode{NodeType::BUILTIN_VECTOR_CLEAR, {}, {}, {}}})}},
+       {"shrink_to_fit",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "shrink_to_fit",
+                    {},
+                    ASTNode{NodeType::BUILTIN_VECTOR_SHRINK_TO_FIT, {}, {}, {}}})}},
+       {"sum",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "sum",
+                    {},
+                    ASTNode{NodeType::BUILTIN_VECTOR_SUM, {}, {}, {}}})}},
+       {"min",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "min",
+                    {},
+                    ASTNode{NodeType::BUILTIN_VECTOR_MIN, {}, {}, {}}})}},
+       {"max",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "max",
+                    {},
+                    ASTNode{NodeType::BUILTIN_VECTOR_MAX, {}, {}, {}}})}},
+       {"dot",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "dot",
+                    {"other"},
+                    ASTNode{NodeType::BUILTIN_VECTOR_DOT, {}, {}, {}}})}},
+       {"count",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "count",
+                    {"value"},
+                    ASTNode{NodeType::BUILTIN_VECTOR_COUNT, {}, {}, {}}})}},
+       {"fill",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "fill",
+                    {"value", "count"},
+                    ASTNode{NodeType::BUILTIN_VECTOR_FILL, {}, {}, {}}})}},
+       {"sort",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "sort",
+                    {},
+                    ASTNode{NodeType::BUILTIN_VECTOR_SORT, {}, {}, {}}})}},
+       {"sort_by",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "sort_by",
+                    {"less"},
+                    ASTNode{NodeType::BUILTIN_VECTOR_SORT_BY, {}, {}, {}}})}}}}},
     {DataType::STRING,
      {nullptr,
       {},
@@ -57,7 +192,137 @@ static unordered_map<DataType, SymbolTable> builtin_type_methods{
                 Function{
                     "length",
                     {},
-                    ASTNode{NodeType::BUILTIN_STRING_LENGTH, {}, {}, {}}})}}}}},
+                    ASTNode{NodeType::BUILTIN_STRING_LENGTH, {}, {}, {}}})}},
+       {"substr",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "substr",
+                    {"start", "count"},
+                    ASTNode{NodeType::BUILTIN_STRING_SUBSTR, {}, {}, {}}})}},
+       {"find",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "find",
+                    {"needle"},
+                    ASTNode{NodeType::BUILTIN_STRING_FIND, {}, {}, {}}})}},
+       {"contains",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "contains",
+                    {"needle"},
+                    ASTNode{NodeType::BUILTIN_STRING_CONTAINS, {}, {}, {}}})}},
+       {"starts_with",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "starts_with",
+                    {"prefix"},
+                    ASTNode{
+                        NodeType::BUILTIN_STRING_STARTS_WITH, {}, {}, {}}})}},
+       {"ends_with",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "ends_with",
+                    {"suffix"},
+                    ASTNode{NodeType::BUILTIN_STRING_ENDS_WITH, {}, {}, {}}})}},
+       {"split",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "split",
+                    {"separator"},
+                    ASTNode{NodeType::BUILTIN_STRING_SPLIT, {}, {}, {}}})}},
+       {"join",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "join",
+                    {"parts"},
+                    ASTNode{NodeType::BUILTIN_STRING_JOIN, {}, {}, {}}})}},
+       {"replace",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "replace",
+                    {"from", "to"},
+                    ASTNode{NodeType::BUILTIN_STRING_REPLACE, {}, {}, {}}})}},
+       {"trim",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "trim",
+                    {},
+                    ASTNode{NodeType::BUILTIN_STRING_TRIM, {}, {}, {}}})}},
+       {"next_line",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "next_line",
+                    {"start"},
+                    ASTNode{NodeType::BUILTIN_STRING_NEXT_LINE, {}, {}, {}}})}}}}},
+    {DataType::BYTES,
+     {nullptr,
+      {},
+      {{"length",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "length",
+                    {},
+                    ASTNode{NodeType::BUILTIN_BYTES_LENGTH, {}, {}, {}}})}},
+       {"slice",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "slice",
+                    {"start", "end"},
+                    ASTNode{NodeType::BUILTIN_BYTES_SLICE, {}, {}, {}}})}},
+       {"copy_from",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "copy_from",
+                    {"source", "at"},
+                    ASTNode{NodeType::BUILTIN_BYTES_COPY_FROM, {}, {}, {}}})}},
+       {"to_string",
+        SymbolTableEntry{
+            VarType::FUNCTION,
+            std::make_shared<BoxedValue>(
+                DataType::FUNCTION,
+                Function{
+                    "to_string",
+                    {},
+                    ASTNode{NodeType::BUILTIN_BYTES_TO_STRING, {}, {}, {}}})}}}}},
     {DataType::DICT,
      {
          nullptr,
@@ -92,11 +357,33 @@ static unordered_map<DataType, SymbolTable> builtin_type_methods{
                        "contains",
                        {"key"},
                        ASTNode{
-                           NodeType::BUILTIN_DICT_CONTAINS, {}, {}, {}}})}}},
+                           NodeType::BUILTIN_DICT_CONTAINS, {}, {}, {}}})}},
+          // remove
+          {"remove",
+           SymbolTableEntry{
+               VarType::FUNCTION,
+               std::make_shared<BoxedValue>(
+                   DataType::FUNCTION,
+                   Function{
+                       "remove",
+                       {"key"},
+                       ASTNode{NodeType::BUILTIN_DICT_REMOVE, {}, {}, {}}})}},
+          // clear
+          {"clear",
+           SymbolTableEntry{
+               VarType::FUNCTION,
+               std::make_shared<BoxedValue>(
+                   DataType::FUNCTION,
+                   Function{
+                       "clear",
+                       {},
+                       ASTNode{NodeType::BUILTIN_DICT_CLEAR, {}, {}, {}}})}}},
      }}};
 
 EvalResult eval_node(ASTNode &node, SymbolTable &st,
                      ValueType vt = ValueType::RVALUE);
+EvalResult call_function(Function &function, const HeVec &args,
+                         SymbolTable &st);
 
 EvalResult eval_var_declare(ASTNode &node, SymbolTable &st) {
   /*
@@ -253,10 +540,13 @@ EvalResult eval_func_call(ASTNode &node, SymbolTable &st) {
 
                     "Function arguments must be an expression list");
 
-  auto function_rawvalue = std::get<Function>(callee.value);
-  auto arg_names = function_rawvalue.args;
+  return call_function(std::get<Function>(callee.value),
+                       *std::get<shared_ptr<HeVec>>(args.value), st);
+}
 
-  auto arg_values = std::get<shared_ptr<HeVec>>(args.value);
+EvalResult call_function(Function &function_rawvalue, const HeVec &arg_values,
+                         SymbolTable &st) {
+  auto &arg_names = function_rawvalue.args;
 
   // prep function's symbol table
   SymbolTable fn_st;
@@ -266,12 +556,12 @@ EvalResult eval_func_call(ASTNode &node, SymbolTable &st) {
     fn_st = SymbolTable{function_rawvalue.module_st.get(), {}};
   }
 
-  runtime_assertion(arg_names.size() == arg_values->size(),
+  runtime_assertion(arg_names.size() == arg_values.size(),
                     "Number of arguments does not match function definition.");
   auto len = arg_names.size();
   for (size_t i = 0; i < len; i++) {
     auto arg_name = arg_names.at(i);
-    auto arg_value = arg_values->at(i);
+    auto arg_value = std::make_shared<BoxedValue>(arg_values.at(i));
 
     fn_st.entries[arg_name] = SymbolTableEntry{VarType::CONST, arg_value};
   }
@@ -297,8 +587,7 @@ EvalResult eval_vec_literal(ASTNode &node, SymbolTable &st) {
   auto vec_value = std::make_shared<HeVec>();
   for (auto &node : child_nodes) {
     auto result = eval_node(node, st);
-    vec_value->push_back(
-        std::make_shared<BoxedValue>(result.rv_result.value()));
+    vec_value->push_back(result.rv_result.value());
   }
   return EvalResult{BoxedValue{DataType::VECTOR, vec_value}};
 }
@@ -460,6 +749,72 @@ EvalResult eval_builtin_print(ASTNode &node, SymbolTable &st) {
   return EvalResult{};
 }
 
+EvalResult eval_builtin_write(ASTNode &node, SymbolTable &st) {
+  auto lookup_er = st.lookup_rvalue("arg");
+  builtin_write(lookup_er.rv_result.value());
+  return EvalResult{};
+}
+
+EvalResult eval_builtin_flush(ASTNode &node, SymbolTable &st) {
+  builtin_flush();
+  return EvalResult{};
+}
+
+EvalResult eval_builtin_read_file(ASTNode &node, SymbolTable &st) {
+  auto lookup_path = st.lookup_rvalue("path").rv_result.value();
+  return EvalResult{builtin_read_file(lookup_path), nullptr, true};
+}
+
+EvalResult eval_builtin_lines(ASTNode &node, SymbolTable &st) {
+  auto lookup_path = st.lookup_rvalue("path").rv_result.value();
+  return EvalResult{builtin_lines(lookup_path), nullptr, true};
+}
+
+EvalResult eval_builtin_read_line(ASTNode &node, SymbolTable &st) {
+  return EvalResult{builtin_read_line(), nullptr, true};
+}
+
+EvalResult eval_builtin_read_all(ASTNode &node, SymbolTable &st) {
+  return EvalResult{builtin_read_all(), nullptr, true};
+}
+
+EvalResult eval_builtin_read_chunk(ASTNode &node, SymbolTable &st) {
+  auto lookup_count = st.lookup_rvalue("count").rv_result.value();
+  return EvalResult{builtin_read_chunk(lookup_count), nullptr, true};
+}
+
+EvalResult eval_builtin_read_into(ASTNode &node, SymbolTable &st) {
+  auto lookup_buffer = st.lookup_rvalue("buffer").rv_result.value();
+  return EvalResult{builtin_read_into(lookup_buffer), nullptr, true};
+}
+
+EvalResult eval_builtin_bytes(ASTNode &node, SymbolTable &st) {
+  auto lookup_from = st.lookup_rvalue("from").rv_result.value();
+  return EvalResult{builtin_bytes(lookup_from), nullptr, true};
+}
+
+EvalResult eval_builtin_read_bytes(ASTNode &node, SymbolTable &st) {
+  auto lookup_path = st.lookup_rvalue("path").rv_result.value();
+  return EvalResult{builtin_read_bytes(lookup_path), nullptr, true};
+}
+
+EvalResult eval_builtin_write_bytes(ASTNode &node, SymbolTable &st) {
+  auto lookup_path = st.lookup_rvalue("path").rv_result.value();
+  auto lookup_data = st.lookup_rvalue("data").rv_result.value();
+  return EvalResult{builtin_write_bytes(lookup_path, lookup_data), nullptr,
+                    true};
+}
+
+EvalResult eval_builtin_json_parse(ASTNode &node, SymbolTable &st) {
+  auto lookup_text = st.lookup_rvalue("text").rv_result.value();
+  return EvalResult{builtin_json_parse(lookup_text), nullptr, true};
+}
+
+EvalResult eval_builtin_json_dump(ASTNode &node, SymbolTable &st) {
+  auto lookup_value = st.lookup_rvalue("value").rv_result.value();
+  return EvalResult{builtin_json_dump(lookup_value), nullptr, true};
+}
+
 EvalResult eval_builtin_vector_append(ASTNode &node, SymbolTable &st) {
   auto lookup_this = st.lookup_rvalue("this").rv_result.value();
   auto lookup_elem = st.lookup_rvalue("elem").rv_result.value();
@@ -468,6 +823,124 @@ EvalResult eval_builtin_vector_append(ASTNode &node, SymbolTable &st) {
   return EvalResult{};
 }
 
+EvalResult eval_builtin_vector_reserve(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_capacity = st.lookup_rvalue("capacity").rv_result.value();
+
+  builtin_vector_reserve(lookup_this, lookup_capacity);
+  return EvalResult{};
+}
+
+EvalResult eval_builtin_vector_extend(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_other = st.lookup_rvalue("other").rv_result.value();
+
+  builtin_vector_extend(lookup_this, lookup_other);
+  return EvalResult{};
+}
+
+EvalResult eval_builtin_vector_pop(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  return EvalResult{builtin_vector_pop(lookup_this), nullptr, true};
+}
+
+EvalResult eval_builtin_vector_insert(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_index = st.lookup_rvalue("index").rv_result.value();
+  auto lookup_elem = st.lookup_rvalue("elem").rv_result.value();
+
+  builtin_vector_insert(lookup_this, lookup_index, lookup_elem);
+  return EvalResult{};
+}
+
+EvalResult eval_builtin_vector_remove(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_index = st.lookup_rvalue("index").rv_result.value();
+  return EvalResult{builtin_vector_remove(lookup_this, lookup_index), nullptr,
+                    true};
+}
+
+EvalResult eval_builtin_vector_clear(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+
+  builtin_vector_clear(lookup_this);
+  return EvalResult{};
+}
+
+EvalResult eval_builtin_vector_shrink_to_fit(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+
+  builtin_vector_shrink_to_fit(lookup_this);
+  return EvalResult{};
+}
+
+EvalResult eval_builtin_vector_sum(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  return EvalResult{builtin_vector_sum(lookup_this), nullptr, true};
+}
+
+EvalResult eval_builtin_vector_min(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  return EvalResult{builtin_vector_min(lookup_this), nullptr, true};
+}
+
+EvalResult eval_builtin_vector_max(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  return EvalResult{builtin_vector_max(lookup_this), nullptr, true};
+}
+
+EvalResult eval_builtin_vector_dot(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_other = st.lookup_rvalue("other").rv_result.value();
+  return EvalResult{builtin_vector_dot(lookup_this, lookup_other), nullptr,
+                    true};
+}
+
+EvalResult eval_builtin_vector_count(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_value = st.lookup_rvalue("value").rv_result.value();
+  return EvalResult{builtin_vector_count(lookup_this, lookup_value), nullptr,
+                    true};
+}
+
+EvalResult eval_builtin_vector_fill(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_value = st.lookup_rvalue("value").rv_result.value();
+  auto lookup_count = st.lookup_rvalue("count").rv_result.value();
+
+  builtin_vector_fill(lookup_this, lookup_value, lookup_count);
+  return EvalResult{};
+}
+
+EvalResult eval_builtin_vector_sort(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+
+  builtin_vector_sort(lookup_this);
+  return EvalResult{};
+}
+
+EvalResult eval_builtin_vector_sort_by(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_less = st.lookup_rvalue("less").rv_result.value();
+  runtime_assertion(lookup_less.type == DataType::FUNCTION,
+                    "sort_by() needs a function.");
+
+  auto less = std::get<Function>(lookup_less.value);
+  auto raw_vec = std::get<shared_ptr<HeVec>>(lookup_this.value);
+  auto layout = raw_vec->layout();
+  raw_vec->sort_copy([&](const auto &lhs, const auto &rhs) {
+    HeVec args;
+    args.push_back(HeVec::box(lhs));
+    args.push_back(HeVec::box(rhs));
+    auto result = get_conditional_result(
+        call_function(less, args, st).rv_result.value());
+    runtime_assertion(raw_vec->layout() == layout,
+                      "sort_by(): vector changed during sort.");
+    return result;
+  });
+  return EvalResult{};
+}
+
 EvalResult eval_builtin_vector_length(ASTNode &node, SymbolTable &st) {
   auto lookup_er = st.lookup_rvalue("this");
   return EvalResult{builtin_vector_length(lookup_er.rv_result.value()), nullptr,
@@ -494,12 +967,124 @@ EvalResult eval_builtin_dict_contains(ASTNode &node, SymbolTable &st) {
       true};
 }
 
+EvalResult eval_builtin_dict_remove(ASTNode &node, SymbolTable &st) {
+  auto lookup_er = st.lookup_rvalue("this");
+  auto lookup_key = st.lookup_rvalue("key").rv_result.value();
+  return EvalResult{
+      builtin_dict_remove(lookup_er.rv_result.value(), lookup_key), nullptr,
+      true};
+}
+
+EvalResult eval_builtin_dict_clear(ASTNode &node, SymbolTable &st) {
+  auto lookup_er = st.lookup_rvalue("this");
+  return EvalResult{builtin_dict_clear(lookup_er.rv_result.value()), nullptr,
+                    true};
+}
+
 EvalResult eval_builtin_string_length(ASTNode &node, SymbolTable &st) {
   auto lookup_er = st.lookup_rvalue("this");
   return EvalResult{builtin_string_length(lookup_er.rv_result.value()), nullptr,
                     true};
 }
 
+EvalResult eval_builtin_string_substr(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_start = st.lookup_rvalue("start").rv_result.value();
+  auto lookup_count = st.lookup_rvalue("count").rv_result.value();
+  return EvalResult{builtin_string_substr(
+                        lookup_this, lookup_start, lookup_count),
+                    nullptr, true};
+}
+
+EvalResult eval_builtin_string_find(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_needle = st.lookup_rvalue("needle").rv_result.value();
+  return EvalResult{builtin_string_find(lookup_this, lookup_needle), nullptr,
+                    true};
+}
+
+EvalResult eval_builtin_string_contains(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_needle = st.lookup_rvalue("needle").rv_result.value();
+  return EvalResult{
+      builtin_string_contains(lookup_this, lookup_needle), nullptr, true};
+}
+
+EvalResult eval_builtin_string_starts_with(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_prefix = st.lookup_rvalue("prefix").rv_result.value();
+  return EvalResult{
+      builtin_string_starts_with(lookup_this, lookup_prefix), nullptr, true};
+}
+
+EvalResult eval_builtin_string_ends_with(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_suffix = st.lookup_rvalue("suffix").rv_result.value();
+  return EvalResult{
+      builtin_string_ends_with(lookup_this, lookup_suffix), nullptr, true};
+}
+
+EvalResult eval_builtin_string_split(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_separator = st.lookup_rvalue("separator").rv_result.value();
+  return EvalResult{
+      builtin_string_split(lookup_this, lookup_separator), nullptr, true};
+}
+
+EvalResult eval_builtin_string_join(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_parts = st.lookup_rvalue("parts").rv_result.value();
+  return EvalResult{builtin_string_join(lookup_this, lookup_parts), nullptr,
+                    true};
+}
+
+EvalResult eval_builtin_string_replace(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_from = st.lookup_rvalue("from").rv_result.value();
+  auto lookup_to = st.lookup_rvalue("to").rv_result.value();
+  return EvalResult{builtin_string_replace(
+                        lookup_this, lookup_from, lookup_to),
+                    nullptr, true};
+}
+
+EvalResult eval_builtin_string_trim(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  return EvalResult{builtin_string_trim(lookup_this), nullptr, true};
+}
+
+EvalResult eval_builtin_string_next_line(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_start = st.lookup_rvalue("start").rv_result.value();
+  return EvalResult{builtin_string_next_line(lookup_this, lookup_start),
+                    nullptr, true};
+}
+
+EvalResult eval_builtin_bytes_length(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  return EvalResult{builtin_bytes_length(lookup_this), nullptr, true};
+}
+
+EvalResult eval_builtin_bytes_slice(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_start = st.lookup_rvalue("start").rv_result.value();
+  auto lookup_end = st.lookup_rvalue("end").rv_result.value();
+  return EvalResult{builtin_bytes_slice(lookup_this, lookup_start, lookup_end),
+                    nullptr, true};
+}
+
+EvalResult eval_builtin_bytes_copy_from(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  auto lookup_source = st.lookup_rvalue("source").rv_result.value();
+  auto lookup_at = st.lookup_rvalue("at").rv_result.value();
+  builtin_bytes_copy_from(lookup_this, lookup_source, lookup_at);
+  return EvalResult{BoxedValue{DataType::NOTHING, 0}, nullptr, true};
+}
+
+EvalResult eval_builtin_bytes_to_string(ASTNode &node, SymbolTable &st) {
+  auto lookup_this = st.lookup_rvalue("this").rv_result.value();
+  return EvalResult{builtin_bytes_to_string(lookup_this), nullptr, true};
+}
+
 EvalResult eval_field_access(ASTNode &node, SymbolTable &st, ValueType vt) {
   const size_t LHS = 0, RHS = 1;
   auto lhs = eval_node(node.children[LHS], st).rv_result.value();
@@ -584,8 +1169,20 @@ EvalResult eval_index_access(ASTNode &node, SymbolTable &st, ValueType vt) {
                             hevec, BoxedValue{DataType::INT, index})};
     }
 
-    auto value = hevec->at(index);
-    return EvalResult{BoxedValue{value->type, value->value}};
+    return EvalResult{hevec->at(index)};
+  }
+
+  // bytes index case
+  if (lhs.type == DataType::BYTES) {
+    auto bytes = std::get<shared_ptr<Bytes>>(lhs.value);
+
+    if (vt == ValueType::LVALUE) {
+      return EvalResult{std::nullopt,
+                        std::make_shared<BytesIndexLV>(
+                            bytes, BoxedValue{DataType::INT, index})};
+    }
+
+    return EvalResult{bytes_get(*bytes, index)};
   }
 
   // string index case
@@ -600,7 +1197,8 @@ EvalResult eval_index_access(ASTNode &node, SymbolTable &st, ValueType vt) {
   }
 
   throw std::runtime_error(
-      "Index access only supported on strings, vectors, and dictionaries.");
+      "Index access only supported on strings, bytes, vectors, and "
+      "dictionaries.");
 }
 
 void VariableLV::assign(BoxedValue value) {
@@ -618,14 +1216,20 @@ BoxedValue VariableLV::currentValue() {
 
 void VectorIndexLV::assign(BoxedValue value) {
   auto index = std::get<int>(this->index.value);
-  this->vector->at(index) =
-      std::make_shared<BoxedValue>(value.type, value.value);
+  this->vector->set(index, value);
 }
 
 BoxedValue VectorIndexLV::currentValue() {
   auto index = std::get<int>(this->index.value);
-  auto cv = this->vector->at(index);
-  return BoxedValue{cv->type, cv->value};
+  return this->vector->at(index);
+}
+
+void BytesIndexLV::assign(BoxedValue value) {
+  bytes_set(*this->bytes, std::get<int>(this->index.value), value);
+}
+
+BoxedValue BytesIndexLV::currentValue() {
+  return bytes_get(*this->bytes, std::get<int>(this->index.value));
 }
 
 void DictIndexLV::assign(BoxedValue value) {
@@ -653,8 +1257,7 @@ EvalResult call_main_function(Function main_function, vector<string> argv,
     // make vector of strings out of argv
     auto argv_hevec = std::make_shared<HeVec>();
     for (auto &str : argv) {
-      argv_hevec->push_back(
-          std::make_shared<BoxedValue>(DataType::STRING, str));
+      argv_hevec->push_back(BoxedValue{DataType::STRING, str});
     }
 
     // place the newly created argv into the symbol table
@@ -677,13 +1280,104 @@ EvalResult eval_top_level(ASTNode &node, vector<string> argv) {
 
   SymbolTable top_level_st;
 
-  // hard code a built-in function for print
+  // hard code the built-in functions for output
   top_level_st.entries["print"] = SymbolTableEntry{
       VarType::FUNCTION,
       std::make_shared<BoxedValue>(
           DataType::FUNCTION,
           Function{
               "print", {"arg"}, ASTNode{NodeType::BUILTIN_PRINT, {}, {}, {}}})};
+  top_level_st.entries["write"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{
+              "write", {"arg"}, ASTNode{NodeType::BUILTIN_WRITE, {}, {}, {}}})};
+  top_level_st.entries["flush"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{"flush", {}, ASTNode{NodeType::BUILTIN_FLUSH, {}, {}, {}}})};
+
+  // and for reading files
+  top_level_st.entries["read_file"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{"read_file",
+                   {"path"},
+                   ASTNode{NodeType::BUILTIN_READ_FILE, {}, {}, {}}})};
+  top_level_st.entries["lines"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{
+              "lines", {"path"}, ASTNode{NodeType::BUILTIN_LINES, {}, {}, {}}})};
+
+  // and for reading standard input
+  top_level_st.entries["read_line"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{"read_line",
+                   {},
+                   ASTNode{NodeType::BUILTIN_READ_LINE, {}, {}, {}}})};
+  top_level_st.entries["read_all"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{"read_all",
+                   {},
+                   ASTNode{NodeType::BUILTIN_READ_ALL, {}, {}, {}}})};
+  top_level_st.entries["read_chunk"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{"read_chunk",
+                   {"count"},
+                   ASTNode{NodeType::BUILTIN_READ_CHUNK, {}, {}, {}}})};
+  top_level_st.entries["read_into"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{"read_into",
+                   {"buffer"},
+                   ASTNode{NodeType::BUILTIN_READ_INTO, {}, {}, {}}})};
+  top_level_st.entries["bytes"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{"bytes",
+                   {"from"},
+                   ASTNode{NodeType::BUILTIN_BYTES, {}, {}, {}}})};
+  top_level_st.entries["read_bytes"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{"read_bytes",
+                   {"path"},
+                   ASTNode{NodeType::BUILTIN_READ_BYTES, {}, {}, {}}})};
+  top_level_st.entries["write_bytes"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{"write_bytes",
+                   {"path", "data"},
+                   ASTNode{NodeType::BUILTIN_WRITE_BYTES, {}, {}, {}}})};
+  top_level_st.entries["json_parse"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{"json_parse",
+                   {"text"},
+                   ASTNode{NodeType::BUILTIN_JSON_PARSE, {}, {}, {}}})};
+  top_level_st.entries["json_dump"] = SymbolTableEntry{
+      VarType::FUNCTION,
+      std::make_shared<BoxedValue>(
+          DataType::FUNCTION,
+          Function{"json_dump",
+                   {"value"},
+                   ASTNode{NodeType::BUILTIN_JSON_DUMP, {}, {}, {}}})};
 
   for (auto &child : node.children) {
     eval_node(child, top_level_st);
@@ -757,14 +1451,122 @@ EvalResult eval_node(ASTNode &node, SymbolTable &st, ValueType vt) {
     case NodeType::BUILTIN_PRINT:
       return eval_builtin_print(node, st);
       break;
+    case NodeType::BUILTIN_WRITE:
+      return eval_builtin_write(node, st);
+      break;
+    case NodeType::BUILTIN_FLUSH:
+      return eval_builtin_flush(node, st);
+      break;
+    case NodeType::BUILTIN_READ_FILE:
+      return eval_builtin_read_file(node, st);
+      break;
+    case NodeType::BUILTIN_LINES:
+      return eval_builtin_lines(node, st);
+      break;
+    case NodeType::BUILTIN_READ_LINE:
+      return eval_builtin_read_line(node, st);
+      break;
+    case NodeType::BUILTIN_READ_ALL:
+      return eval_builtin_read_all(node, st);
+      break;
+    case NodeType::BUILTIN_READ_CHUNK:
+      return eval_builtin_read_chunk(node, st);
+      break;
+    case NodeType::BUILTIN_READ_INTO:
+      return eval_builtin_read_into(node, st);
+      break;
+    case NodeType::BUILTIN_BYTES:
+      return eval_builtin_bytes(node, st);
+      break;
+    case NodeType::BUILTIN_READ_BYTES:
+      return eval_builtin_read_bytes(node, st);
+      break;
+    case NodeType::BUILTIN_WRITE_BYTES:
+      return eval_builtin_write_bytes(node, st);
+      break;
+    case NodeType::BUILTIN_JSON_PARSE:
+      return eval_builtin_json_parse(node, st);
+      break;
+    case NodeType::BUILTIN_JSON_DUMP:
+      return eval_builtin_json_dump(node, st);
+      break;
     case NodeType::BUILTIN_VECTOR_LENGTH:
       return eval_builtin_vector_length(node, st);
       break;
     case NodeType::BUILTIN_VECTOR_APPEND:
       return eval_builtin_vector_append(node, st);
       break;
+    case NodeType::BUILTIN_VECTOR_RESERVE:
+      return eval_builtin_vector_reserve(node, st);
+      break;
+    case NodeType::BUILTIN_VECTOR_EXTEND:
+      return eval_builtin_vector_extend(node, st);
+      break;
+    case NodeType::BUILTIN_VECTOR_POP:
+      return eval_builtin_vector_pop(node, st);
+      break;
+    case NodeType::BUILTIN_VECTOR_INSERT:
+      return eval_builtin_vector_insert(node, st);
+      break;
+    case NodeType::BUILTIN_VECTOR_REMOVE:
+      return eval_builtin_vector_remove(node, st);
+      break;
+    case NodeType::BUILTIN_VECTOR_CLEAR:
+      return eval_builtin_vector_clear(node, st);
+      break;
+    case NodeType::BUILTIN_VECTOR_SHRINK_TO_FIT:
+      return eval_builtin_vector_shrink_to_fit(node, st);
+    case NodeType::BUILTIN_VECTOR_SUM:
+      return eval_builtin_vector_sum(node, st);
+    case NodeType::BUILTIN_VECTOR_MIN:
+      return eval_builtin_vector_min(node, st);
+    case NodeType::BUILTIN_VECTOR_MAX:
+      return eval_builtin_vector_max(node, st);
+    case NodeType::BUILTIN_VECTOR_DOT:
+      return eval_builtin_vector_dot(node, st);
+    case NodeType::BUILTIN_VECTOR_COUNT:
+      return eval_builtin_vector_count(node, st);
+    case NodeType::BUILTIN_VECTOR_FILL:
+      return eval_builtin_vector_fill(node, st);
+    case NodeType::BUILTIN_VECTOR_SORT:
+      return eval_builtin_vector_sort(node, st);
+    case NodeType::BUILTIN_VECTOR_SORT_BY:
+      return eval_builtin_vector_sort_by(node, st);
+      break;
     case NodeType::BUILTIN_STRING_LENGTH:
       return eval_builtin_string_length(node, st);
+    case NodeType::BUILTIN_STRING_SUBSTR:
+      return eval_builtin_string_substr(node, st);
+    case NodeType::BUILTIN_STRING_FIND:
+      return eval_builtin_string_find(node, st);
+    case NodeType::BUILTIN_STRING_CONTAINS:
+      return eval_builtin_string_contains(node, st);
+    case NodeType::BUILTIN_STRING_STARTS_WITH:
+      return eval_builtin_string_starts_with(node, st);
+    case NodeType::BUILTIN_STRING_ENDS_WITH:
+      return eval_builtin_string_ends_with(node, st);
+    case NodeType::BUILTIN_STRING_SPLIT:
+      return eval_builtin_string_split(node, st);
+    case NodeType::BUILTIN_STRING_JOIN:
+      return eval_builtin_string_join(node, st);
+    case NodeType::BUILTIN_STRING_REPLACE:
+      return eval_builtin_string_replace(node, st);
+    case NodeType::BUILTIN_STRING_TRIM:
+      return eval_builtin_string_trim(node, st);
+    case NodeType::BUILTIN_STRING_NEXT_LINE:
+      return eval_builtin_string_next_line(node, st);
+      break;
+    case NodeType::BUILTIN_BYTES_LENGTH:
+      return eval_builtin_bytes_length(node, st);
+      break;
+    case NodeType::BUILTIN_BYTES_SLICE:
+      return eval_builtin_bytes_slice(node, st);
+      break;
+    case NodeType::BUILTIN_BYTES_COPY_FROM:
+      return eval_builtin_bytes_copy_from(node, st);
+      break;
+    case NodeType::BUILTIN_BYTES_TO_STRING:
+      return eval_builtin_bytes_to_string(node, st);
       break;
     case NodeType::BUILTIN_DICT_LENGTH:
       return eval_builtin_dict_length(node, st);
@@ -775,6 +1577,12 @@ EvalResult eval_node(ASTNode &node, SymbolTable &st, ValueType vt) {
     case NodeType::BUILTIN_DICT_CONTAINS:
       return eval_builtin_dict_contains(node, st);
       break;
+    case NodeType::BUILTIN_DICT_REMOVE:
+      return eval_builtin_dict_remove(node, st);
+      break;
+    case NodeType::BUILTIN_DICT_CLEAR:
+      return eval_builtin_dict_clear(node, st);
+      break;
     case NodeType::VEC_LITERAL:
       return eval_vec_literal(node, st);
       break;
@@ -185,7 +185,7 @@ Token LexerState::handle_numeric() {
       number.append(1, c);
       c = this->next_char();
     }
-    auto value = std::stof(number);
+    auto value = std::stod(number);
     return Token{TokenType::FLOAT_LITERAL, value, metadata};
   }
 
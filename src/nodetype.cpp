@@ -33,12 +33,56 @@ string node_type_to_string(NodeType e) {
       "VAR_LOOKUP",
       "EXPR_LIST",
       "BUILTIN_PRINT",
+      "BUILTIN_WRITE",
+      "BUILTIN_FLUSH",
+      "BUILTIN_READ_FILE",
+      "BUILTIN_LINES",
+      "BUILTIN_READ_LINE",
+      "BUILTIN_READ_ALL",
+      "BUILTIN_READ_CHUNK",
+      "BUILTIN_JSON_PARSE",
+      "BUILTIN_JSON_DUMP",
+      "BUILTIN_READ_INTO",
+      "BUILTIN_BYTES",
+      "BUILTIN_READ_BYTES",
+      "BUILTIN_WRITE_BYTES",
       "BUILTIN_VECTOR_LENGTH",
       "BUILTIN_VECTOR_APPEND",
+      "BUILTIN_VECTOR_RESERVE",
+      "BUILTIN_VECTOR_EXTEND",
+      "BUILTIN_VECTOR_POP",
+      "BUILTIN_VECTOR_INSERT",
+      "BUILTIN_VECTOR_REMOVE",
+      "BUILTIN_VECTOR_CLEAR",
+      "BUILTIN_VECTOR_SHRINK_TO_FIT",
+      "BUILTIN_VECTOR_SUM",
+      "BUILTIN_VECTOR_MIN",
+      "BUILTIN_VECTOR_MAX",
+      "BUILTIN_VECTOR_DOT",
+      "BUILTIN_VECTOR_COUNT",
+      "BUILTIN_VECTOR_FILL",
+      "BUILTIN_VECTOR_SORT",
+      "BUILTIN_VECTOR_SORT_BY",
       "BUILTIN_STRING_LENGTH",
+      "BUILTIN_STRING_SUBSTR",
+      "BUILTIN_STRING_FIND",
+      "BUILTIN_STRING_CONTAINS",
+      "BUILTIN_STRING_STARTS_WITH",
+      "BUILTIN_STRING_ENDS_WITH",
+      "BUILTIN_STRING_SPLIT",
+      "BUILTIN_STRING_JOIN",
+      "BUILTIN_STRING_REPLACE",
+      "BUILTIN_STRING_TRIM",
+      "BUILTIN_STRING_NEXT_LINE",
+      "BUILTIN_BYTES_LENGTH",
+      "BUILTIN_BYTES_SLICE",
+      "BUILTIN_BYTES_COPY_FROM",
+      "BUILTIN_BYTES_TO_STRING",
       "BUILTIN_DICT_LENGTH",
       "BUILTIN_DICT_KEYS",
       "BUILTIN_DICT_CONTAINS",
+      "BUILTIN_DICT_REMOVE",
+      "BUILTIN_DICT_CLEAR",
       "VEC_LITERAL",
       "DICT_LITERAL",
       "BOOL_LITERAL",
@@ -69,12 +113,56 @@ NodeType int_to_node_type(int i) {
       NodeType::VAR_LOOKUP,
       NodeType::EXPR_LIST,
       NodeType::BUILTIN_PRINT,
+      NodeType::BUILTIN_WRITE,
+      NodeType::BUILTIN_FLUSH,
+      NodeType::BUILTIN_READ_FILE,
+      NodeType::BUILTIN_LINES,
+      NodeType::BUILTIN_READ_LINE,
+      NodeType::BUILTIN_READ_ALL,
+      NodeType::BUILTIN_READ_CHUNK,
+      NodeType::BUILTIN_JSON_PARSE,
+      NodeType::BUILTIN_JSON_DUMP,
+      NodeType::BUILTIN_READ_INTO,
+      NodeType::BUILTIN_BYTES,
+      NodeType::BUILTIN_READ_BYTES,
+      NodeType::BUILTIN_WRITE_BYTES,
       NodeType::BUILTIN_VECTOR_LENGTH,
       NodeType::BUILTIN_VECTOR_APPEND,
+      NodeType::BUILTIN_VECTOR_RESERVE,
+      NodeType::BUILTIN_VECTOR_EXTEND,
+      NodeType::BUILTIN_VECTOR_POP,
+      NodeType::BUILTIN_VECTOR_INSERT,
+      NodeType::BUILTIN_VECTOR_REMOVE,
+      NodeType::BUILTIN_VECTOR_CLEAR,
+      NodeType::BUILTIN_VECTOR_SHRINK_TO_FIT,
+      NodeType::BUILTIN_VECTOR_SUM,
+      NodeType::BUILTIN_VECTOR_MIN,
+      NodeType::BUILTIN_VECTOR_MAX,
+      NodeType::BUILTIN_VECTOR_DOT,
+      NodeType::BUILTIN_VECTOR_COUNT,
+      NodeType::BUILTIN_VECTOR_FILL,
+      NodeType::BUILTIN_VECTOR_SORT,
+      NodeType::BUILTIN_VECTOR_SORT_BY,
       NodeType::BUILTIN_STRING_LENGTH,
+      NodeType::BUILTIN_STRING_SUBSTR,
+      NodeType::BUILTIN_STRING_FIND,
+      NodeType::BUILTIN_STRING_CONTAINS,
+      NodeType::BUILTIN_STRING_STARTS_WITH,
+      NodeType::BUILTIN_STRING_ENDS_WITH,
+      NodeType::BUILTIN_STRING_SPLIT,
+      NodeType::BUILTIN_STRING_JOIN,
+      NodeType::BUILTIN_STRING_REPLACE,
+      NodeType::BUILTIN_STRING_TRIM,
+      NodeType::BUILTIN_STRING_NEXT_LINE,
+      NodeType::BUILTIN_BYTES_LENGTH,
+      NodeType::BUILTIN_BYTES_SLICE,
+      NodeType::BUILTIN_BYTES_COPY_FROM,
+      NodeType::BUILTIN_BYTES_TO_STRING,
       NodeType::BUILTIN_DICT_LENGTH,
       NodeType::BUILTIN_DICT_KEYS,
       NodeType::BUILTIN_DICT_CONTAINS,
+      NodeType::BUILTIN_DICT_REMOVE,
+      NodeType::BUILTIN_DICT_CLEAR,
       NodeType::VEC_LITERAL,
       NodeType::DICT_LITERAL,
       NodeType::BOOL_LITERAL,
@@ -1,19 +1,33 @@
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
 #include <cstddef>
 #include <cstdio>
+#include <cstring>
+#include <fcntl.h>
 #include <iostream>
 #include <memory>
+#include <nlohmann/json.hpp>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <stdio.h>
 #include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "interpreter.h"
+#include "numfmt.h"
 #include "runtime.h"
 #include "tokentype.h"
 #include "util.h"
 
 using std::shared_ptr;
 using std::string;
+using ordered_json = nlohmann::ordered_json;
 
 /*
 Binary Operator valid type defitions
@@ -54,8 +68,7 @@ static GreaterEqual greaterEqual;
 
 bool equality_comparison(BoxedValue lhs, BoxedValue rhs);
 
-string toString(BoxedValue bv) {
-  std::stringstream result;
+static void writeValue(std::ostream &result, const BoxedValue &bv) {
   switch (bv.type) {
   case DataType::NOTHING:
     result << STRING_NOTHING;
@@ -64,17 +77,24 @@ string toString(BoxedValue bv) {
     result << (std::get<bool>(bv.value) ? "true" : "false");
     break;
   case DataType::FLOAT: {
-    char buffer[64];
-    snprintf(buffer, sizeof(buffer), "%.1f", std::get<double>(bv.value));
-    result << buffer;
+    char buffer[FORMAT_FLOAT_MAX];
+    result.write(buffer, format_float(buffer, std::get<double>(bv.value)));
     break;
   }
-  case DataType::INT:
-    result << std::get<int>(bv.value);
+  case DataType::INT: {
+    char buffer[FORMAT_INT_MAX];
+    result.write(buffer, format_int(buffer, std::get<int>(bv.value)));
     break;
+  }
   case DataType::STRING:
     result << std::get<string>(bv.value);
     break;
+  case DataType::BYTES: {
+    // as they are, so a program can write binary output
+    const auto &bytes = *std::get<shared_ptr<Bytes>>(bv.value);
+    result.write(reinterpret_cast<const char *>(bytes.data()), bytes.length);
+    break;
+  }
   case DataType::VECTOR: {
     auto vec = std::get<shared_ptr<HeVec>>(bv.value);
     result << "[";
@@ -82,9 +102,12 @@ string toString(BoxedValue bv) {
     size_t length = vec->size();
     while (i < length) {
       auto elem = vec->at(i);
-      auto quotes = elem->type == DataType::STRING ? "\"" : "";
+      auto quotes = elem.type == DataType::STRING ||
+                            elem.type == DataType::BYTES
+                        ? "\""
+                        : "";
       result << quotes;
-      result << toString(BoxedValue{elem->type, elem->value});
+      writeValue(result, elem);
       result << quotes;
       if (i != length - 1) {
         result << ", ";
@@ -103,11 +126,16 @@ string toString(BoxedValue bv) {
       auto key = kv_pair.first;
       auto value = kv_pair.second;
       auto key_quotes = key.type == DataType::STRING ? "\"" : "";
-      auto value_quotes = value->type == DataType::STRING ? "\"" : "";
+      auto value_quotes = value->type == DataType::STRING ||
+                                  value->type == DataType::BYTES
+                              ? "\""
+                              : "";
 
-      result << key_quotes << toString(key) << key_quotes << ": "
-             << value_quotes << toString(BoxedValue{value->type, value->value})
-             << value_quotes;
+      result << key_quotes;
+      writeValue(result, key);
+      result << key_quotes << ": " << value_quotes;
+      writeValue(result, *value);
+      result << value_quotes;
       if (i != length - 1) {
         result << ", ";
       }
@@ -137,7 +165,26 @@ string toString(BoxedValue bv) {
     break;
   }
   }
-  return result.str();
+}
+
+string toString(BoxedValue bv) {
+  switch (bv.type) {
+  case DataType::FLOAT: {
+    char buffer[FORMAT_FLOAT_MAX];
+    return string(buffer, format_float(buffer, std::get<double>(bv.value)));
+  }
+  case DataType::INT: {
+    char buffer[FORMAT_INT_MAX];
+    return string(buffer, format_int(buffer, std::get<int>(bv.value)));
+  }
+  case DataType::STRING:
+    return std::get<string>(bv.value);
+  default: {
+    std::stringstream result;
+    writeValue(result, bv);
+    return result.str();
+  }
+  }
 }
 
 BoxedValue apply_times(BoxedValue lhs, BoxedValue rhs) {
@@ -154,10 +201,8 @@ BoxedValue apply_minus(BoxedValue lhs, BoxedValue rhs) {
 
 BoxedValue apply_plus(BoxedValue lhs, BoxedValue rhs) {
   if (lhs.type == DataType::STRING) {
-    std::stringstream new_value;
-    new_value << std::get<string>(lhs.value);
-    new_value << toString(rhs);
-    return BoxedValue{DataType::STRING, new_value.str()};
+    return BoxedValue{DataType::STRING,
+                      std::get<string>(lhs.value) + toString(rhs)};
   }
   return add.apply(lhs, rhs);
 }
@@ -186,11 +231,7 @@ bool vector_equality_comparison(shared_ptr<HeVec> lhs, shared_ptr<HeVec> rhs) {
   // otherwise, do an equality comparison for every element, recursively
   // checking any sub-vectors in the same way
   for (size_t i = 0; i < lhs->size(); ++i) {
-    auto lhs_elem = lhs->at(i);
-    auto rhs_elem = rhs->at(i);
-
-    if (!equality_comparison(BoxedValue{lhs_elem->type, lhs_elem->value},
-                             BoxedValue{rhs_elem->type, rhs_elem->value})) {
+    if (!equality_comparison(lhs->at(i), rhs->at(i))) {
       return false;
     }
   }
@@ -265,6 +306,12 @@ bool equality_comparison(BoxedValue lhs, BoxedValue rhs) {
   case DataType::DICT:
     return dict_equality_comparison(std::get<shared_ptr<Dict>>(lhs.value),
                                     std::get<shared_ptr<Dict>>(rhs.value));
+  case DataType::BYTES: {
+    const auto &lhs_bytes = *std::get<shared_ptr<Bytes>>(lhs.value);
+    const auto &rhs_bytes = *std::get<shared_ptr<Bytes>>(rhs.value);
+    return std::equal(lhs_bytes.data(), lhs_bytes.data() + lhs_bytes.length,
+                      rhs_bytes.data(), rhs_bytes.data() + rhs_bytes.length);
+  }
   default:
     return false;
   }
@@ -469,7 +516,255 @@ BoxedValue ArithmeticBinOp::apply(BoxedValue lhs, BoxedValue rhs) {
       "Arithmetic Operators are only supported between numeric types");
 }
 
-void builtin_print(BoxedValue arg) { std::cout << toString(arg) << "\n"; }
+/*
+ * print and write go through std::cout with its own large buffer,
+ * unsynchronized with C stdio, and write vector and dict contents straight
+ * into it. The buffer is flushed when it fills up, at exit, by flush(), and
+ * after every print or write when stdout is a terminal. Standard input is read
+ * through std::cin, with a large buffer too; at the end of input the read
+ * functions return nothing.
+ */
+
+static char output_buffer[64 * 1024];
+static char input_buffer[256 * 1024];
+static bool output_interactive = false;
+
+void init_output() {
+  std::ios::sync_with_stdio(false);
+  std::cout.rdbuf()->pubsetbuf(output_buffer, sizeof(output_buffer));
+  std::cin.rdbuf()->pubsetbuf(input_buffer, sizeof(input_buffer));
+  output_interactive = isatty(STDOUT_FILENO);
+}
+
+static void end_output() {
+  if (output_interactive) {
+    std::cout.flush();
+  }
+}
+
+void builtin_print(BoxedValue arg) {
+  writeValue(std::cout, arg);
+  std::cout << '\n';
+  end_output();
+}
+
+void builtin_write(BoxedValue arg) {
+  writeValue(std::cout, arg);
+  end_output();
+}
+
+void builtin_flush() { std::cout.flush(); }
+
+BoxedValue builtin_read_line() {
+  string line;
+  if (!std::getline(std::cin, line)) {
+    return BoxedValue{DataType::NOTHING, {}};
+  }
+  return BoxedValue{DataType::STRING, line};
+}
+
+BoxedValue builtin_read_all() {
+  std::ostringstream contents;
+  contents << std::cin.rdbuf();
+  if (contents.tellp() <= 0) {
+    return BoxedValue{DataType::NOTHING, {}};
+  }
+  return BoxedValue{DataType::STRING, contents.str()};
+}
+
+BoxedValue builtin_read_chunk(BoxedValue count) {
+  runtime_assertion(count.type == DataType::INT &&
+                        std::get<int>(count.value) > 0,
+                    "read_chunk() needs a positive int.");
+  // count bytes, or fewer only at the end of input
+  string chunk(std::get<int>(count.value), '\0');
+  std::cin.read(chunk.data(), chunk.size());
+  chunk.resize(std::cin.gcount());
+  if (chunk.empty()) {
+    return BoxedValue{DataType::NOTHING, {}};
+  }
+  return BoxedValue{DataType::STRING, chunk};
+}
+
+BoxedValue builtin_read_into(BoxedValue buffer) {
+  runtime_assertion(buffer.type == DataType::BYTES,
+                    "read_into() needs bytes to read into.");
+  auto &bytes = *std::get<shared_ptr<Bytes>>(buffer.value);
+  // the buffer's length, or fewer only at the end of input, where it's 0
+  std::cin.read(reinterpret_cast<char *>(bytes.data()), bytes.length);
+  return BoxedValue{DataType::INT, (int)std::cin.gcount()};
+}
+
+/*
+ * json_parse and json_dump. Parsing goes through the nlohmann parser, into
+ * an ordered_json so objects keep their key order, which is then converted.
+ * Dumping writes the text directly, the same way the compiled runtime does
+ * (see runtime/src/json.c), so that both give the same text. Ints here are
+ * 32 bits, so larger JSON integers become floats.
+ */
+
+static const size_t JSON_MAX_DEPTH = 1000;
+
+static BoxedValue fromJson(const ordered_json &json, size_t depth) {
+  switch (json.type()) {
+  case ordered_json::value_t::null:
+    return BoxedValue{DataType::NOTHING, {}};
+  case ordered_json::value_t::boolean:
+    return BoxedValue{DataType::BOOL, json.get<bool>()};
+  case ordered_json::value_t::number_integer:
+  case ordered_json::value_t::number_unsigned: {
+    if (json.is_number_integer() && json.get<int64_t>() >= INT_MIN &&
+        json.get<int64_t>() <= INT_MAX) {
+      return BoxedValue{DataType::INT, (int)json.get<int64_t>()};
+    }
+    return BoxedValue{DataType::FLOAT, json.get<double>()};
+  }
+  case ordered_json::value_t::number_float:
+    return BoxedValue{DataType::FLOAT, json.get<double>()};
+  case ordered_json::value_t::string:
+    return BoxedValue{DataType::STRING, json.get<string>()};
+  default:
+    break;
+  }
+
+  runtime_assertion(depth < JSON_MAX_DEPTH, "json_parse(): nesting too deep.");
+  if (json.is_array()) {
+    auto vec = std::make_shared<HeVec>();
+    vec->reserve(json.size());
+    for (const auto &elem : json) {
+      vec->push_back(fromJson(elem, depth + 1));
+    }
+    return BoxedValue{DataType::VECTOR, vec};
+  }
+  auto dict = std::make_shared<Dict>();
+  for (const auto &[key, value] : json.items()) {
+    BoxedValue key_value{DataType::STRING, key};
+    (*dict)[getDictKey(key_value)] = std::make_pair(
+        key_value, std::make_shared<BoxedValue>(fromJson(value, depth + 1)));
+  }
+  return BoxedValue{DataType::DICT, dict};
+}
+
+BoxedValue builtin_json_parse(BoxedValue text) {
+  runtime_assertion(text.type == DataType::STRING,
+                    "json_parse() needs a string.");
+  ordered_json json;
+  try {
+    json = ordered_json::parse(std::get<string>(text.value));
+  } catch (ordered_json::parse_error &e) {
+    throw std::runtime_error("json_parse(): invalid JSON at byte " +
+                             std::to_string(e.byte) + ".");
+  } catch (ordered_json::out_of_range &e) {
+    throw std::runtime_error("json_parse(): number out of range.");
+  }
+  return fromJson(json, 0);
+}
+
+static void writeJsonString(std::ostream &out, const string &text) {
+  out << '"';
+  for (char c : text) {
+    switch (c) {
+    case '"':
+      out << "\\\"";
+      break;
+    case '\\':
+      out << "\\\\";
+      break;
+    case '\b':
+      out << "\\b";
+      break;
+    case '\f':
+      out << "\\f";
+      break;
+    case '\n':
+      out << "\\n";
+      break;
+    case '\r':
+      out << "\\r";
+      break;
+    case '\t':
+      out << "\\t";
+      break;
+    default:
+      if ((unsigned char)c < 0x20) {
+        char escape[8];
+        snprintf(escape, sizeof(escape), "\\u%04x", (unsigned)c);
+        out << escape;
+      } else {
+        out << c;
+      }
+    }
+  }
+  out << '"';
+}
+
+static void writeJson(std::ostream &out, const BoxedValue &bv, size_t depth) {
+  switch (bv.type) {
+  case DataType::NOTHING:
+    out << "null";
+    return;
+  case DataType::BOOL:
+    out << (std::get<bool>(bv.value) ? "true" : "false");
+    return;
+  case DataType::INT: {
+    char buffer[FORMAT_INT_MAX];
+    out.write(buffer, format_int(buffer, std::get<int>(bv.value)));
+    return;
+  }
+  case DataType::FLOAT: {
+    double value = std::get<double>(bv.value);
+    runtime_assertion(std::isfinite(value),
+                      "json_dump() can't write nan or inf.");
+    char buffer[FORMAT_FLOAT_MAX];
+    out.write(buffer, format_float(buffer, value));
+    return;
+  }
+  case DataType::STRING:
+    writeJsonString(out, std::get<string>(bv.value));
+    return;
+  case DataType::VECTOR: {
+    runtime_assertion(depth < JSON_MAX_DEPTH, "json_dump(): nesting too deep.");
+    auto vec = std::get<shared_ptr<HeVec>>(bv.value);
+    out << '[';
+    for (size_t i = 0; i < vec->size(); ++i) {
+      if (i > 0) {
+        out << ',';
+      }
+      writeJson(out, vec->at(i), depth + 1);
+    }
+    out << ']';
+    return;
+  }
+  case DataType::DICT: {
+    runtime_assertion(depth < JSON_MAX_DEPTH, "json_dump(): nesting too deep.");
+    auto dict = std::get<shared_ptr<Dict>>(bv.value);
+    out << '{';
+    bool first = true;
+    for (const auto &[_raw_key, kv_pair] : *dict) {
+      runtime_assertion(kv_pair.first.type == DataType::STRING,
+                        "json_dump() needs string dict keys.");
+      if (!first) {
+        out << ',';
+      }
+      first = false;
+      writeJsonString(out, std::get<string>(kv_pair.first.value));
+      out << ':';
+      writeJson(out, *kv_pair.second, depth + 1);
+    }
+    out << '}';
+    return;
+  }
+  default:
+    throw std::runtime_error(
+        "json_dump() can't write functions, modules or bytes.");
+  }
+}
+
+BoxedValue builtin_json_dump(BoxedValue value) {
+  std::ostringstream out;
+  writeJson(out, value, 0);
+  return BoxedValue{DataType::STRING, out.str()};
+}
 
 BoxedValue builtin_vector_length(BoxedValue arg) {
   auto vec = std::get<shared_ptr<HeVec>>(arg.value);
@@ -478,7 +773,301 @@ BoxedValue builtin_vector_length(BoxedValue arg) {
 
 void builtin_vector_append(BoxedValue vec, BoxedValue elem) {
   auto raw_vec = std::get<shared_ptr<HeVec>>(vec.value);
-  raw_vec->push_back(std::make_shared<BoxedValue>(elem.type, elem.value));
+  raw_vec->push_back(elem);
+}
+
+// Checks that index is an int in [0, limit).
+static size_t vector_index_arg(BoxedValue index, size_t limit) {
+  runtime_assertion(index.type == DataType::INT,
+                    "Vector index value must be int.");
+  auto i = std::get<int>(index.value);
+  runtime_assertion(i >= 0 && (size_t)i < limit, "Vector index out of bounds.");
+  return (size_t)i;
+}
+
+void builtin_vector_reserve(BoxedValue vec, BoxedValue capacity) {
+  auto raw_vec = std::get<shared_ptr<HeVec>>(vec.value);
+  runtime_assertion(capacity.type == DataType::INT &&
+                        std::get<int>(capacity.value) >= 0,
+                    "Vector capacity must be a non-negative int.");
+  raw_vec->reserve(std::get<int>(capacity.value));
+}
+
+void builtin_vector_extend(BoxedValue vec, BoxedValue other) {
+  auto raw_vec = std::get<shared_ptr<HeVec>>(vec.value);
+  runtime_assertion(other.type == DataType::VECTOR,
+                    "Vector can only be extended by another vector.");
+  auto raw_other = std::get<shared_ptr<HeVec>>(other.value);
+  // elements are copied, as append does; other may be this same vector
+  size_t count = raw_other->size();
+  raw_vec->reserve(raw_vec->size() + count);
+  for (size_t i = 0; i < count; ++i) {
+    raw_vec->push_back(raw_other->at(i));
+  }
+}
+
+BoxedValue builtin_vector_pop(BoxedValue vec) {
+  auto raw_vec = std::get<shared_ptr<HeVec>>(vec.value);
+  runtime_assertion(!raw_vec->empty(), "Cannot pop from an empty vector.");
+  auto elem = raw_vec->back();
+  raw_vec->pop_back();
+  return elem;
+}
+
+void builtin_vector_insert(BoxedValue vec, BoxedValue index, BoxedValue elem) {
+  auto raw_vec = std::get<shared_ptr<HeVec>>(vec.value);
+  auto i = vector_index_arg(index, raw_vec->size() + 1);
+  raw_vec->insert(i, elem);
+}
+
+BoxedValue builtin_vector_remove(BoxedValue vec, BoxedValue index) {
+  auto raw_vec = std::get<shared_ptr<HeVec>>(vec.value);
+  auto i = vector_index_arg(index, raw_vec->size());
+  auto elem = raw_vec->at(i);
+  raw_vec->erase(i);
+  return elem;
+}
+
+void builtin_vector_clear(BoxedValue vec) {
+  std::get<shared_ptr<HeVec>>(vec.value)->clear();
+}
+
+void builtin_vector_shrink_to_fit(BoxedValue vec) {
+  std::get<shared_ptr<HeVec>>(vec.value)->shrink_to_fit();
+}
+
+/*
+ * The elements of a vector as numbers, for the numeric methods: ints if they
+ * are all ints, floats if at least one of them is a float (the ints are then
+ * converted). Packed storage is used as it is, boxed elements are copied.
+ */
+class Numbers {
+public:
+  Numbers(const HeVec &vec, const string &error)
+      : ints(vec.ints()), floats(vec.floats()) {
+    if (ints || floats) {
+      return;
+    }
+    bool all_ints = true;
+    for (size_t i = 0; i < vec.size(); ++i) {
+      auto type = vec.at(i).type;
+      runtime_assertion(type == DataType::INT || type == DataType::FLOAT,
+                        error);
+      all_ints = all_ints && type == DataType::INT;
+    }
+    for (size_t i = 0; i < vec.size(); ++i) {
+      auto elem = vec.at(i);
+      if (all_ints) {
+        own_ints.push_back(std::get<int>(elem.value));
+      } else if (elem.type == DataType::INT) {
+        own_floats.push_back(std::get<int>(elem.value));
+      } else {
+        own_floats.push_back(std::get<double>(elem.value));
+      }
+    }
+    if (all_ints) {
+      ints = &own_ints;
+    } else {
+      floats = &own_floats;
+    }
+  }
+  Numbers(const Numbers &) = delete;
+
+  void to_floats() {
+    if (floats) {
+      return;
+    }
+    own_floats.assign(ints->begin(), ints->end());
+    floats = &own_floats;
+    ints = nullptr;
+  }
+
+  const vector<int> *ints;
+  const vector<double> *floats;
+
+private:
+  vector<int> own_ints;
+  vector<double> own_floats;
+};
+
+/*
+ * Float reductions combine the elements in the same order as the runtime's
+ * kernels (runtime/src/vecmath.c): element i goes into partial result
+ * i % VEC_LANES and the partial results are combined pairwise at the end, so
+ * both backends give bit-identical results. Int results wrap on overflow.
+ */
+static constexpr size_t VEC_LANES = 4;
+
+static double pick_min(double x, double acc) { return x < acc ? x : acc; }
+static double pick_max(double x, double acc) { return x > acc ? x : acc; }
+
+static double lanes_sum(const vector<double> &elems) {
+  double lanes[VEC_LANES] = {0.0, 0.0, 0.0, 0.0};
+  for (size_t i = 0; i < elems.size(); ++i) {
+    lanes[i % VEC_LANES] += elems[i];
+  }
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+static double lanes_dot(const vector<double> &lhs, const vector<double> &rhs) {
+  double lanes[VEC_LANES] = {0.0, 0.0, 0.0, 0.0};
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    double product = lhs[i] * rhs[i];
+    lanes[i % VEC_LANES] += product;
+  }
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+template <typename Pick>
+static double lanes_extreme(const vector<double> &elems, Pick pick) {
+  double lanes[VEC_LANES] = {elems[0], elems[0], elems[0], elems[0]};
+  for (size_t i = 0; i < elems.size(); ++i) {
+    lanes[i % VEC_LANES] = pick(elems[i], lanes[i % VEC_LANES]);
+  }
+  return pick(pick(lanes[3], lanes[2]), pick(lanes[1], lanes[0]));
+}
+
+BoxedValue builtin_vector_sum(BoxedValue vec) {
+  auto raw_vec = std::get<shared_ptr<HeVec>>(vec.value);
+  // whatever an empty vector was packed for, its sum is the int 0
+  if (raw_vec->empty()) {
+    return BoxedValue{DataType::INT, 0};
+  }
+  Numbers nums(*raw_vec, "sum() needs a vector of numbers.");
+  if (nums.floats) {
+    return BoxedValue{DataType::FLOAT, lanes_sum(*nums.floats)};
+  }
+  unsigned sum = 0;
+  for (int elem : *nums.ints) {
+    sum += elem;
+  }
+  return BoxedValue{DataType::INT, (int)sum};
+}
+
+BoxedValue builtin_vector_min(BoxedValue vec) {
+  auto raw_vec = std::get<shared_ptr<HeVec>>(vec.value);
+  runtime_assertion(!raw_vec->empty(), "min() of an empty vector.");
+  Numbers nums(*raw_vec, "min() needs a vector of numbers.");
+  if (nums.floats) {
+    return BoxedValue{DataType::FLOAT, lanes_extreme(*nums.floats, pick_min)};
+  }
+  return BoxedValue{DataType::INT,
+                    *std::min_element(nums.ints->begin(), nums.ints->end())};
+}
+
+BoxedValue builtin_vector_max(BoxedValue vec) {
+  auto raw_vec = std::get<shared_ptr<HeVec>>(vec.value);
+  runtime_assertion(!raw_vec->empty(), "max() of an empty vector.");
+  Numbers nums(*raw_vec, "max() needs a vector of numbers.");
+  if (nums.floats) {
+    return BoxedValue{DataType::FLOAT, lanes_extreme(*nums.floats, pick_max)};
+  }
+  return BoxedValue{DataType::INT,
+                    *std::max_element(nums.ints->begin(), nums.ints->end())};
+}
+
+BoxedValue builtin_vector_dot(BoxedValue vec, BoxedValue other) {
+  runtime_assertion(other.type == DataType::VECTOR,
+                    "dot() needs another vector.");
+  auto lhs = std::get<shared_ptr<HeVec>>(vec.value);
+  auto rhs = std::get<shared_ptr<HeVec>>(other.value);
+  runtime_assertion(lhs->size() == rhs->size(),
+                    "dot() needs vectors of the same length.");
+  if (lhs->empty()) {
+    return BoxedValue{DataType::INT, 0};
+  }
+  Numbers lhs_nums(*lhs, "dot() needs vectors of numbers.");
+  Numbers rhs_nums(*rhs, "dot() needs vectors of numbers.");
+  if (lhs_nums.ints && rhs_nums.ints) {
+    unsigned dot = 0;
+    for (size_t i = 0; i < lhs->size(); ++i) {
+      dot += (unsigned)(*lhs_nums.ints)[i] * (unsigned)(*rhs_nums.ints)[i];
+    }
+    return BoxedValue{DataType::INT, (int)dot};
+  }
+  lhs_nums.to_floats();
+  rhs_nums.to_floats();
+  return BoxedValue{DataType::FLOAT,
+                    lanes_dot(*lhs_nums.floats, *rhs_nums.floats)};
+}
+
+BoxedValue builtin_vector_count(BoxedValue vec, BoxedValue value) {
+  auto raw_vec = std::get<shared_ptr<HeVec>>(vec.value);
+  // values of another type never compare equal, see equality_comparison
+  if (auto ints = raw_vec->ints()) {
+    return BoxedValue{DataType::INT,
+                      value.type == DataType::INT
+                          ? (int)std::count(ints->begin(), ints->end(),
+                                            std::get<int>(value.value))
+                          : 0};
+  }
+  if (auto floats = raw_vec->floats()) {
+    return BoxedValue{DataType::INT,
+                      value.type == DataType::FLOAT
+                          ? (int)std::count(floats->begin(), floats->end(),
+                                            std::get<double>(value.value))
+                          : 0};
+  }
+  int count = 0;
+  for (size_t i = 0; i < raw_vec->size(); ++i) {
+    count += equality_comparison(raw_vec->at(i), value);
+  }
+  return BoxedValue{DataType::INT, count};
+}
+
+void builtin_vector_fill(BoxedValue vec, BoxedValue value, BoxedValue count) {
+  runtime_assertion(count.type == DataType::INT &&
+                        std::get<int>(count.value) >= 0,
+                    "Fill count must be a non-negative int.");
+  std::get<shared_ptr<HeVec>>(vec.value)->assign(std::get<int>(count.value),
+                                                 value);
+}
+
+/*
+ * The ordering of sort(), the same as the runtime's (runtime/src/sort.c):
+ * numbers by value with NaNs last, and strings bytewise. Both backends sort
+ * stably, so they agree even on elements that compare equal, like -0.0 and
+ * 0.0.
+ */
+struct NaturalLess {
+  bool operator()(int lhs, int rhs) const { return lhs < rhs; }
+  bool operator()(double lhs, double rhs) const {
+    // NaNs compare greater than every number and equal to each other
+    if (std::isnan(lhs)) {
+      return false;
+    }
+    return std::isnan(rhs) || lhs < rhs;
+  }
+  bool operator()(const BoxedValue &lhs, const BoxedValue &rhs) const {
+    if (lhs.type == DataType::STRING) {
+      return std::get<string>(lhs.value) < std::get<string>(rhs.value);
+    }
+    if (lhs.type == DataType::INT && rhs.type == DataType::INT) {
+      return (*this)(std::get<int>(lhs.value), std::get<int>(rhs.value));
+    }
+    return (*this)(as_double(lhs), as_double(rhs));
+  }
+
+private:
+  static double as_double(const BoxedValue &number) {
+    return number.type == DataType::INT ? std::get<int>(number.value)
+                                        : std::get<double>(number.value);
+  }
+};
+
+void builtin_vector_sort(BoxedValue vec) {
+  auto raw_vec = std::get<shared_ptr<HeVec>>(vec.value);
+  if (!raw_vec->ints() && !raw_vec->floats()) {
+    bool numbers = true, strings = true;
+    for (size_t i = 0; i < raw_vec->size(); ++i) {
+      auto type = raw_vec->at(i).type;
+      numbers = numbers && (type == DataType::INT || type == DataType::FLOAT);
+      strings = strings && type == DataType::STRING;
+    }
+    runtime_assertion(numbers || strings,
+                      "sort() needs a vector of numbers or of strings.");
+  }
+  raw_vec->sort(NaturalLess{});
 }
 
 BoxedValue builtin_string_length(BoxedValue arg) {
@@ -486,6 +1075,300 @@ BoxedValue builtin_string_length(BoxedValue arg) {
   return BoxedValue{DataType::INT, (int)str.size()};
 }
 
+// The string argument of a string method, with the same errors as the C
+// runtime.
+static const string &string_arg(const BoxedValue &arg, const string &error) {
+  runtime_assertion(arg.type == DataType::STRING, error);
+  return std::get<string>(arg.value);
+}
+
+BoxedValue builtin_string_substr(BoxedValue arg, BoxedValue start,
+                                 BoxedValue count) {
+  auto str = std::get<string>(arg.value);
+  runtime_assertion(start.type == DataType::INT && count.type == DataType::INT,
+                    "substr() needs an int start and count.");
+  auto from = std::get<int>(start.value);
+  auto length = std::get<int>(count.value);
+  runtime_assertion(from >= 0 && (size_t)from <= str.size(),
+                    "substr() start out of bounds.");
+  runtime_assertion(length >= 0, "substr() count must not be negative.");
+  return BoxedValue{DataType::STRING, str.substr(from, length)};
+}
+
+BoxedValue builtin_string_find(BoxedValue arg, BoxedValue needle) {
+  auto str = std::get<string>(arg.value);
+  auto at = str.find(string_arg(needle, "find() needs a string."));
+  return BoxedValue{DataType::INT, at == string::npos ? -1 : (int)at};
+}
+
+BoxedValue builtin_string_contains(BoxedValue arg, BoxedValue needle) {
+  auto str = std::get<string>(arg.value);
+  auto at = str.find(string_arg(needle, "contains() needs a string."));
+  return BoxedValue{DataType::BOOL, at != string::npos};
+}
+
+BoxedValue builtin_string_starts_with(BoxedValue arg, BoxedValue prefix) {
+  auto str = std::get<string>(arg.value);
+  return BoxedValue{DataType::BOOL,
+                    str.starts_with(string_arg(
+                        prefix, "starts_with() needs a string."))};
+}
+
+BoxedValue builtin_string_ends_with(BoxedValue arg, BoxedValue suffix) {
+  auto str = std::get<string>(arg.value);
+  return BoxedValue{
+      DataType::BOOL,
+      str.ends_with(string_arg(suffix, "ends_with() needs a string."))};
+}
+
+BoxedValue builtin_string_split(BoxedValue arg, BoxedValue separator) {
+  std::string_view str = std::get<string>(arg.value);
+  const auto &sep = string_arg(separator, "split() needs a string.");
+  runtime_assertion(!sep.empty(), "split() needs a non-empty separator.");
+
+  auto parts = std::make_shared<HeVec>();
+  size_t from = 0, at;
+  while ((at = str.find(sep, from)) != string::npos) {
+    parts->push_back(
+        BoxedValue{DataType::STRING, string{str.substr(from, at - from)}});
+    from = at + sep.size();
+  }
+  parts->push_back(BoxedValue{DataType::STRING, string{str.substr(from)}});
+  return BoxedValue{DataType::VECTOR, parts};
+}
+
+BoxedValue builtin_string_join(BoxedValue arg, BoxedValue parts) {
+  auto sep = std::get<string>(arg.value);
+  runtime_assertion(parts.type == DataType::VECTOR,
+                    "join() needs a vector of strings.");
+  auto vec = std::get<shared_ptr<HeVec>>(parts.value);
+
+  string joined;
+  for (size_t i = 0; i < vec->size(); ++i) {
+    auto part = vec->at(i);
+    if (i != 0) {
+      joined += sep;
+    }
+    joined += string_arg(part, "join() needs a vector of strings.");
+  }
+  return BoxedValue{DataType::STRING, joined};
+}
+
+BoxedValue builtin_string_replace(BoxedValue arg, BoxedValue from,
+                                  BoxedValue to) {
+  std::string_view str = std::get<string>(arg.value);
+  const auto &target = string_arg(from, "replace() needs two strings.");
+  const auto &replacement = string_arg(to, "replace() needs two strings.");
+  runtime_assertion(!target.empty(),
+                    "replace() needs a non-empty string to replace.");
+
+  string replaced;
+  size_t start = 0, at;
+  while ((at = str.find(target, start)) != string::npos) {
+    replaced.append(str.substr(start, at - start));
+    replaced += replacement;
+    start = at + target.size();
+  }
+  replaced.append(str.substr(start));
+  return BoxedValue{DataType::STRING, replaced};
+}
+
+BoxedValue builtin_string_trim(BoxedValue arg) {
+  auto str = std::get<string>(arg.value);
+  // isspace in the "C" locale, like the C runtime
+  const char *space = " \t\n\v\f\r";
+  auto start = str.find_first_not_of(space);
+  if (start == string::npos) {
+    return BoxedValue{DataType::STRING, string{}};
+  }
+  auto end = str.find_last_not_of(space);
+  return BoxedValue{DataType::STRING, str.substr(start, end - start + 1)};
+}
+
+BoxedValue builtin_string_next_line(BoxedValue arg, BoxedValue start) {
+  std::string_view str = std::get<string>(arg.value);
+  runtime_assertion(start.type == DataType::INT,
+                    "next_line() needs an int start.");
+  auto from = std::get<int>(start.value);
+  runtime_assertion(from >= 0 && (size_t)from <= str.size(),
+                    "next_line() start out of bounds.");
+  auto at = str.find('\n', from);
+  auto length = at == string::npos ? string::npos : at - from;
+  return BoxedValue{DataType::STRING, string{str.substr(from, length)}};
+}
+
+/*
+ * Files are read through a memory mapping, which saves the kernel copying
+ * them into a read buffer; the interpreter's strings own their bytes, so the
+ * contents are then copied once into a string. Compiled programs use the
+ * mapping itself, see files.c in the runtime.
+ */
+
+static string read_whole_file(const BoxedValue &path, const string &function) {
+  const auto &name = string_arg(path, function + "() needs a string path.");
+  auto fail = [&]() {
+    runtime_assertion(false, function + "() could not read " + name + ": " +
+                                 strerror(errno));
+  };
+  int fd = open(name.c_str(), O_RDONLY);
+  struct stat info;
+  if (fd < 0 || fstat(fd, &info) != 0) {
+    fail();
+  }
+  string contents;
+  size_t size = (size_t)info.st_size;
+  if (size > 0) {
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+      fail();
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    contents.assign(static_cast<const char *>(mapped), size);
+    munmap(mapped, size);
+  }
+  close(fd);
+  return contents;
+}
+
+BoxedValue builtin_read_file(BoxedValue path) {
+  return BoxedValue{DataType::STRING, read_whole_file(path, "read_file")};
+}
+
+BoxedValue builtin_lines(BoxedValue path) {
+  auto contents = read_whole_file(path, "lines");
+  std::string_view rest = contents;
+  auto lines = std::make_shared<HeVec>();
+  // a newline ends a line, so there's no empty line after the last one
+  while (!rest.empty()) {
+    auto at = rest.find('\n');
+    lines->push_back(BoxedValue{DataType::STRING, string{rest.substr(0, at)}});
+    rest.remove_prefix(at == string::npos ? rest.size() : at + 1);
+  }
+  return BoxedValue{DataType::VECTOR, lines};
+}
+
+/*
+ * Bytes. Indexing reads and writes a byte in place, and a slice shares the
+ * storage of the bytes it was taken from, like the compiled runtime's (see
+ * runtime/src/bytes.c).
+ */
+
+static BoxedValue make_bytes(vector<uint8_t> contents) {
+  auto bytes = std::make_shared<Bytes>();
+  bytes->length = contents.size();
+  bytes->storage = std::make_shared<vector<uint8_t>>(std::move(contents));
+  return BoxedValue{DataType::BYTES, bytes};
+}
+
+// The contents of a bytes or string argument.
+static std::span<const uint8_t> bytes_arg(const BoxedValue &arg,
+                                          const string &error) {
+  if (arg.type == DataType::BYTES) {
+    const auto &bytes = *std::get<shared_ptr<Bytes>>(arg.value);
+    return {bytes.data(), bytes.length};
+  }
+  runtime_assertion(arg.type == DataType::STRING, error);
+  const auto &str = std::get<string>(arg.value);
+  return {reinterpret_cast<const uint8_t *>(str.data()), str.size()};
+}
+
+BoxedValue builtin_bytes(BoxedValue from) {
+  if (from.type == DataType::INT) {
+    auto length = std::get<int>(from.value);
+    runtime_assertion(length >= 0, "bytes() length must not be negative.");
+    return make_bytes(vector<uint8_t>(length));
+  }
+  auto data = bytes_arg(from, "bytes() needs a length, a string or bytes.");
+  return make_bytes(vector<uint8_t>(data.begin(), data.end()));
+}
+
+BoxedValue builtin_read_bytes(BoxedValue path) {
+  auto contents = read_whole_file(path, "read_bytes");
+  return make_bytes(vector<uint8_t>(contents.begin(), contents.end()));
+}
+
+BoxedValue builtin_write_bytes(BoxedValue path, BoxedValue data) {
+  auto contents =
+      bytes_arg(data, "write_bytes() needs bytes or a string to write.");
+  const auto &name = string_arg(path, "write_bytes() needs a string path.");
+  auto fail = [&]() {
+    runtime_assertion(false, "write_bytes() could not write " + name + ": " +
+                                 strerror(errno));
+  };
+  int fd = open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0) {
+    fail();
+  }
+  while (!contents.empty()) {
+    ssize_t written = write(fd, contents.data(), contents.size());
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0) {
+      fail();
+    }
+    contents = contents.subspan(written);
+  }
+  close(fd);
+  return BoxedValue{DataType::NOTHING, {}};
+}
+
+BoxedValue bytes_get(const Bytes &bytes, int index) {
+  runtime_assertion(index >= 0 && (size_t)index < bytes.length,
+                    "Bytes index out of bounds.");
+  return BoxedValue{DataType::INT, (int)bytes.data()[index]};
+}
+
+void bytes_set(Bytes &bytes, int index, BoxedValue value) {
+  runtime_assertion(index >= 0 && (size_t)index < bytes.length,
+                    "Bytes index out of bounds.");
+  runtime_assertion(value.type == DataType::INT &&
+                        std::get<int>(value.value) >= 0 &&
+                        std::get<int>(value.value) <= 255,
+                    "A byte must be an int from 0 to 255.");
+  bytes.data()[index] = (uint8_t)std::get<int>(value.value);
+}
+
+BoxedValue builtin_bytes_length(BoxedValue arg) {
+  auto bytes = std::get<shared_ptr<Bytes>>(arg.value);
+  return BoxedValue{DataType::INT, (int)bytes->length};
+}
+
+BoxedValue builtin_bytes_slice(BoxedValue arg, BoxedValue start,
+                               BoxedValue end) {
+  auto bytes = std::get<shared_ptr<Bytes>>(arg.value);
+  runtime_assertion(start.type == DataType::INT && end.type == DataType::INT,
+                    "slice() needs an int start and end.");
+  auto from = std::get<int>(start.value), to = std::get<int>(end.value);
+  runtime_assertion(from >= 0 && from <= to && (size_t)to <= bytes->length,
+                    "slice() bounds out of range.");
+  auto slice = std::make_shared<Bytes>(*bytes);
+  slice->start += from;
+  slice->length = to - from;
+  return BoxedValue{DataType::BYTES, slice};
+}
+
+void builtin_bytes_copy_from(BoxedValue arg, BoxedValue source,
+                             BoxedValue at) {
+  auto bytes = std::get<shared_ptr<Bytes>>(arg.value);
+  auto data = bytes_arg(source, "copy_from() needs bytes or a string.");
+  runtime_assertion(at.type == DataType::INT,
+                    "copy_from() needs an int position.");
+  auto to = std::get<int>(at.value);
+  runtime_assertion(to >= 0 && (size_t)to <= bytes->length &&
+                        data.size() <= bytes->length - to,
+                    "copy_from() past the end of the bytes.");
+  // the source may be a slice overlapping the destination
+  std::memmove(bytes->data() + to, data.data(), data.size());
+}
+
+BoxedValue builtin_bytes_to_string(BoxedValue arg) {
+  auto bytes = std::get<shared_ptr<Bytes>>(arg.value);
+  return BoxedValue{
+      DataType::STRING,
+      string(reinterpret_cast<const char *>(bytes->data()), bytes->length)};
+}
+
 BoxedValue builtin_dict_length(BoxedValue arg) {
   auto dict = std::get<shared_ptr<Dict>>(arg.value);
   return BoxedValue{DataType::INT, (int)dict->size()};
@@ -495,8 +1378,7 @@ BoxedValue builtin_dict_keys(BoxedValue arg) {
   auto dict = std::get<shared_ptr<Dict>>(arg.value);
   auto keys = std::make_shared<HeVec>();
   for (const auto &[_, kv_pair] : *dict) {
-    keys->push_back(
-        std::make_shared<BoxedValue>(kv_pair.first.type, kv_pair.first.value));
+    keys->push_back(kv_pair.first);
   }
 
   return BoxedValue{DataType::VECTOR, keys};
@@ -508,6 +1390,18 @@ BoxedValue builtin_dict_contains(BoxedValue arg, BoxedValue key) {
   return BoxedValue{DataType::BOOL, contains};
 }
 
+BoxedValue builtin_dict_remove(BoxedValue arg, BoxedValue key) {
+  auto dict = std::get<shared_ptr<Dict>>(arg.value);
+  auto removed = dict->erase(getDictKey(key));
+  return BoxedValue{DataType::BOOL, removed};
+}
+
+BoxedValue builtin_dict_clear(BoxedValue arg) {
+  auto dict = std::get<shared_ptr<Dict>>(arg.value);
+  dict->clear();
+  return BoxedValue{};
+}
+
 void runtime_assertion(bool condition, string message) {
   if (!condition) {
     throw std::runtime_error(message);